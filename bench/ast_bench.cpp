@@ -0,0 +1,82 @@
+// Builds the AST of one large generated program and reports its memory use
+// per node, per kind, and how long building and releasing it take.
+//
+// Usage: ast_bench [statements]
+
+#include "lexer.h"
+#include "parser.h"
+#include "compilation_context.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace {
+
+// Same statement mix as parser_throughput_bench
+void writeProgram(const std::string& filename, size_t statements) {
+    std::ofstream file(filename);
+    file << "int main() {\n    int x = 0;\n    float y = 1.5;\n";
+    for (size_t i = 0; i < statements; i++) {
+        switch (i % 4) {
+            case 0: file << "    x = (x + " << i << ") * y - x / 2;\n"; break;
+            case 1: file << "    int v" << i << " = " << i << " * 3;\n"; break;
+            case 2: file << "    while (x < " << i << ") { x++; }\n"; break;
+            default: file << "    y = y + 0.5;\n"; break;
+        }
+    }
+    file << "    return x;\n}\n";
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+void printPool(const char* name, const Ast& ast) {
+    std::printf("  %-22s %10u nodes x %2zu bytes\n", name, ast.nodes<T>().size(), sizeof(T));
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::string filename = "ast_bench.c";
+    writeProgram(filename, statements);
+    
+    CompilationContext context(filename);
+    Lexer lexer(filename, context);
+    TokenStream tokens = lexer.tokenize();
+    std::remove(filename.c_str());
+    
+    Parser parser(tokens, context);
+    auto start = std::chrono::steady_clock::now();
+    if (!parser.parse()) {
+        std::printf("parse failed\n");
+        return 1;
+    }
+    double parse_seconds = secondsSince(start);
+    
+    const Ast& ast = context.getAst();
+    std::printf("%zu statements, %zu tokens, parsed with tree in %.3f s\n", statements, tokens.size(),
+                parse_seconds);
+    printPool<FunctionNode>("function", ast);
+    printPool<DeclarationNode>("declaration", ast);
+    printPool<AssignmentNode>("assignment", ast);
+    printPool<LoopNode>("loop", ast);
+    printPool<ReturnNode>("return", ast);
+    printPool<ExpressionStatementNode>("expression statement", ast);
+    printPool<BinaryNode>("binary", ast);
+    printPool<IncrementNode>("increment", ast);
+    printPool<IdentifierNode>("identifier", ast);
+    printPool<IntegerLiteralNode>("integer literal", ast);
+    printPool<FloatLiteralNode>("float literal", ast);
+    std::printf("%zu nodes, %zu bytes, %.2f bytes per node\n", ast.getNodeCount(), ast.getBytesUsed(),
+                static_cast<double>(ast.getBytesUsed()) / ast.getNodeCount());
+    
+    start = std::chrono::steady_clock::now();
+    context.getAst().clear();
+    std::printf("released in %.6f s\n", secondsSince(start));
+    return 0;
+}
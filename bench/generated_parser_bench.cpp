@@ -0,0 +1,78 @@
+// Compares the table-driven Parser with the direct-coded GeneratedParser on
+// the same token stream.
+//
+// Usage: generated_parser_bench [parses]
+
+#include "lexer.h"
+#include "parser.h"
+#include "generated_parser.h"
+#include "error.h"
+#include "symbol_table.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace {
+
+// Small enough for Parser::parse()'s iteration limit
+void writeProgram(const std::string& filename) {
+    std::ofstream file(filename);
+    file << "int main() {\n    int x = 0;\n    float y = 1.5;\n";
+    for (int i = 0; i < 12; i++) {
+        file << "    x = (x + " << i << ") * y - x / 2;\n";
+    }
+    file << "    while (x < 100) {\n        x++;\n    }\n    return x;\n}\n";
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Parses tokens the given number of times; returns how many succeeded
+template <typename ParserType>
+size_t parseRepeatedly(const TokenStream& tokens, size_t parses) {
+    size_t accepted = 0;
+    for (size_t i = 0; i < parses; i++) {
+        ErrorReporter reporter;
+        SymbolTable symbols;
+        ParserType parser(tokens, reporter, symbols);
+        accepted += parser.parse() ? 1 : 0;
+    }
+    return accepted;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t parses = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    const std::string filename = "generated_parser_bench.c";
+    writeProgram(filename);
+    
+    ErrorReporter reporter;
+    Lexer lexer(filename, reporter);
+    TokenStream tokens = lexer.tokenize();
+    std::remove(filename.c_str());
+    
+    auto start = std::chrono::steady_clock::now();
+    size_t table_accepted = parseRepeatedly<Parser>(tokens, parses);
+    double table_seconds = secondsSince(start);
+    
+    start = std::chrono::steady_clock::now();
+    size_t generated_accepted = parseRepeatedly<GeneratedParser>(tokens, parses);
+    double generated_seconds = secondsSince(start);
+    
+    if (table_accepted != parses || generated_accepted != parses) {
+        std::fprintf(stderr, "parsers rejected the program: %zu and %zu of %zu accepted\n",
+                     table_accepted, generated_accepted, parses);
+        return 1;
+    }
+    
+    double tokens_parsed = static_cast<double>(tokens.size()) * parses;
+    std::printf("%zu tokens, %zu parses each\n", tokens.size(), parses);
+    std::printf("table-driven: %8.2f ns/token\n", table_seconds * 1e9 / tokens_parsed);
+    std::printf("generated:    %8.2f ns/token\n", generated_seconds * 1e9 / tokens_parsed);
+    std::printf("speedup:      %8.1fx\n", table_seconds / generated_seconds);
+    return 0;
+}
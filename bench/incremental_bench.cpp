@@ -0,0 +1,119 @@
+// Edits one statement at a time across a large generated program and
+// compares reparsing each version incrementally with parsing it from
+// scratch. Lexing is the same either way and is not timed.
+//
+// Usage: incremental_bench [statements] [edits]
+
+#include "lexer.h"
+#include "parser.h"
+#include "incremental_parser.h"
+#include "error.h"
+#include "symbol_table.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Same statement mix as parser_throughput_bench, one line each
+std::vector<std::string> programLines(size_t statements) {
+    std::vector<std::string> lines = {"int main() {\n", "    int x = 0;\n", "    float y = 1.5;\n"};
+    for (size_t i = 0; i < statements; i++) {
+        std::string n = std::to_string(i);
+        switch (i % 4) {
+            case 0: lines.push_back("    x = (x + " + n + ") * y - x / 2;\n"); break;
+            case 1: lines.push_back("    int v" + n + " = " + n + " * 3;\n"); break;
+            case 2: lines.push_back("    while (x < " + n + ") { x++; }\n"); break;
+            default: lines.push_back("    y = y + 0.5;\n"); break;
+        }
+    }
+    lines.push_back("    return x;\n}\n");
+    return lines;
+}
+
+TokenStream lex(const std::vector<std::string>& lines, const std::string& filename) {
+    {
+        std::ofstream file(filename);
+        for (const std::string& line : lines) {
+            file << line;
+        }
+    }
+    ErrorReporter reporter;
+    Lexer lexer(filename, reporter);
+    return lexer.tokenize();
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t edits = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+    const std::string filename = "incremental_bench.c";
+
+    std::vector<std::string> lines = programLines(statements);
+    TokenStream previous = lex(lines, filename);
+    IncrementalParser incremental;
+    {
+        ErrorReporter reporter;
+        SymbolTable symbols;
+        auto start = std::chrono::steady_clock::now();
+        incremental.parse(previous, reporter, symbols);
+        std::printf("%zu statements, %zu tokens; first parse %.3f ms\n", statements, previous.size(),
+                    secondsSince(start) * 1e3);
+    }
+
+    // Alternate between changing an assignment's operand and inserting a
+    // statement, at points spread through the program
+    double full_seconds = 0;
+    double incremental_seconds = 0;
+    size_t full_steps = 0;
+    size_t incremental_steps = 0;
+    size_t failures = 0;
+    for (size_t k = 0; k < edits; k++) {
+        size_t line = 3 + (k + 1) * statements / (edits + 1);
+        if (k % 2 == 0) {
+            lines[line] = "    x = x * " + std::to_string(k) + " + 1;\n";
+        } else {
+            lines.insert(lines.begin() + line, "    y = y - 1.0;\n");
+        }
+        TokenStream tokens = lex(lines, filename);
+        TokenEdit edit = TokenEdit::between(previous, tokens);
+
+        ErrorReporter full_reporter;
+        SymbolTable full_symbols;
+        Parser parser(tokens, full_reporter, full_symbols);
+        auto start = std::chrono::steady_clock::now();
+        failures += !parser.parse();
+        full_seconds += secondsSince(start);
+        full_steps += parser.getStats().steps;
+
+        // The parser takes the stream by value; copy it outside the timing,
+        // as for the full parse
+        ErrorReporter reporter;
+        SymbolTable symbols;
+        TokenStream copy = tokens;
+        start = std::chrono::steady_clock::now();
+        failures += !incremental.reparse(std::move(copy), edit, reporter, symbols);
+        incremental_seconds += secondsSince(start);
+        incremental_steps += incremental.getStats().steps;
+        previous = std::move(tokens);
+    }
+    std::remove(filename.c_str());
+
+    std::printf("%-12s %10.3f ms per edit  %10zu steps per edit\n", "full", full_seconds * 1e3 / edits,
+                full_steps / edits);
+    std::printf("%-12s %10.3f ms per edit  %10zu steps per edit  (%zu statements reused by the last)\n",
+                "incremental", incremental_seconds * 1e3 / edits, incremental_steps / edits,
+                incremental.getReusedStatements());
+    if (failures != 0) {
+        std::printf("%zu parses failed\n", failures);
+    }
+    return 0;
+}
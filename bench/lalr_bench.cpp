@@ -0,0 +1,84 @@
+// Compares the LALR(1) parser with the LL(1) parsers on expression-heavy
+// code: long left-associative chains and nested parentheses, where the LL(1)
+// parsers expand a _TAIL non-terminal per operator. The table-driven parser
+// is also run with Pratt expressions, which climb precedence instead.
+//
+// Usage: lalr_bench [statements] [operators per expression]
+
+#include "lexer.h"
+#include "parser.h"
+#include "generated_parser.h"
+#include "lalr_parser.h"
+#include "error.h"
+#include "symbol_table.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+void writeProgram(const std::string& filename, size_t statements, size_t operators) {
+    static const char* const OPS[] = {" + ", " * ", " - ", " / "};
+    std::ofstream file(filename);
+    file << "int main() {\n    int a = 1;\n    float b = 2.5;\n";
+    for (size_t i = 0; i < statements; i++) {
+        file << "    a = ";
+        for (size_t k = 0; k < operators; k++) {
+            if (k % 8 == 7) {
+                file << "(b - " << k << ")" << OPS[k % 4];
+            } else {
+                file << (k % 2 ? "a" : "b++") << OPS[k % 4];
+            }
+        }
+        file << i << ";\n";
+    }
+    file << "    return a;\n}\n";
+}
+
+template <typename ParserType>
+void measure(const char* name, const TokenStream& tokens, bool pratt = false) {
+    ErrorReporter reporter;
+    SymbolTable symbols;
+    ParserType parser(tokens, reporter, symbols);
+    if constexpr (std::is_same_v<ParserType, Parser>) {
+        parser.setPrattExpressions(pratt);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool accepted = parser.parse();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%-16s %8.3f s  %8.2f Mtokens/s", name, seconds, tokens.size() / seconds / 1e6);
+    if constexpr (std::is_same_v<ParserType, Parser> || std::is_same_v<ParserType, LalrParser>) {
+        const ParseStats& stats = parser.getStats();
+        std::printf("  %10zu steps  depth %zu", stats.steps, stats.max_stack_depth);
+    }
+    std::printf("%s\n", accepted ? "" : "  rejected");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t operators = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+    const std::string filename = "lalr_bench.c";
+    writeProgram(filename, statements, operators);
+
+    ErrorReporter reporter;
+    Lexer lexer(filename, reporter);
+    TokenStream tokens = lexer.tokenize();
+    std::remove(filename.c_str());
+
+    const LalrTables& tables = LalrTables::builtin();
+    std::printf("%zu statements of %zu operators, %zu tokens\n", statements, operators, tokens.size());
+    std::printf("LALR(1) tables: %zu states, %zu bytes compressed (%zu dense)\n", tables.getStateCount(),
+                tables.tableBytes(), tables.denseTableBytes());
+    measure<Parser>("LL(1) table", tokens);
+    measure<Parser>("LL(1) + Pratt", tokens, true);
+    measure<GeneratedParser>("generated LL(1)", tokens);
+    measure<LalrParser>("LALR(1)", tokens);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Parses a generated program of many functions sequentially and with
+// ParallelParser at several thread counts. Lexing is the same either way
+// and is not timed.
+//
+// Usage: parallel_parser_bench [functions] [statements per function] [repeats]
+
+#include "lexer.h"
+#include "parser.h"
+#include "parallel_parser.h"
+#include "error.h"
+#include "symbol_table.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Functions calling their neighbours, with parser_throughput_bench's
+// statement mix in the bodies
+std::string generateProgram(size_t functions, size_t statements) {
+    std::string source;
+    for (size_t f = 0; f < functions; f++) {
+        source += "int f" + std::to_string(f) + "(int x, float y) {\n";
+        for (size_t i = 0; i < statements; i++) {
+            std::string n = std::to_string(i);
+            switch (i % 4) {
+                case 0: source += "    x = (x + " + n + ") * y - x / 2;\n"; break;
+                case 1:
+                    source += "    int v" + n + " = f" + std::to_string((f + 1) % functions) + "(" + n + ", 2.5) * 3;\n";
+                    break;
+                case 2: source += "    while (x < " + n + ") { x++; }\n"; break;
+                default: source += "    y = y + 0.5;\n"; break;
+            }
+        }
+        source += "    return x;\n}\n";
+    }
+    source += "int main() { return f0(1, 2.5); }\n";
+    return source;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t functions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    size_t statements = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+    size_t repeats = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5;
+    const std::string filename = "parallel_parser_bench.c";
+    {
+        std::ofstream file(filename);
+        file << generateProgram(functions, statements);
+    }
+    TokenStream tokens;
+    {
+        ErrorReporter reporter;
+        Lexer lexer(filename, reporter);
+        tokens = lexer.tokenize();
+    }
+    std::remove(filename.c_str());
+    std::printf("%zu functions, %zu tokens\n", functions + 1, tokens.size());
+
+    // Best of repeats. Both parsers take the stream by value; it is copied
+    // outside the timing, and freed inside it as the parallel parser frees
+    // it. The sequential parse also checks the calls, as the parallel one
+    // does.
+    size_t failures = 0;
+    double best = 0;
+    for (size_t r = 0; r < repeats; r++) {
+        ErrorReporter reporter;
+        SymbolTable symbols;
+        TokenStream copy = tokens;
+        auto start = std::chrono::steady_clock::now();
+        bool accepted;
+        {
+            Parser parser(std::move(copy), reporter, symbols);
+            accepted = parser.parse();
+        }
+        symbols.getFunctions().check(reporter);
+        double seconds = secondsSince(start);
+        failures += !accepted || reporter.getErrorCount() != 0;
+        best = r == 0 ? seconds : std::min(best, seconds);
+    }
+    const double sequential = best;
+    std::printf("%-12s %10.3f ms\n", "sequential", sequential * 1e3);
+
+    // Powers of two up to the hardware's thread count, then that count
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < hardware; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(hardware);
+    for (unsigned threads : thread_counts) {
+        ParallelParser parser(threads);
+        for (size_t r = 0; r < repeats; r++) {
+            ErrorReporter reporter;
+            SymbolTable symbols;
+            TokenStream copy = tokens;
+            auto start = std::chrono::steady_clock::now();
+            bool accepted = parser.parse(std::move(copy), reporter, symbols);
+            double seconds = secondsSince(start);
+            failures += !accepted || reporter.getErrorCount() != 0 || !parser.wasSplit();
+            best = r == 0 ? seconds : std::min(best, seconds);
+        }
+        std::printf("%2u %-9s %10.3f ms  %5.2fx\n", threads, threads == 1 ? "thread" : "threads", best * 1e3,
+                    sequential / best);
+    }
+    if (failures != 0) {
+        std::printf("%zu parses failed\n", failures);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Compares parse-table predictions through the string-keyed map with the
+// dense terminal-id table that Parser::parse() uses.
+//
+// Usage: parse_table_bench [statements]
+
+#include "lexer.h"
+#include "parser.h"
+#include "error.h"
+#include "symbol_table.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Expression-heavy statements, so predictions dominate the parse
+void writeProgram(const std::string& filename, size_t statements) {
+    std::ofstream file(filename);
+    file << "int main() {\n    int x = 0;\n    float y = 1.5;\n";
+    for (size_t i = 0; i < statements; i++) {
+        file << "    x = (x + " << i << ") * y - x / 2;\n";
+    }
+    file << "    return x;\n}\n";
+}
+
+// What parse() did before terminals had ids
+std::string mapKey(const Token& token) {
+    if (token.type == TokenType::Identifier ||
+        token.type == TokenType::IntegerLiteral ||
+        token.type == TokenType::FloatLiteral) {
+        return "$" + std::to_string(static_cast<int>(token.type));
+    }
+    return token.lexeme;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::string filename = "parse_table_bench.c";
+    writeProgram(filename, statements);
+    
+    ErrorReporter reporter;
+    SymbolTable symbols;
+    Lexer lexer(filename, reporter);
+    TokenStream tokens = lexer.tokenize();
+    Parser parser(tokens, reporter, symbols);
+    const auto& table = parser.getParseTable();
+    
+    // Every (non-terminal, lookahead) pair in the file, as the parser would see them
+    size_t lookups = tokens.size() * NONTERMINAL_COUNT;
+    long checksum_map = 0;
+    long checksum_dense = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < tokens.size(); i++) {
+        for (size_t nt = 0; nt < NONTERMINAL_COUNT; nt++) {
+            const auto& row = table.at(static_cast<NonTerminal>(nt));
+            auto it = row.find(mapKey(tokens[i]));
+            checksum_map += it != row.end() ? it->second.production_index : -1;
+        }
+    }
+    double map_seconds = secondsSince(start);
+    
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < tokens.size(); i++) {
+        TerminalId lookahead = tokens[i].terminal;
+        for (size_t nt = 0; nt < NONTERMINAL_COUNT; nt++) {
+            checksum_dense += parser.predict(static_cast<NonTerminal>(nt), lookahead);
+        }
+    }
+    double dense_seconds = secondsSince(start);
+    
+    std::remove(filename.c_str());
+    
+    if (checksum_map != checksum_dense) {
+        std::fprintf(stderr, "tables disagree: %ld vs %ld\n", checksum_map, checksum_dense);
+        return 1;
+    }
+    
+    std::printf("%zu tokens, %zu predictions\n", tokens.size(), lookups);
+    std::printf("string map:  %8.2f ns/prediction\n", map_seconds * 1e9 / lookups);
+    std::printf("dense table: %8.2f ns/prediction\n", dense_seconds * 1e9 / lookups);
+    std::printf("speedup:     %8.1fx\n", map_seconds / dense_seconds);
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Parses one large generated program with each parser and reports throughput.
+//
+// Usage: parser_throughput_bench [statements]
+
+#include "lexer.h"
+#include "parser.h"
+#include "generated_parser.h"
+#include "recursive_descent_parser.h"
+#include "error.h"
+#include "symbol_table.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace {
+
+// A mix of every statement kind
+void writeProgram(const std::string& filename, size_t statements) {
+    std::ofstream file(filename);
+    file << "int main() {\n    int x = 0;\n    float y = 1.5;\n";
+    for (size_t i = 0; i < statements; i++) {
+        switch (i % 4) {
+            case 0: file << "    x = (x + " << i << ") * y - x / 2;\n"; break;
+            case 1: file << "    int v" << i << " = " << i << " * 3;\n"; break;
+            case 2: file << "    while (x < " << i << ") { x++; }\n"; break;
+            default: file << "    y = y + 0.5;\n"; break;
+        }
+    }
+    file << "    return x;\n}\n";
+}
+
+template <typename ParserType>
+void measure(const char* name, const TokenStream& tokens) {
+    ErrorReporter reporter;
+    std::string diagnostics;
+    reporter.setOutput(&diagnostics);
+    SymbolTable symbols;
+    ParserType parser(tokens, reporter, symbols);
+    
+    auto start = std::chrono::steady_clock::now();
+    bool accepted = parser.parse();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (!accepted) {
+        reporter.flush();
+        std::printf("%-18s rejected the program: %s\n", name,
+                    diagnostics.substr(0, diagnostics.find('\n')).c_str());
+        return;
+    }
+    std::printf("%-18s %8.3f s  %8.2f Mtokens/s\n", name, seconds, tokens.size() / seconds / 1e6);
+}
+
+// The table parser again, recording every step into a ring
+void measureTraced(const TokenStream& tokens) {
+    ErrorReporter reporter;
+    SymbolTable symbols;
+    Parser parser(tokens, reporter, symbols);
+    RingTrace trace(Parser::VERBOSE_TRACE_LOG2);
+
+    auto start = std::chrono::steady_clock::now();
+    bool accepted = parser.parseTraced(trace);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%-18s %8.3f s  %8.2f Mtokens/s  (%zu steps)%s\n", "LL(1) traced", seconds,
+                tokens.size() / seconds / 1e6, static_cast<size_t>(trace.size() + trace.dropped()),
+                accepted ? "" : "  rejected");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::string filename = "parser_throughput_bench.c";
+    writeProgram(filename, statements);
+    
+    ErrorReporter reporter;
+    Lexer lexer(filename, reporter);
+    TokenStream tokens = lexer.tokenize();
+    std::remove(filename.c_str());
+    
+    std::printf("%zu statements, %zu tokens\n", statements, tokens.size());
+    measure<Parser>("LL(1) table", tokens);
+    measureTraced(tokens);
+    measure<GeneratedParser>("generated LL(1)", tokens);
+    measure<RecursiveDescentParser>("recursive descent", tokens);
+    return 0;
+}
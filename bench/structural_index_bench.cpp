@@ -0,0 +1,121 @@
+// Finds the structural characters of a large generated program with
+// StructuralIndex, with a byte-at-a-time scan that follows the same rules,
+// and by lexing it, and reports each in GB/s.
+//
+// Usage: structural_index_bench [functions] [repeats]
+
+#include "lexer.h"
+#include "structural_index.h"
+#include "error.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Functions with comments and string literals between the statements, so
+// that both the block-at-a-time and the walking paths are taken
+std::string generateProgram(size_t functions) {
+    std::string source;
+    for (size_t f = 0; f < functions; f++) {
+        std::string n = std::to_string(f);
+        source += "/* f" + n + ": loops over x { and } counts } */\n";
+        source += "int f" + n + "(int x, float y) {\n";
+        source += "    int i = 0; // counter ( not ) a call;\n";
+        source += "    while (i < x) {\n";
+        source += "        y = (y + 1.5) * 2 - y / 3;\n";
+        source += "        s = \"text with ; and { \\\" inside\";\n";
+        source += "        i++;\n";
+        source += "    }\n";
+        source += "    return f" + std::to_string(f == 0 ? 0 : f - 1) + "(i, y);\n";
+        source += "}\n\n";
+    }
+    return source;
+}
+
+// The same rules one byte at a time, for comparison
+size_t scanBytes(const std::string& text, std::vector<uint32_t>& offsets) {
+    offsets.clear();
+    size_t size = text.size();
+    for (size_t i = 0; i < size; i++) {
+        char c = text[i];
+        if (c == '"') {
+            for (i++; i < size && text[i] != '"'; i++) {
+                i += text[i] == '\\';
+            }
+        } else if (c == '/' && i + 1 < size && text[i + 1] == '/') {
+            while (i < size && text[i] != '\n') {
+                i++;
+            }
+        } else if (c == '/' && i + 1 < size && text[i + 1] == '*') {
+            for (i += 2; i < size && !(text[i] == '*' && i + 1 < size && text[i + 1] == '/'); i++) {
+            }
+            i++;
+        } else if (c == '{' || c == '}' || c == '(' || c == ')' || c == ';') {
+            offsets.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return offsets.size();
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename F>
+double best(size_t repeats, F&& run) {
+    double fastest = 0;
+    for (size_t r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double seconds = secondsSince(start);
+        fastest = r == 0 ? seconds : std::min(fastest, seconds);
+    }
+    return fastest;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t functions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t repeats = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    std::string source = generateProgram(functions);
+    double gigabytes = source.size() / 1e9;
+
+    StructuralIndex index;
+    double indexed = best(repeats, [&] { index.build(source); });
+    std::vector<uint32_t> offsets;
+    double scanned = best(repeats, [&] { scanBytes(source, offsets); });
+    bool same = offsets.size() == index.size();
+    for (size_t i = 0; same && i < offsets.size(); i++) {
+        same = offsets[i] == index.offset(i);
+    }
+
+    const std::string filename = "structural_index_bench.c";
+    {
+        std::ofstream file(filename);
+        file << source;
+    }
+    size_t tokens = 0;
+    double lexed = best(std::min<size_t>(repeats, 2), [&] {
+        ErrorReporter reporter;
+        std::string diagnostics;
+        reporter.setOutput(&diagnostics);
+        Lexer lexer(filename, reporter);
+        tokens = lexer.tokenize().size();
+    });
+    std::remove(filename.c_str());
+
+    std::printf("%.1f MB, %zu structural characters, %zu tokens\n", source.size() / 1e6, index.size(), tokens);
+    std::printf("%-16s %10.3f ms  %8.3f GB/s\n", "structural index", indexed * 1e3, gigabytes / indexed);
+    std::printf("%-16s %10.3f ms  %8.3f GB/s\n", "byte scan", scanned * 1e3, gigabytes / scanned);
+    std::printf("%-16s %10.3f ms  %8.3f GB/s\n", "lexer", lexed * 1e3, gigabytes / lexed);
+    if (!same) {
+        std::printf("the byte scan found different characters\n");
+    }
+    return 0;
+}
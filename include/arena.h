@@ -0,0 +1,48 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump-pointer allocator. Objects are never freed individually; the whole
+// arena is released at once by reset() or destruction, so only trivially
+// destructible types may be created in it.
+class Arena {
+public:
+    explicit Arena(size_t block_size = 64 * 1024) : block_size(block_size) {}
+    ~Arena();
+    
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "Arena objects are never destroyed individually");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    
+    // Release every block except the first, which is kept for reuse
+    void reset();
+    
+    size_t getBytesAllocated() const { return bytes_allocated; }
+    size_t getBytesReserved() const { return bytes_reserved; }
+
+private:
+    size_t block_size;
+    std::vector<std::pair<char*, size_t>> blocks;  // (storage, size)
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    size_t bytes_allocated = 0;
+    size_t bytes_reserved = 0;
+    
+    void grow(size_t min_size);
+};
+
+#endif // ARENA_H
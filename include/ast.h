@@ -0,0 +1,385 @@
+#ifndef AST_H
+#define AST_H
+
+#include "arena.h"
+#include "parse_events.h"
+#include "symbol_table.h"
+#include "token.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// Abstract syntax tree built by Parser. Nodes of each kind live in their own
+// pool, so a pass over, say, every loop walks one contiguous array, and
+// children are referenced by 32-bit NodeRefs rather than pointers. All
+// storage comes from one arena: releasing the tree is an Arena::reset(),
+// with no per-node work.
+
+enum class NodeKind : uint8_t {
+    Program,
+    Function,
+    Declaration,
+    Assignment,
+    Loop,
+    Return,
+    ExpressionStatement,
+    Binary,
+    Increment,
+    Unary,
+    Conditional,
+    Call,
+    Identifier,
+    IntegerLiteral,
+    FloatLiteral,
+};
+
+// Kind in the top 4 bits, index into that kind's pool in the low 28
+class NodeRef {
+public:
+    static constexpr uint32_t INDEX_BITS = 28;
+    static constexpr uint32_t INDEX_MASK = (uint32_t(1) << INDEX_BITS) - 1;
+
+    constexpr NodeRef() : bits(UINT32_MAX) {}
+    constexpr NodeRef(NodeKind kind, uint32_t index)
+        : bits((static_cast<uint32_t>(kind) << INDEX_BITS) | index) {}
+
+    constexpr bool isValid() const { return bits != UINT32_MAX; }
+    constexpr NodeKind kind() const { return static_cast<NodeKind>(bits >> INDEX_BITS); }
+    constexpr uint32_t index() const { return bits & INDEX_MASK; }
+
+    constexpr bool operator==(NodeRef other) const { return bits == other.bits; }
+    constexpr bool operator!=(NodeRef other) const { return bits != other.bits; }
+
+private:
+    uint32_t bits;
+};
+
+// count consecutive entries of Ast's list pool, starting at first
+struct NodeList {
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+// Names are indices into Ast's name pool; token is the index of the node's
+// main token in the parsed TokenStream
+struct ProgramNode {
+    static constexpr NodeKind KIND = NodeKind::Program;
+    NodeList functions;
+    uint32_t token;  // The first function's type
+};
+
+// Parameters are declarations without initializers
+struct FunctionNode {
+    static constexpr NodeKind KIND = NodeKind::Function;
+    uint32_t name;
+    NodeList parameters;
+    NodeList body;
+    uint32_t token;
+    SymbolType type;
+};
+
+struct DeclarationNode {
+    static constexpr NodeKind KIND = NodeKind::Declaration;
+    uint32_t name;
+    NodeRef init;  // Invalid without an initializer
+    uint32_t token;
+    SymbolType type;
+};
+
+struct AssignmentNode {
+    static constexpr NodeKind KIND = NodeKind::Assignment;
+    uint32_t name;
+    NodeRef value;
+    uint32_t token;
+};
+
+struct LoopNode {
+    static constexpr NodeKind KIND = NodeKind::Loop;
+    NodeRef condition;
+    NodeList body;
+    uint32_t token;
+};
+
+struct ReturnNode {
+    static constexpr NodeKind KIND = NodeKind::Return;
+    NodeRef value;
+    uint32_t token;
+};
+
+struct ExpressionStatementNode {
+    static constexpr NodeKind KIND = NodeKind::ExpressionStatement;
+    NodeRef expression;
+    uint32_t token;
+};
+
+// Arithmetic and relational operators
+struct BinaryNode {
+    static constexpr NodeKind KIND = NodeKind::Binary;
+    NodeRef lhs;
+    NodeRef rhs;
+    uint32_t token;
+    OperatorType op;
+};
+
+// Postfix ++ and --
+struct IncrementNode {
+    static constexpr NodeKind KIND = NodeKind::Increment;
+    NodeRef operand;
+    uint32_t token;
+    OperatorType op;
+};
+
+// Prefix operators: - + ! ~ ++ --
+struct UnaryNode {
+    static constexpr NodeKind KIND = NodeKind::Unary;
+    NodeRef operand;
+    uint32_t token;
+    OperatorType op;
+};
+
+// condition ? then : otherwise, from the '?'
+struct ConditionalNode {
+    static constexpr NodeKind KIND = NodeKind::Conditional;
+    NodeRef condition;
+    NodeRef then;
+    NodeRef otherwise;
+    uint32_t token;
+};
+
+// name(arguments), from the name
+struct CallNode {
+    static constexpr NodeKind KIND = NodeKind::Call;
+    uint32_t name;
+    NodeList arguments;
+    uint32_t token;
+};
+
+struct IdentifierNode {
+    static constexpr NodeKind KIND = NodeKind::Identifier;
+    uint32_t name;
+    uint32_t token;
+};
+
+struct IntegerLiteralNode {
+    static constexpr NodeKind KIND = NodeKind::IntegerLiteral;
+    int64_t value;
+    uint32_t token;
+};
+
+struct FloatLiteralNode {
+    static constexpr NodeKind KIND = NodeKind::FloatLiteral;
+    double value;
+    uint32_t token;
+};
+
+// Append-only array in arena chunks reached through a directory, like
+// TokenStream's blocks; elements never move once added
+template <typename T>
+class NodePool {
+public:
+    static constexpr uint32_t CHUNK_SHIFT = 10;
+    static constexpr uint32_t CHUNK_SIZE = uint32_t(1) << CHUNK_SHIFT;
+    static constexpr uint32_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+    uint32_t add(Arena& arena, const T& value) {
+        if ((count >> CHUNK_SHIFT) == chunks.size()) {
+            chunks.push_back(static_cast<T*>(arena.allocate(sizeof(T) * CHUNK_SIZE, alignof(T))));
+        }
+        new (&chunks[count >> CHUNK_SHIFT][count & CHUNK_MASK]) T(value);
+        return count++;
+    }
+
+    T& operator[](uint32_t index) { return chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK]; }
+    const T& operator[](uint32_t index) const { return chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK]; }
+
+    uint32_t size() const { return count; }
+    size_t directoryBytes() const { return chunks.capacity() * sizeof(T*); }
+
+    // The chunks themselves go with the arena
+    void clear() {
+        chunks.clear();
+        count = 0;
+    }
+
+private:
+    std::vector<T*> chunks;
+    uint32_t count = 0;
+};
+
+class Ast {
+public:
+    // Allocates from an arena of its own
+    Ast();
+    // Allocates from arena, which clear() resets
+    explicit Ast(Arena& arena);
+
+    Ast(const Ast&) = delete;
+    Ast& operator=(const Ast&) = delete;
+
+    template <typename T>
+    NodeRef add(const T& node) {
+        return NodeRef(T::KIND, pool<T>().add(arena, node));
+    }
+
+    template <typename T>
+    const T& get(NodeRef ref) const {
+        return std::get<NodePool<T>>(pools)[ref.index()];
+    }
+
+    template <typename T>
+    T& get(NodeRef ref) {
+        return std::get<NodePool<T>>(pools)[ref.index()];
+    }
+
+    // Every node of kind T, in creation order
+    template <typename T>
+    const NodePool<T>& nodes() const {
+        return std::get<NodePool<T>>(pools);
+    }
+
+    NodeList addList(const NodeRef* refs, size_t count);
+    NodeRef listAt(NodeList list, uint32_t i) const { return lists[list.first + i]; }
+
+    uint32_t addName(std::string_view name);
+    std::string_view name(uint32_t index) const { return names[index]; }
+
+    // Index of node's main token in the parsed TokenStream
+    uint32_t tokenOf(NodeRef node) const;
+    // Move every token index under node, node's own included, by delta
+    void shiftTokens(NodeRef node, int64_t delta);
+
+    // Calls f(NodeRef) on node and every node below it, parents first and
+    // children in source order
+    template <typename F>
+    void forEachNode(NodeRef node, F&& f) const;
+
+    NodeRef getRoot() const { return root; }
+    void setRoot(NodeRef node) { root = node; }
+
+    size_t getNodeCount() const;
+    // Arena bytes plus the pool directories
+    size_t getBytesUsed() const;
+
+    // Drop every node at once
+    void clear();
+
+    // S-expression rendering, one function and one statement per line
+    std::string dump() const;
+    // The same for the tree under node, where an Ast holds several
+    std::string dump(NodeRef node) const;
+
+private:
+    std::unique_ptr<Arena> owned_arena;
+    Arena& arena;
+    std::tuple<NodePool<ProgramNode>, NodePool<FunctionNode>, NodePool<DeclarationNode>,
+               NodePool<AssignmentNode>, NodePool<LoopNode>, NodePool<ReturnNode>,
+               NodePool<ExpressionStatementNode>, NodePool<BinaryNode>, NodePool<IncrementNode>,
+               NodePool<UnaryNode>, NodePool<ConditionalNode>, NodePool<CallNode>, NodePool<IdentifierNode>,
+               NodePool<IntegerLiteralNode>, NodePool<FloatLiteralNode>>
+        pools;
+    NodePool<NodeRef> lists;
+    NodePool<std::string_view> names;
+    NodeRef root;
+
+    template <typename T>
+    NodePool<T>& pool() {
+        return std::get<NodePool<T>>(pools);
+    }
+
+    template <typename AstType>
+    static auto& tokenField(AstType& ast, NodeRef node);
+    void dumpNode(NodeRef node, int depth, std::string& out) const;
+    void dumpBody(NodeList body, int depth, std::string& out) const;
+};
+
+template <typename F>
+void Ast::forEachNode(NodeRef node, F&& f) const {
+    if (!node.isValid()) {
+        return;
+    }
+    f(node);
+    auto body = [&](NodeList list) {
+        for (uint32_t i = 0; i < list.count; i++) {
+            forEachNode(listAt(list, i), f);
+        }
+    };
+    switch (node.kind()) {
+        case NodeKind::Program: body(get<ProgramNode>(node).functions); break;
+        case NodeKind::Function:
+            body(get<FunctionNode>(node).parameters);
+            body(get<FunctionNode>(node).body);
+            break;
+        case NodeKind::Declaration: forEachNode(get<DeclarationNode>(node).init, f); break;
+        case NodeKind::Assignment: forEachNode(get<AssignmentNode>(node).value, f); break;
+        case NodeKind::Loop:
+            forEachNode(get<LoopNode>(node).condition, f);
+            body(get<LoopNode>(node).body);
+            break;
+        case NodeKind::Return: forEachNode(get<ReturnNode>(node).value, f); break;
+        case NodeKind::ExpressionStatement: forEachNode(get<ExpressionStatementNode>(node).expression, f); break;
+        case NodeKind::Binary:
+            forEachNode(get<BinaryNode>(node).lhs, f);
+            forEachNode(get<BinaryNode>(node).rhs, f);
+            break;
+        case NodeKind::Increment: forEachNode(get<IncrementNode>(node).operand, f); break;
+        case NodeKind::Unary: forEachNode(get<UnaryNode>(node).operand, f); break;
+        case NodeKind::Conditional:
+            forEachNode(get<ConditionalNode>(node).condition, f);
+            forEachNode(get<ConditionalNode>(node).then, f);
+            forEachNode(get<ConditionalNode>(node).otherwise, f);
+            break;
+        case NodeKind::Call: body(get<CallNode>(node).arguments); break;
+        case NodeKind::Identifier:
+        case NodeKind::IntegerLiteral:
+        case NodeKind::FloatLiteral:
+            break;
+    }
+}
+
+// ParseEvents handler that builds an Ast. Events arrive in post-order, so
+// operands and statements wait on a node stack until their parent takes
+// them; a function or loop body, or a call's arguments, is the run of nodes
+// pushed since its begin event.
+class AstBuilder : public ParseEvents {
+public:
+    explicit AstBuilder(Ast& ast) : ast(ast) {}
+
+    void onFunctionBegin(SymbolType type, const Token& name, uint32_t index);
+    void onFunctionEnd(const Token& name, uint32_t index);
+    void onParameter(SymbolType type, const Token& name, uint32_t index);
+    void onDeclaration(SymbolType type, const Token& name, uint32_t index, bool has_initializer);
+    void onAssignment(const Token& name, uint32_t index);
+    void onLoopBegin(const Token& keyword, uint32_t index);
+    void onLoopEnd(const Token& keyword, uint32_t index);
+    void onReturn(const Token& keyword, uint32_t index);
+    void onExpressionStatement(const Token& first, uint32_t index);
+    void onExpressionOperator(const Token& op, uint32_t index);
+    void onIncrement(const Token& op, uint32_t index);
+    void onUnaryOperator(const Token& op, uint32_t index);
+    void onConditional(const Token& question, uint32_t index);
+    void onCallBegin(const Token& name, uint32_t index);
+    void onCall(const Token& name, uint32_t index);
+    void onIdentifier(const Token& name, uint32_t index);
+    void onIntegerLiteral(const Token& literal, uint32_t index);
+    void onFloatLiteral(const Token& literal, uint32_t index);
+
+    // The completed functions become the root's
+    void finish();
+
+protected:
+    Ast& ast;
+    std::vector<NodeRef> nodes;
+    std::vector<uint32_t> blocks;  // Height of nodes at each open function, loop or call
+    SymbolType function_type = SymbolType::UNKNOWN;  // Of the open function; functions never nest
+    uint32_t parameter_count = 0;
+    std::unordered_map<std::string_view, uint32_t> name_ids;
+
+    uint32_t nameOf(const Token& token);
+    NodeRef pop();
+    NodeList popBody(uint32_t base);
+};
+
+#endif // AST_H
@@ -0,0 +1,81 @@
+#ifndef COMPILATION_CONTEXT_H
+#define COMPILATION_CONTEXT_H
+
+#include "error.h"
+#include "source_manager.h"
+#include "symbol_table.h"
+#include "arena.h"
+#include "ast.h"
+#include <string>
+#include <vector>
+#include <mutex>
+
+// Everything one compilation owns: its diagnostics, sources, symbols and
+// memory. Separate contexts share no state, so several compilations can run
+// in one process, including concurrently on different threads.
+class CompilationContext {
+public:
+    // unit_index numbers this compilation within a multi-file run; it keeps
+    // file ids distinct in merged machine-readable diagnostics
+    explicit CompilationContext(const std::string& filename, uint32_t unit_index = 0);
+    
+    const std::string& getFilename() const { return filename; }
+    uint32_t getUnitIndex() const { return unit_index; }
+    
+    ErrorReporter& getReporter() { return reporter; }
+    SourceManager& getSourceManager() { return sources; }
+    SymbolTable& getSymbolTable() { return symbol_table; }
+    Arena& getArena() { return arena; }
+    // Allocated from getArena()
+    Ast& getAst() { return ast; }
+    
+    // Diagnostics rendered by getReporter() when capturing output
+    const std::string& getDiagnosticOutput() const { return diagnostic_output; }
+    
+    // Send this compilation's rendered diagnostics to getDiagnosticOutput()
+    // instead of stderr, for merging by a CompilationAggregator
+    void captureDiagnostics();
+
+private:
+    std::string filename;
+    uint32_t unit_index;
+    std::string diagnostic_output;
+    ErrorReporter reporter;
+    SourceManager sources;
+    SymbolTable symbol_table;
+    Arena arena;
+    Ast ast{arena};
+};
+
+// Outcome of one compilation within a multi-file run
+struct CompilationSummary {
+    uint32_t unit_index;
+    std::string filename;
+    int error_count;
+    bool success;
+    std::string diagnostics;  // Captured diagnostic output
+};
+
+// Collects the results of compilations that may finish on different threads
+// and emits their diagnostics in input order
+class CompilationAggregator {
+public:
+    explicit CompilationAggregator(DiagnosticFormat format = DiagnosticFormat::Text) : format(format) {}
+    
+    // Thread-safe
+    void add(CompilationSummary summary);
+    
+    // Results sorted by unit index
+    std::vector<CompilationSummary> getResults() const;
+    int getTotalErrors() const;
+    
+    // Write every captured diagnostic to out as one document
+    void writeDiagnostics(FILE* out) const;
+
+private:
+    DiagnosticFormat format;
+    mutable std::mutex mutex;
+    std::vector<CompilationSummary> results;
+};
+
+#endif // COMPILATION_CONTEXT_H
@@ -0,0 +1,79 @@
+#ifndef DIAGNOSTIC_SERIALIZER_H
+#define DIAGNOSTIC_SERIALIZER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include "diagnostics.h"
+
+// Output formats for diagnostics
+enum class DiagnosticFormat {
+    Text,       // Human-readable "file:line:col: error: ..." batches
+    JsonLines,  // One JSON object per line
+    Sarif       // SARIF 2.1.0 log
+};
+
+// Streams diagnostics as machine-readable records into a preallocated
+// buffer, escaping fields in place so no field needs its own allocation.
+class DiagnosticSerializer {
+public:
+    // With a sink, output is appended to it instead of written to out, and a
+    // SARIF log is reduced to its single run object so runs can be merged
+    explicit DiagnosticSerializer(DiagnosticFormat format, FILE* out = stderr, std::string* sink = nullptr);
+    ~DiagnosticSerializer();
+    
+    // Announce a file before its first diagnostic; ids are dense from the
+    // file id base
+    void addFile(uint32_t file_id, const std::string& path);
+    
+    // First file id. JSON lines keep ids as given, so they stay distinct
+    // across merged compilations; SARIF artifact indices are local to their
+    // run and count from the base.
+    void setFileIdBase(uint32_t base) { file_id_base = base; }
+    
+    // The rendered message is written along with the diagnostic's code and its
+    // raw arguments, whose string contents are in strings
+    void write(DiagnosticId id, uint32_t file_id, uint32_t line, uint32_t column,
+               std::string_view message, const DiagnosticArg* args, size_t arg_count,
+               const std::string& strings);
+    
+    // Close the document (SARIF) and write out everything buffered
+    void finish();
+    
+    // Write out buffered records without closing the document
+    void flush();
+    
+    // Redirect output; only meaningful before the first record is written
+    void setSink(std::string* new_sink) { sink = new_sink; }
+    
+    // Wrapper that turns comma-separated SARIF run objects into a log
+    static const char* const SARIF_LOG_HEADER;
+    static const char* const SARIF_LOG_FOOTER;
+
+private:
+    static constexpr size_t BUFFER_CAPACITY = 64 * 1024;
+    
+    DiagnosticFormat format;
+    FILE* out;
+    std::string* sink;
+    std::string buffer;
+    std::vector<std::string> artifacts;  // SARIF artifact table, by file id less the base
+    uint32_t file_id_base = 0;
+    bool started = false;
+    bool finished = false;
+    bool first_result = true;
+    
+    void begin();
+    void append(const char* text);
+    void appendNumber(uint32_t value);
+    void appendEscaped(const char* text, size_t length);
+    // path as a quoted URI reference: a file:// URI if it is absolute, and
+    // every byte but the unreserved characters and '/' percent-encoded, so
+    // a '#', '?', '%' or space stays part of the path
+    void appendUri(const std::string& path);
+    void appendArg(const DiagnosticArg& arg, const std::string& strings, bool as_string);
+};
+
+#endif // DIAGNOSTIC_SERIALIZER_H
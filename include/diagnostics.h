@@ -0,0 +1,73 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <fmt/format.h>
+#include <cstdint>
+#include <cstddef>
+
+enum class DiagnosticType {
+    Error,
+    Warning,
+    Note
+};
+
+// Every diagnostic in diagnostics.def, in table order
+enum class DiagnosticId : uint16_t {
+#define DIAGNOSTIC(name, severity, code, format) name,
+#include "diagnostics.def"
+#undef DIAGNOSTIC
+};
+
+struct DiagnosticInfo {
+    DiagnosticType severity;
+    const char* code;    // Stable id for machine-readable output, e.g. "E0201"
+    const char* name;
+    const char* format;  // fmt format string
+};
+
+// Indexed by DiagnosticId
+inline constexpr DiagnosticInfo DIAGNOSTIC_TABLE[] = {
+#define DIAGNOSTIC(name, severity, code, format) {DiagnosticType::severity, code, #name, format},
+#include "diagnostics.def"
+#undef DIAGNOSTIC
+};
+
+inline const DiagnosticInfo& getDiagnosticInfo(DiagnosticId id) {
+    return DIAGNOSTIC_TABLE[static_cast<size_t>(id)];
+}
+
+// One tag type per diagnostic. ErrorReporter::report() checks the tag's format
+// string against the argument types at compile time.
+namespace diag {
+#define DIAGNOSTIC(name, severity, code, format)                                \
+    struct name {                                                               \
+        static constexpr DiagnosticId id = DiagnosticId::name;                  \
+        static constexpr auto formatString() { return FMT_STRING(format); }     \
+    };
+#include "diagnostics.def"
+#undef DIAGNOSTIC
+}
+
+// A diagnostic argument, kept unformatted until the diagnostic is rendered.
+// String contents live in the reporter's string pool.
+struct DiagnosticArg {
+    enum class Kind : uint8_t {
+        Int,
+        UInt,
+        Double,
+        Char,
+        String
+    };
+
+    Kind kind;
+    union {
+        int64_t int_value;
+        uint64_t uint_value;
+        double double_value;
+        char char_value;
+        uint32_t string_offset;
+    };
+    uint32_t string_length;
+};
+
+#endif // DIAGNOSTICS_H
@@ -3,7 +3,13 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <cstdint>
+#include <type_traits>
+#include <fmt/args.h>
+#include "diagnostics.h"
+#include "diagnostic_serializer.h"
 
 class SourceLocation {
 public:
@@ -15,10 +21,16 @@ public:
     uint32_t column;
 };
 
-enum class DiagnosticType {
-    Error,
-    Warning,
-    Note
+// Compact record of a diagnostic awaiting rendering. Its arguments live in the
+// reporter's argument pool and are only formatted when the batch is flushed.
+struct Diagnostic {
+    DiagnosticId id;
+    uint32_t file_index;      // Into ErrorReporter::pending_files
+    uint32_t line;
+    uint32_t column;
+    uint32_t arg_offset;      // Into ErrorReporter::arg_pool
+    uint32_t arg_count;
+    uint32_t sequence;        // Report order, keeps sorting stable
 };
 
 class ErrorReporter {
@@ -28,22 +40,116 @@ public:
     
     bool init(const std::string& src_filename);
     
-    void error(const SourceLocation& loc, const char* format, ...);
-    void warning(const SourceLocation& loc, const char* format, ...);
-    void note(const SourceLocation& loc, const char* format, ...);
+    // Borrow an already-loaded copy of the current file's contents
+    void setSourceBuffer(std::shared_ptr<const std::string> text);
+    void setSourceBuffer(const std::string& filename, std::shared_ptr<const std::string> text);
+    
+    // Report a diagnostic from diagnostics.def, e.g.
+    //   report(diag::UndeclaredVariable{}, loc, name);
+    // A format string that does not fit the arguments fails to compile.
+    template <typename Diag, typename... Args>
+    void report(Diag, const SourceLocation& loc, const Args&... args) {
+        static_cast<void>(fmt::format_string<Args...>(Diag::formatString()));
+        
+        uint32_t arg_offset = static_cast<uint32_t>(arg_pool.size());
+        (pushArg(args), ...);
+        recordDiagnostic(Diag::id, loc, arg_offset);
+    }
     
     int getErrorCount() const;
     const std::string& getCurrentFile() const { return current_file; }
     
+    // Stream diagnostics as JSON lines or SARIF instead of batched text
+    void setFormat(DiagnosticFormat format);
+    DiagnosticFormat getFormat() const { return format; }
+    
+    // Append rendered output to sink instead of writing it to stderr;
+    // set it before the first diagnostic is reported
+    void setOutput(std::string* sink);
+    
+    // First id handed out to files in machine-readable output
+    void setFileIdBase(uint32_t base);
+    
+    // Render every pending diagnostic, sorted by location, in a single write
+    void flush();
+    
+    // Keep every diagnostic pending, however many, until flush() or adopt()
+    void setAutoFlush(bool enable) { auto_flush = enable; }
+    
+    // Report other's pending diagnostics here, in the order other recorded
+    // them, and drop them from other; e.g. to merge reporters of work done
+    // on several threads. other must be in text format. Source buffers other
+    // was lent come along, so the diagnostics render as they would there.
+    void adopt(ErrorReporter& other);
+    
+    // Flush and close any machine-readable document; call once at exit
+    void finish();
+    
     void cleanup();
 
 private:
     std::string current_file;
     int error_count = 0;
-    std::vector<std::string> source_lines;
     
-    void printSourceLine(const SourceLocation& loc);
-    void reportDiagnostic(DiagnosticType type, const SourceLocation& loc, const char* format, va_list args);
+    // Source text and line-start offsets of each file diagnostics are
+    // reported in, only indexed once a diagnostic needs them
+    struct SourceLines {
+        std::shared_ptr<const std::string> text;
+        std::vector<uint32_t> offsets;
+        bool indexed = false;
+    };
+    std::unordered_map<std::string, SourceLines> sources;
+    
+    // Diagnostics recorded since the last flush
+    static constexpr size_t FLUSH_THRESHOLD = 4096;
+    bool auto_flush = true;
+    std::vector<Diagnostic> pending;
+    std::vector<std::string> pending_files;
+    std::vector<DiagnosticArg> arg_pool;
+    std::string string_pool;  // Contents of string arguments
+    std::string output;       // Reused render buffer, grows as needed
+    fmt::dynamic_format_arg_store<fmt::format_context> format_args;
+    
+    // Machine-readable output, streamed as diagnostics are reported
+    DiagnosticFormat format = DiagnosticFormat::Text;
+    std::unique_ptr<DiagnosticSerializer> serializer;
+    std::vector<std::string> files;  // File ids handed to the serializer
+    uint32_t file_id_base = 0;
+    std::string* output_sink = nullptr;
+    
+    uint32_t fileId(const std::string& filename);
+    
+    const SourceLines& indexSourceLines(const std::string& filename);
+    void renderSourceLine(const Diagnostic& diag);
+    void renderMessage(DiagnosticId id, uint32_t arg_offset, uint32_t arg_count, std::string& out);
+    void recordDiagnostic(DiagnosticId id, const SourceLocation& loc, uint32_t arg_offset);
+    
+    template <typename T>
+    void pushArg(const T& value) {
+        DiagnosticArg arg;
+        arg.string_length = 0;
+        if constexpr (std::is_same_v<T, char>) {
+            arg.kind = DiagnosticArg::Kind::Char;
+            arg.char_value = value;
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            arg.kind = DiagnosticArg::Kind::Int;
+            arg.int_value = value;
+        } else if constexpr (std::is_integral_v<T>) {
+            arg.kind = DiagnosticArg::Kind::UInt;
+            arg.uint_value = value;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.kind = DiagnosticArg::Kind::Double;
+            arg.double_value = value;
+        } else {
+            // Strings are copied, the caller's buffer may not outlive the batch
+            fmt::string_view text(value);
+            arg.kind = DiagnosticArg::Kind::String;
+            arg.string_offset = static_cast<uint32_t>(string_pool.size());
+            arg.string_length = static_cast<uint32_t>(text.size());
+            string_pool.append(text.data(), text.size());
+        }
+        arg_pool.push_back(arg);
+    }
 };
 
 // Global error reporter instance
@@ -0,0 +1,23 @@
+#ifndef GENERATED_PARSER_H
+#define GENERATED_PARSER_H
+
+#include "parse_actions.h"
+
+// Direct-coded LL(1) parser for the Mini-C grammar. parse() is emitted at
+// build time by tools/parser_generator.cpp from src/grammar.txt: one switch
+// per non-terminal over terminal ids, with each production's pushes spelled
+// out. Token matching and the semantic actions of Parser::parse() come from
+// ParseActions.
+class GeneratedParser : private ParseActions {
+public:
+    GeneratedParser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable)
+        : ParseActions(std::move(tokens), reporter, symtable) {}
+
+    GeneratedParser(TokenStream tokens, CompilationContext& context)
+        : GeneratedParser(std::move(tokens), context.getReporter(), context.getSymbolTable()) {}
+
+    // Emitted by the generator
+    bool parse();
+};
+
+#endif // GENERATED_PARSER_H
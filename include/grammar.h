@@ -0,0 +1,483 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include "token.h"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+// Non-terminal symbols in our grammar
+enum class NonTerminal {
+    PROGRAM,
+    FUNCTION_LIST,
+    FUNCTION,
+    PARAMETER_LIST,
+    PARAMETER_TAIL,
+    PARAMETER,
+    STATEMENT_LIST,
+    STATEMENT,
+    DECLARATION,
+    DECLARATION_TAIL,
+    TYPE,
+    ASSIGNMENT,
+    LOOP,
+    CONDITION,
+    RELATIONAL_OP,
+    RETURN_STMT,
+    EXPRESSION,
+    EXPRESSION_TAIL,
+    TERM,
+    TERM_TAIL,
+    FACTOR,
+    FACTOR_TAIL,
+    ARGUMENT_LIST,
+    ARGUMENT_TAIL
+};
+
+constexpr size_t NONTERMINAL_COUNT = static_cast<size_t>(NonTerminal::ARGUMENT_TAIL) + 1;
+
+// String representation for NonTerminals (for debugging)
+inline std::string nonTerminalToString(NonTerminal nt) {
+    switch (nt) {
+        case NonTerminal::PROGRAM: return "PROGRAM";
+        case NonTerminal::FUNCTION_LIST: return "FUNCTION_LIST";
+        case NonTerminal::FUNCTION: return "FUNCTION";
+        case NonTerminal::PARAMETER_LIST: return "PARAMETER_LIST";
+        case NonTerminal::PARAMETER_TAIL: return "PARAMETER_TAIL";
+        case NonTerminal::PARAMETER: return "PARAMETER";
+        case NonTerminal::STATEMENT_LIST: return "STATEMENT_LIST";
+        case NonTerminal::STATEMENT: return "STATEMENT";
+        case NonTerminal::DECLARATION: return "DECLARATION";
+        case NonTerminal::DECLARATION_TAIL: return "DECLARATION_TAIL";
+        case NonTerminal::TYPE: return "TYPE";
+        case NonTerminal::ASSIGNMENT: return "ASSIGNMENT";
+        case NonTerminal::LOOP: return "LOOP";
+        case NonTerminal::CONDITION: return "CONDITION";
+        case NonTerminal::RELATIONAL_OP: return "RELATIONAL_OP";
+        case NonTerminal::RETURN_STMT: return "RETURN_STMT";
+        case NonTerminal::EXPRESSION: return "EXPRESSION";
+        case NonTerminal::EXPRESSION_TAIL: return "EXPRESSION_TAIL";
+        case NonTerminal::TERM: return "TERM";
+        case NonTerminal::TERM_TAIL: return "TERM_TAIL";
+        case NonTerminal::FACTOR: return "FACTOR";
+        case NonTerminal::FACTOR_TAIL: return "FACTOR_TAIL";
+        case NonTerminal::ARGUMENT_LIST: return "ARGUMENT_LIST";
+        case NonTerminal::ARGUMENT_TAIL: return "ARGUMENT_TAIL";
+        default: return "UNKNOWN";
+    }
+}
+
+// Grammar symbols packed into 16 bits: terminals are their TerminalId,
+// non-terminals have the top bit set. The parse stack also holds event
+// markers, with the next bit set, that never appear in a grammar.
+using Symbol = uint16_t;
+
+namespace symbol {
+constexpr Symbol NONTERMINAL_FLAG = 0x8000;
+constexpr Symbol EVENT_FLAG = 0x4000;
+
+constexpr Symbol nt(NonTerminal nonterm) { return NONTERMINAL_FLAG | static_cast<Symbol>(nonterm); }
+constexpr bool isNonTerminal(Symbol sym) { return (sym & NONTERMINAL_FLAG) != 0; }
+constexpr size_t nonTerminalIndex(Symbol sym) { return sym & ~NONTERMINAL_FLAG; }
+
+constexpr Symbol event(uint8_t kind) { return EVENT_FLAG | kind; }
+constexpr bool isEvent(Symbol sym) { return (sym & (NONTERMINAL_FLAG | EVENT_FLAG)) == EVENT_FLAG; }
+constexpr uint8_t eventKind(Symbol sym) { return static_cast<uint8_t>(sym & ~EVENT_FLAG); }
+}
+
+// One production; an empty right-hand side is an epsilon production
+struct GrammarRule {
+    static constexpr size_t MAX_RHS = 8;
+
+    NonTerminal lhs;
+    uint8_t length;
+    Symbol rhs[MAX_RHS];
+};
+
+constexpr GrammarRule rule(NonTerminal lhs, std::initializer_list<Symbol> rhs) {
+    GrammarRule result{lhs, 0, {}};
+    for (Symbol sym : rhs) {
+        result.rhs[result.length++] = sym;
+    }
+    return result;
+}
+
+// The Mini-C grammar (see grammar.txt). Rule indices are production numbers
+// in the parse table.
+namespace minic_grammar {
+using N = NonTerminal;
+using symbol::nt;
+constexpr Symbol kw(KeywordType kw) { return terminal::keyword(kw); }
+constexpr Symbol op(OperatorType op) { return terminal::op(op); }
+constexpr Symbol punct(PunctuationType punct) { return terminal::punct(punct); }
+
+inline constexpr GrammarRule RULES[] = {
+    // PROGRAM → FUNCTION FUNCTION_LIST
+    rule(N::PROGRAM, {nt(N::FUNCTION), nt(N::FUNCTION_LIST)}),
+
+    // FUNCTION_LIST → FUNCTION FUNCTION_LIST | ε
+    rule(N::FUNCTION_LIST, {nt(N::FUNCTION), nt(N::FUNCTION_LIST)}),
+    rule(N::FUNCTION_LIST, {}),
+
+    // FUNCTION → TYPE IDENTIFIER ( PARAMETER_LIST ) { STATEMENT_LIST }
+    rule(N::FUNCTION, {nt(N::TYPE), terminal::IDENTIFIER, punct(PunctuationType::LPAREN), nt(N::PARAMETER_LIST),
+                       punct(PunctuationType::RPAREN), punct(PunctuationType::LBRACE), nt(N::STATEMENT_LIST),
+                       punct(PunctuationType::RBRACE)}),
+
+    // PARAMETER_LIST → PARAMETER PARAMETER_TAIL | ε
+    rule(N::PARAMETER_LIST, {nt(N::PARAMETER), nt(N::PARAMETER_TAIL)}),
+    rule(N::PARAMETER_LIST, {}),
+
+    // PARAMETER_TAIL → , PARAMETER PARAMETER_TAIL | ε
+    rule(N::PARAMETER_TAIL, {op(OperatorType::COMMA), nt(N::PARAMETER), nt(N::PARAMETER_TAIL)}),
+    rule(N::PARAMETER_TAIL, {}),
+
+    // PARAMETER → TYPE IDENTIFIER
+    rule(N::PARAMETER, {nt(N::TYPE), terminal::IDENTIFIER}),
+
+    // STATEMENT_LIST → STATEMENT STATEMENT_LIST | ε
+    rule(N::STATEMENT_LIST, {nt(N::STATEMENT), nt(N::STATEMENT_LIST)}),
+    rule(N::STATEMENT_LIST, {}),
+
+    // STATEMENT → DECLARATION | ASSIGNMENT | LOOP | RETURN_STMT | EXPRESSION ; | ε
+    rule(N::STATEMENT, {nt(N::DECLARATION)}),
+    rule(N::STATEMENT, {nt(N::ASSIGNMENT)}),
+    rule(N::STATEMENT, {nt(N::LOOP)}),
+    rule(N::STATEMENT, {nt(N::RETURN_STMT)}),
+    rule(N::STATEMENT, {nt(N::EXPRESSION), op(OperatorType::SEMICOLON)}),
+    rule(N::STATEMENT, {}),
+
+    // DECLARATION → TYPE IDENTIFIER DECLARATION_TAIL
+    rule(N::DECLARATION, {nt(N::TYPE), terminal::IDENTIFIER, nt(N::DECLARATION_TAIL)}),
+
+    // DECLARATION_TAIL → = EXPRESSION ; | ;
+    rule(N::DECLARATION_TAIL, {op(OperatorType::EQUAL), nt(N::EXPRESSION), op(OperatorType::SEMICOLON)}),
+    rule(N::DECLARATION_TAIL, {op(OperatorType::SEMICOLON)}),
+
+    // TYPE → int | float
+    rule(N::TYPE, {kw(KeywordType::Int)}),
+    rule(N::TYPE, {kw(KeywordType::Float)}),
+
+    // ASSIGNMENT → IDENTIFIER = EXPRESSION ;
+    rule(N::ASSIGNMENT, {terminal::IDENTIFIER, op(OperatorType::EQUAL), nt(N::EXPRESSION),
+                         op(OperatorType::SEMICOLON)}),
+
+    // LOOP → while ( CONDITION ) { STATEMENT_LIST }
+    rule(N::LOOP, {kw(KeywordType::While), punct(PunctuationType::LPAREN), nt(N::CONDITION),
+                   punct(PunctuationType::RPAREN), punct(PunctuationType::LBRACE),
+                   nt(N::STATEMENT_LIST), punct(PunctuationType::RBRACE)}),
+
+    // CONDITION → EXPRESSION RELATIONAL_OP EXPRESSION
+    rule(N::CONDITION, {nt(N::EXPRESSION), nt(N::RELATIONAL_OP), nt(N::EXPRESSION)}),
+
+    // RELATIONAL_OP → < | > | <= | >= | == | !=
+    rule(N::RELATIONAL_OP, {op(OperatorType::LESS)}),
+    rule(N::RELATIONAL_OP, {op(OperatorType::GREATER)}),
+    rule(N::RELATIONAL_OP, {op(OperatorType::LE)}),
+    rule(N::RELATIONAL_OP, {op(OperatorType::GE)}),
+    rule(N::RELATIONAL_OP, {op(OperatorType::EQ)}),
+    rule(N::RELATIONAL_OP, {op(OperatorType::NE)}),
+
+    // RETURN_STMT → return EXPRESSION ;
+    rule(N::RETURN_STMT, {kw(KeywordType::Return), nt(N::EXPRESSION), op(OperatorType::SEMICOLON)}),
+
+    // EXPRESSION → TERM EXPRESSION_TAIL
+    rule(N::EXPRESSION, {nt(N::TERM), nt(N::EXPRESSION_TAIL)}),
+
+    // EXPRESSION_TAIL → + TERM EXPRESSION_TAIL | - TERM EXPRESSION_TAIL | ε
+    rule(N::EXPRESSION_TAIL, {op(OperatorType::PLUS), nt(N::TERM), nt(N::EXPRESSION_TAIL)}),
+    rule(N::EXPRESSION_TAIL, {op(OperatorType::MINUS), nt(N::TERM), nt(N::EXPRESSION_TAIL)}),
+    rule(N::EXPRESSION_TAIL, {}),
+
+    // TERM → FACTOR TERM_TAIL
+    rule(N::TERM, {nt(N::FACTOR), nt(N::TERM_TAIL)}),
+
+    // TERM_TAIL → * FACTOR TERM_TAIL | / FACTOR TERM_TAIL | ε
+    rule(N::TERM_TAIL, {op(OperatorType::STAR), nt(N::FACTOR), nt(N::TERM_TAIL)}),
+    rule(N::TERM_TAIL, {op(OperatorType::SLASH), nt(N::FACTOR), nt(N::TERM_TAIL)}),
+    rule(N::TERM_TAIL, {}),
+
+    // FACTOR → IDENTIFIER FACTOR_TAIL | INTEGER_LITERAL | FLOAT_LITERAL | ( EXPRESSION )
+    rule(N::FACTOR, {terminal::IDENTIFIER, nt(N::FACTOR_TAIL)}),
+    rule(N::FACTOR, {terminal::INTEGER_LITERAL}),
+    rule(N::FACTOR, {terminal::FLOAT_LITERAL}),
+    rule(N::FACTOR, {punct(PunctuationType::LPAREN), nt(N::EXPRESSION), punct(PunctuationType::RPAREN)}),
+
+    // FACTOR_TAIL → ++ | -- | ( ARGUMENT_LIST ) | ε
+    rule(N::FACTOR_TAIL, {op(OperatorType::INC)}),
+    rule(N::FACTOR_TAIL, {op(OperatorType::DEC)}),
+    rule(N::FACTOR_TAIL, {punct(PunctuationType::LPAREN), nt(N::ARGUMENT_LIST), punct(PunctuationType::RPAREN)}),
+    rule(N::FACTOR_TAIL, {}),
+
+    // ARGUMENT_LIST → EXPRESSION ARGUMENT_TAIL | ε
+    rule(N::ARGUMENT_LIST, {nt(N::EXPRESSION), nt(N::ARGUMENT_TAIL)}),
+    rule(N::ARGUMENT_LIST, {}),
+
+    // ARGUMENT_TAIL → , EXPRESSION ARGUMENT_TAIL | ε
+    rule(N::ARGUMENT_TAIL, {op(OperatorType::COMMA), nt(N::EXPRESSION), nt(N::ARGUMENT_TAIL)}),
+    rule(N::ARGUMENT_TAIL, {}),
+};
+
+constexpr size_t RULE_COUNT = sizeof(RULES) / sizeof(RULES[0]);
+}
+
+// Fixed-width set of terminal ids
+struct TerminalSet {
+    static constexpr size_t WORDS = (terminal::COUNT + 63) / 64;
+
+    uint64_t bits[WORDS] = {};
+
+    constexpr bool contains(TerminalId id) const {
+        return (bits[id >> 6] >> (id & 63)) & 1;
+    }
+
+    // Both return true if the set grew
+    constexpr bool insert(TerminalId id) {
+        uint64_t mask = uint64_t(1) << (id & 63);
+        bool added = (bits[id >> 6] & mask) == 0;
+        bits[id >> 6] |= mask;
+        return added;
+    }
+
+    constexpr bool merge(const TerminalSet& other) {
+        bool changed = false;
+        for (size_t i = 0; i < WORDS; i++) {
+            uint64_t merged = bits[i] | other.bits[i];
+            changed |= merged != bits[i];
+            bits[i] = merged;
+        }
+        return changed;
+    }
+};
+
+// Conflicts that parse() resolves by hand, by looking ahead, instead of
+// through the table: STATEMENT and STATEMENT_LIST are ambiguous with their
+// epsilon alternatives
+constexpr bool isExpectedConflict(NonTerminal nonterm, TerminalId lookahead) {
+    if (nonterm == NonTerminal::STATEMENT_LIST) {
+        return lookahead == terminal::punct(PunctuationType::RBRACE);
+    }
+    if (nonterm == NonTerminal::STATEMENT) {
+        return lookahead == terminal::IDENTIFIER ||
+               lookahead == terminal::INTEGER_LITERAL ||
+               lookahead == terminal::FLOAT_LITERAL ||
+               lookahead == terminal::punct(PunctuationType::LPAREN) ||
+               lookahead == terminal::keyword(KeywordType::Int) ||
+               lookahead == terminal::keyword(KeywordType::Float) ||
+               lookahead == terminal::keyword(KeywordType::Return) ||
+               lookahead == terminal::keyword(KeywordType::While);
+    }
+    return false;
+}
+
+// FIRST/FOLLOW sets and the LL(1) prediction table of a grammar
+struct GrammarTables {
+    static constexpr int16_t NO_PRODUCTION = -1;
+
+    TerminalSet first[NONTERMINAL_COUNT] = {};
+    bool nullable[NONTERMINAL_COUNT] = {};
+    TerminalSet follow[NONTERMINAL_COUNT] = {};
+    int16_t predict[NONTERMINAL_COUNT][terminal::COUNT] = {};
+
+    // Unexpected conflicts; the first one is recorded for the error message
+    size_t conflict_count = 0;
+    NonTerminal conflict_nonterminal = NonTerminal::PROGRAM;
+    TerminalId conflict_terminal = 0;
+};
+
+// Computes FIRST, FOLLOW and the table for rules; usable at compile time.
+// Where two productions compete for a cell, one selected through FIRST beats
+// one selected through FOLLOW and otherwise the later one wins; the cell
+// counts as a conflict unless isExpectedConflict() allows it.
+template <size_t N>
+constexpr GrammarTables computeGrammarTables(const GrammarRule (&rules)[N]) {
+    GrammarTables tables;
+
+    // FIRST sets and nullability, to a fixed point
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const GrammarRule& r : rules) {
+            size_t lhs = static_cast<size_t>(r.lhs);
+            bool all_nullable = true;
+            for (size_t i = 0; i < r.length && all_nullable; i++) {
+                Symbol sym = r.rhs[i];
+                if (symbol::isNonTerminal(sym)) {
+                    size_t index = symbol::nonTerminalIndex(sym);
+                    changed |= tables.first[lhs].merge(tables.first[index]);
+                    all_nullable = tables.nullable[index];
+                } else {
+                    changed |= tables.first[lhs].insert(sym);
+                    all_nullable = false;
+                }
+            }
+            if (all_nullable && !tables.nullable[lhs]) {
+                tables.nullable[lhs] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // FOLLOW sets, starting from end of file after the start symbol
+    tables.follow[static_cast<size_t>(NonTerminal::PROGRAM)].insert(terminal::END_OF_FILE);
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (const GrammarRule& r : rules) {
+            for (size_t i = 0; i < r.length; i++) {
+                if (!symbol::isNonTerminal(r.rhs[i])) {
+                    continue;
+                }
+                size_t b = symbol::nonTerminalIndex(r.rhs[i]);
+
+                // FIRST of what follows B, and FOLLOW(A) if all of it is nullable
+                bool rest_nullable = true;
+                for (size_t j = i + 1; j < r.length && rest_nullable; j++) {
+                    Symbol sym = r.rhs[j];
+                    if (symbol::isNonTerminal(sym)) {
+                        changed |= tables.follow[b].merge(tables.first[symbol::nonTerminalIndex(sym)]);
+                        rest_nullable = tables.nullable[symbol::nonTerminalIndex(sym)];
+                    } else {
+                        changed |= tables.follow[b].insert(sym);
+                        rest_nullable = false;
+                    }
+                }
+                if (rest_nullable) {
+                    changed |= tables.follow[b].merge(tables.follow[static_cast<size_t>(r.lhs)]);
+                }
+            }
+        }
+    }
+
+    // Prediction table: FIRST of each right-hand side, plus FOLLOW of the
+    // left-hand side when the right-hand side is nullable. FOLLOW selections
+    // go in first so that a production which consumes the lookahead always
+    // overrides one that would only derive ε on it.
+    for (auto& row : tables.predict) {
+        for (auto& cell : row) {
+            cell = GrammarTables::NO_PRODUCTION;
+        }
+    }
+    for (bool by_first : {false, true}) {
+        for (size_t p = 0; p < N; p++) {
+            const GrammarRule& r = rules[p];
+            size_t lhs = static_cast<size_t>(r.lhs);
+
+            TerminalSet select;
+            bool nullable = true;
+            for (size_t i = 0; i < r.length && nullable; i++) {
+                Symbol sym = r.rhs[i];
+                if (symbol::isNonTerminal(sym)) {
+                    select.merge(tables.first[symbol::nonTerminalIndex(sym)]);
+                    nullable = tables.nullable[symbol::nonTerminalIndex(sym)];
+                } else {
+                    select.insert(sym);
+                    nullable = false;
+                }
+            }
+            if (!by_first) {
+                select = nullable ? tables.follow[lhs] : TerminalSet();
+            }
+
+            for (TerminalId t = 0; t < terminal::COUNT; t++) {
+                if (!select.contains(t)) {
+                    continue;
+                }
+                int16_t& cell = tables.predict[lhs][t];
+                if (cell != GrammarTables::NO_PRODUCTION && cell != static_cast<int16_t>(p) &&
+                    !isExpectedConflict(r.lhs, t)) {
+                    if (tables.conflict_count++ == 0) {
+                        tables.conflict_nonterminal = r.lhs;
+                        tables.conflict_terminal = t;
+                    }
+                    continue;
+                }
+                cell = static_cast<int16_t>(p);
+            }
+        }
+    }
+
+    return tables;
+}
+
+// Tables for the Mini-C grammar, computed by the compiler
+inline constexpr GrammarTables GRAMMAR_TABLES = computeGrammarTables(minic_grammar::RULES);
+
+static_assert(GRAMMAR_TABLES.conflict_count == 0,
+              "Mini-C grammar has an LL(1) conflict; see GRAMMAR_TABLES.conflict_nonterminal/conflict_terminal");
+
+// Whether parse() can expand a non-terminal back into itself on one
+// lookahead t without consuming t, and so loop forever. A reaches B on t if
+// B appears in the production predict[A][t] after symbols that all vanish on
+// t, i.e. expand to nothing without consuming it. Unlike a plain
+// left-recursion check this sees the table's conflict resolution, which is
+// what keeps STATEMENT_LIST → STATEMENT STATEMENT_LIST (with a nullable
+// STATEMENT) from looping: STATEMENT only vanishes where no statement starts. Without a cycle there is a bounded number of
+// expansions and epsilon pops per token, so parsing is linear. Returns the
+// first non-terminal on a cycle, or NONTERMINAL_COUNT if there is none.
+template <size_t N>
+constexpr size_t findExpansionCycle(const GrammarRule (&rules)[N], const GrammarTables& tables) {
+    for (TerminalId t = 0; t < terminal::COUNT; t++) {
+        // Non-terminals that vanish on t, to a fixed point
+        bool vanishes[NONTERMINAL_COUNT] = {};
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t a = 0; a < NONTERMINAL_COUNT; a++) {
+                int16_t p = tables.predict[a][t];
+                if (vanishes[a] || p == GrammarTables::NO_PRODUCTION) {
+                    continue;
+                }
+                const GrammarRule& r = rules[p];
+                bool all_vanish = true;
+                for (size_t i = 0; i < r.length && all_vanish; i++) {
+                    all_vanish = symbol::isNonTerminal(r.rhs[i]) && vanishes[symbol::nonTerminalIndex(r.rhs[i])];
+                }
+                if (all_vanish) {
+                    vanishes[a] = true;
+                    changed = true;
+                }
+            }
+        }
+
+        bool reaches[NONTERMINAL_COUNT][NONTERMINAL_COUNT] = {};
+        for (size_t a = 0; a < NONTERMINAL_COUNT; a++) {
+            int16_t p = tables.predict[a][t];
+            if (p == GrammarTables::NO_PRODUCTION) {
+                continue;
+            }
+            const GrammarRule& r = rules[p];
+            for (size_t i = 0; i < r.length && symbol::isNonTerminal(r.rhs[i]); i++) {
+                size_t b = symbol::nonTerminalIndex(r.rhs[i]);
+                reaches[a][b] = true;
+                if (!vanishes[b]) {
+                    break;
+                }
+            }
+        }
+        // Closure; rows without the edge are skipped, which keeps the
+        // compile-time evaluation within the compiler's operation limit
+        for (size_t k = 0; k < NONTERMINAL_COUNT; k++) {
+            for (size_t i = 0; i < NONTERMINAL_COUNT; i++) {
+                if (!reaches[i][k]) {
+                    continue;
+                }
+                for (size_t j = 0; j < NONTERMINAL_COUNT; j++) {
+                    reaches[i][j] = reaches[i][j] || reaches[k][j];
+                }
+            }
+        }
+        for (size_t i = 0; i < NONTERMINAL_COUNT; i++) {
+            if (reaches[i][i]) {
+                return i;
+            }
+        }
+    }
+    return NONTERMINAL_COUNT;
+}
+
+static_assert(findExpansionCycle(minic_grammar::RULES, GRAMMAR_TABLES) == NONTERMINAL_COUNT,
+              "Mini-C grammar can expand without consuming input; parse() would not terminate");
+
+#endif // GRAMMAR_H
@@ -0,0 +1,76 @@
+#ifndef INCREMENTAL_PARSER_H
+#define INCREMENTAL_PARSER_H
+
+#include "parser.h"
+
+// Reparsing after an edit, for editors. The tree of the previous parse is
+// kept together with the token span of every statement in it; reparse()
+// runs Parser again over the new tokens, and wherever a statement would
+// start on tokens the edit did not touch, takes the old statement's subtree
+// instead of parsing it. A statement parses from STATEMENT the same way
+// whatever surrounds it, so only the damaged statements and the loops and
+// function around them are parsed again, and the tree, symbol table and
+// diagnostics come out as a full parse would make them.
+
+// Tokens [start, old_end) of the previous stream became [start, new_end)
+// of the new one; everything before and after is unchanged
+struct TokenEdit {
+    uint32_t start;
+    uint32_t old_end;
+    uint32_t new_end;
+
+    // The smallest edit between two lexings: common prefix and suffix
+    // compared by terminal and lexeme
+    static TokenEdit between(const TokenStream& before, const TokenStream& after);
+};
+
+class IncrementalParser {
+public:
+    // Full parses happen again once replaced nodes would make the tree's
+    // arena this many times what the last full parse used
+    static constexpr size_t MAX_GROWTH = 2;
+
+    // Parse from scratch, forgetting the previous tree
+    bool parse(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable);
+
+    // Parse tokens, which differ from the previous parse's by edit, reusing
+    // the statements outside it. Falls back to parse() when there is no
+    // successful previous parse to reuse.
+    bool reparse(TokenStream tokens, const TokenEdit& edit, ErrorReporter& reporter, SymbolTable& symtable);
+
+    // Tree of the last parse, empty if it failed. Reused subtrees are the
+    // previous tree's nodes, with their token indices moved past the edit.
+    const Ast& getAst() const { return ast; }
+    const ParseStats& getStats() const { return stats; }
+
+    // Statements the last parse took over, and the tokens in them
+    size_t getReusedStatements() const { return reused_statements; }
+    size_t getReusedTokens() const { return reused_tokens; }
+
+    // See Parser::setPrattExpressions(); a change makes the next reparse full
+    void setPrattExpressions(bool enable) { pratt_expressions = enable; }
+
+    // Where a statement's tokens are, and its node
+    struct StatementSpan {
+        uint32_t begin;
+        uint32_t end;
+        NodeRef node;
+    };
+
+private:
+    Ast ast;
+    std::unordered_map<std::string_view, uint32_t> names;  // AstBuilder's, kept for the names in ast
+    std::vector<StatementSpan> statements;  // Every statement of the tree, by begin
+    size_t token_count = 0;                 // Size of the stream the tree was parsed from
+    bool valid = false;                     // Whether the tree and statements are usable
+    bool parsed_pratt = false;              // Expression mode the tree was parsed in
+    bool pratt_expressions = false;
+    size_t full_parse_bytes = 0;
+    ParseStats stats;
+    size_t reused_statements = 0;
+    size_t reused_tokens = 0;
+
+    bool run(TokenStream tokens, const TokenEdit* edit, ErrorReporter& reporter, SymbolTable& symtable);
+};
+
+#endif // INCREMENTAL_PARSER_H
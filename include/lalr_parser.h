@@ -0,0 +1,122 @@
+#ifndef LALR_PARSER_H
+#define LALR_PARSER_H
+
+#include "parse_actions.h"
+
+// Shift-reduce alternative to the LL(1) parsers. LalrTables builds LALR(1)
+// action and goto tables for any grammar in FirstFollowSets' Production
+// form, so expression rules can stay left-recursive instead of going
+// through the _TAIL non-terminals; LalrParser drives them.
+
+// Sparse rows packed into one array by row displacement: row r's entry for
+// column c sits at base[r] + c when check there is r, and is the row's
+// default everywhere else
+class CombTable {
+public:
+    // rows[r][c] for every column; entries equal to defaults[r] are dropped
+    void pack(const std::vector<std::vector<int16_t>>& rows, std::vector<int16_t> row_defaults);
+
+    int16_t get(size_t row, size_t column) const {
+        size_t at = base[row] + column;
+        return check[at] == row ? values[at] : defaults[row];
+    }
+
+    // Whether (row, column) was stored rather than defaulted
+    bool stored(size_t row, size_t column) const { return check[base[row] + column] == row; }
+
+    size_t entryCount() const { return stored_count; }
+    size_t bytes() const;
+
+private:
+    static constexpr uint16_t EMPTY = UINT16_MAX;
+
+    std::vector<uint32_t> base;
+    std::vector<int16_t> defaults;
+    std::vector<int16_t> values;
+    std::vector<uint16_t> check;  // Row owning each slot, EMPTY if none
+    size_t stored_count = 0;
+};
+
+class LalrTables {
+public:
+    // Actions: 0 is an error, a positive value shifts to state value - 1 and
+    // a negative one reduces by production -value - 1
+    static constexpr int16_t ERROR = 0;
+
+    // Tables for Mini-C with left-recursive expressions (see
+    // builtinProductions()); built on first use
+    static const LalrTables& builtin();
+
+    // The built-in grammar in LALR form
+    static std::vector<Production> builtinProductions();
+
+    // Tables for sets.grammar, starting at start. Conflicts are reported to
+    // reporter against source (E0304) and make it return nullptr.
+    static std::unique_ptr<LalrTables> build(const FirstFollowSets& sets, NonTerminal start,
+                                             ErrorReporter& reporter, const std::string& source = "");
+
+    int16_t action(uint32_t state, TerminalId lookahead) const { return actions.get(state, lookahead); }
+    // Whether state acts on lookahead itself rather than through its default reduction
+    bool expects(uint32_t state, TerminalId lookahead) const { return actions.stored(state, lookahead); }
+    uint32_t go(uint32_t state, NonTerminal nonterm) const {
+        return static_cast<uint32_t>(gotos.get(static_cast<size_t>(nonterm), state));
+    }
+
+    // Production reduced to accept the input
+    int acceptProduction() const { return accept_production; }
+    NonTerminal lhs(int production) const { return lhs_of[production]; }
+    size_t rhsLength(int production) const { return rhs_length[production]; }
+
+    const FirstFollowSets& getSets() const { return sets; }
+    size_t getStateCount() const { return state_count; }
+    // Size of the compressed tables, and of the same tables stored densely
+    size_t tableBytes() const { return actions.bytes() + gotos.bytes(); }
+    size_t denseTableBytes() const;
+
+private:
+    FirstFollowSets sets;
+    size_t state_count = 0;
+    size_t nonterminal_count = 0;
+    int accept_production = 0;
+    std::vector<NonTerminal> lhs_of;
+    std::vector<uint8_t> rhs_length;
+    CombTable actions;  // State rows, terminal columns; default reductions as row defaults
+    CombTable gotos;    // Non-terminal rows, state columns; the commonest target as default
+
+    explicit LalrTables(FirstFollowSets grammar_sets) : sets(std::move(grammar_sets)) {}
+};
+
+// Parses with LalrTables::builtin(). Shifting a token runs the same
+// ParseActions as the LL(1) parsers, so declarations, scopes and undeclared
+// variables come out the same on valid input; reductions only pop the stack.
+// After a syntax error it skips the input as they do and pops the states of
+// the broken statement, resuming in the innermost open block. Errors are
+// found later than the LL(1) parsers find them, at the state a default
+// reduction leads to, so their diagnostics may differ.
+class LalrParser : private ParseActions {
+public:
+    LalrParser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable,
+               const LalrTables& tables = LalrTables::builtin())
+        : ParseActions(std::move(tokens), reporter, symtable), tables(tables) {}
+
+    LalrParser(TokenStream tokens, CompilationContext& context, const LalrTables& tables = LalrTables::builtin())
+        : LalrParser(std::move(tokens), context.getReporter(), context.getSymbolTable(), tables) {}
+
+    bool parse();
+
+    // Shifts and reductions, and the deepest the state stack got
+    const ParseStats& getStats() const { return stats; }
+
+private:
+    const LalrTables& tables;
+    ParseStats stats;
+
+    // Report the lookahead as unexpected in state
+    void reportUnexpected(uint32_t state);
+
+    // Resume after a syntax error with states cut back to the innermost
+    // open block's; false when there is nowhere to resume
+    bool recover(std::vector<uint32_t>& states);
+};
+
+#endif // LALR_PARSER_H
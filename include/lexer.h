@@ -4,12 +4,17 @@
 #include "token.h"
 #include "error.h"
 #include <string>
+#include <memory>
 #include <unordered_map>
 
+class CompilationContext;
+
 class Lexer {
 private:
-    FILE* source;
-    char* buffer;
+    ErrorReporter& error_reporter;
+    std::string filename;
+    std::shared_ptr<const std::string> source_text;  // Shared with the error reporter
+    const char* buffer;
     size_t buffer_size;
     size_t line;
     size_t column;
@@ -19,12 +24,17 @@ private:
     static const std::unordered_map<std::string, KeywordType> keywords;
 
 public:
+    // Reports to the process-wide errorReporter
     Lexer(std::string filename);
-    ~Lexer();
+    Lexer(const std::string& filename, ErrorReporter& reporter);
+    // Reads the file through the context's source manager and reports to its reporter
+    Lexer(const std::string& filename, CompilationContext& context);
     TokenStream tokenize();
 
 private:
+    void start(std::shared_ptr<const std::string> text);
     void advance();
+    void emit(TokenStream& tokens, Token token);
     void skipWhitespace();
     Token identifier();
     Token number();
@@ -0,0 +1,119 @@
+#ifndef OPERATOR_PRECEDENCE_H
+#define OPERATOR_PRECEDENCE_H
+
+#include "token.h"
+#include <cstdint>
+
+// C operator precedence as binding powers, for the Pratt expression parser
+// in Parser::parse(). An infix operator binds its left operand with left
+// and its right operand with right; left < right makes it left-associative
+// and left > right right-associative. An operand parsed with minimum power
+// m stops at the first infix operator whose left power is below m. Zero
+// means the operator does not appear in that position.
+struct BindingPower {
+    uint8_t left;
+    uint8_t right;
+    uint8_t prefix;
+    uint8_t postfix;
+};
+
+namespace precedence {
+
+constexpr uint8_t COMMA = 2;
+constexpr uint8_t ASSIGNMENT = 4;
+constexpr uint8_t CONDITIONAL = 6;
+constexpr uint8_t LOGICAL_OR = 8;
+constexpr uint8_t LOGICAL_AND = 10;
+constexpr uint8_t BITWISE_OR = 12;
+constexpr uint8_t BITWISE_XOR = 14;
+constexpr uint8_t BITWISE_AND = 16;
+constexpr uint8_t EQUALITY = 18;
+constexpr uint8_t RELATIONAL = 20;
+constexpr uint8_t SHIFT = 22;
+constexpr uint8_t ADDITIVE = 24;
+constexpr uint8_t MULTIPLICATIVE = 26;
+constexpr uint8_t PREFIX = 28;
+constexpr uint8_t POSTFIX = 30;
+
+constexpr BindingPower leftAssociative(uint8_t level) { return {static_cast<uint8_t>(level + 1), static_cast<uint8_t>(level + 2), 0, 0}; }
+constexpr BindingPower rightAssociative(uint8_t level) { return {static_cast<uint8_t>(level + 1), level, 0, 0}; }
+constexpr BindingPower prefixOnly() { return {0, 0, PREFIX, 0}; }
+constexpr BindingPower none() { return {0, 0, 0, 0}; }
+
+constexpr BindingPower withPrefix(BindingPower power) {
+    power.prefix = PREFIX;
+    return power;
+}
+
+// Indexed by OperatorType, in its declaration order
+constexpr BindingPower TABLE[] = {
+    none(),                                   // ARROW: no structs in Mini-C
+    {0, 0, PREFIX, POSTFIX},                  // INC
+    {0, 0, PREFIX, POSTFIX},                  // DEC
+    leftAssociative(SHIFT),                   // SHL
+    leftAssociative(SHIFT),                   // SHR
+    leftAssociative(RELATIONAL),              // LE
+    leftAssociative(RELATIONAL),              // GE
+    leftAssociative(EQUALITY),                // EQ
+    leftAssociative(EQUALITY),                // NE
+    leftAssociative(LOGICAL_AND),             // AND
+    leftAssociative(LOGICAL_OR),              // OR
+    rightAssociative(ASSIGNMENT),             // MUL_ASSIGN
+    rightAssociative(ASSIGNMENT),             // DIV_ASSIGN
+    rightAssociative(ASSIGNMENT),             // MOD_ASSIGN
+    rightAssociative(ASSIGNMENT),             // ADD_ASSIGN
+    rightAssociative(ASSIGNMENT),             // SUB_ASSIGN
+    rightAssociative(ASSIGNMENT),             // SHL_ASSIGN
+    rightAssociative(ASSIGNMENT),             // SHR_ASSIGN
+    rightAssociative(ASSIGNMENT),             // AND_ASSIGN
+    rightAssociative(ASSIGNMENT),             // XOR_ASSIGN
+    rightAssociative(ASSIGNMENT),             // OR_ASSIGN
+    withPrefix(leftAssociative(ADDITIVE)),    // PLUS
+    withPrefix(leftAssociative(ADDITIVE)),    // MINUS
+    leftAssociative(MULTIPLICATIVE),          // STAR: no pointers, so no dereference
+    leftAssociative(MULTIPLICATIVE),          // SLASH
+    leftAssociative(MULTIPLICATIVE),          // PERCENT
+    leftAssociative(RELATIONAL),              // LESS
+    leftAssociative(RELATIONAL),              // GREATER
+    rightAssociative(ASSIGNMENT),             // EQUAL
+    none(),                                   // DOT: no structs in Mini-C
+    leftAssociative(COMMA),                   // COMMA
+    none(),                                   // SEMICOLON
+    none(),                                   // COLON: only inside ?:
+    prefixOnly(),                             // BANG
+    rightAssociative(CONDITIONAL),            // QUESTION: the middle operand runs to the ':'
+    prefixOnly(),                             // TILDE
+    leftAssociative(BITWISE_AND),             // AMPERSAND: no pointers, so no address-of
+    leftAssociative(BITWISE_OR),              // PIPE
+    leftAssociative(BITWISE_XOR),             // CARET
+};
+
+static_assert(sizeof(TABLE) / sizeof(TABLE[0]) == terminal::OPERATOR_COUNT,
+              "every OperatorType has a binding power");
+static_assert(TABLE[static_cast<size_t>(OperatorType::CARET)].left == BITWISE_XOR + 1,
+              "TABLE follows OperatorType's order");
+
+// Binding power of a terminal; none() for anything but an operator
+constexpr BindingPower of(TerminalId id) {
+    return id >= terminal::OPERATOR_BASE && id < terminal::OPERATOR_BASE + terminal::OPERATOR_COUNT
+               ? TABLE[id - terminal::OPERATOR_BASE]
+               : none();
+}
+
+// Minimum power for an operand of a relational operator: it stops at the
+// relational and equality operators, which CONDITION places itself
+constexpr uint8_t RELATIONAL_OPERAND = RELATIONAL + 2;
+
+// Minimum power for a call argument: it stops at the commas between
+// arguments
+constexpr uint8_t ARGUMENT = COMMA + 2;
+
+// Whether a token can start an expression
+constexpr bool startsExpression(TerminalId id) {
+    return id == terminal::IDENTIFIER || id == terminal::INTEGER_LITERAL || id == terminal::FLOAT_LITERAL ||
+           id == terminal::punct(PunctuationType::LPAREN) || of(id).prefix != 0;
+}
+
+}
+
+#endif // OPERATOR_PRECEDENCE_H
@@ -0,0 +1,55 @@
+#ifndef PANIC_MODE_H
+#define PANIC_MODE_H
+
+#include "token.h"
+#include "error.h"
+#include "semantic_actions.h"
+#include <algorithm>
+#include <cstdint>
+
+// Panic-mode recovery from syntax errors, the part every parser shares.
+// After an error, input is skipped to the next ';', '}' or statement keyword
+// (without entering unopened blocks) and a ';' there is consumed; each
+// parser then resumes in the statement list of its innermost open block.
+// Errors found within RECOVERY_TOKENS matched tokens of a recovery are taken
+// to be its cascade and not reported.
+class PanicMode {
+public:
+    // Syntax errors reported before parsing gives up on the rest of the input
+    static constexpr size_t DEFAULT_MAX_ERRORS = 50;
+    // Tokens that must match after a recovery before the next syntax error
+    // is reported
+    static constexpr size_t RECOVERY_TOKENS = 2;
+
+    explicit PanicMode(size_t max_errors = DEFAULT_MAX_ERRORS) : max_errors(max_errors) {}
+
+    void setMaxErrors(size_t count) { max_errors = count; }
+    // Syntax errors reported so far
+    size_t getErrorCount() const { return syntax_errors; }
+
+    // Whether a syntax error found now should be reported; counts it if so
+    bool reportable();
+
+    void tokenMatched() { matched_since_recovery++; }
+    // A finished statement ends any cascade
+    void statementEnded() { matched_since_recovery = std::max(matched_since_recovery, RECOVERY_TOKENS); }
+
+    // A construct that can be followed by the lookahead at position is
+    // missing before it: whether to drop it and carry on from there instead
+    // of recovering. Only once per token, so a run of such errors still
+    // makes progress.
+    bool dropsMissing(size_t position);
+
+    // Skip the input past a syntax error. A half-parsed declaration keeps
+    // its name. False when there is nowhere to resume: at the end of input,
+    // or once too many errors have been reported (E0107).
+    bool resynchronize(TokenStream& tokens, ErrorReporter& reporter, SemanticActions& actions);
+
+private:
+    size_t max_errors;
+    size_t syntax_errors = 0;
+    size_t matched_since_recovery = RECOVERY_TOKENS;
+    size_t resume_position = SIZE_MAX;  // Where the last recovery left the input
+};
+
+#endif // PANIC_MODE_H
@@ -0,0 +1,84 @@
+#ifndef PARALLEL_PARSER_H
+#define PARALLEL_PARSER_H
+
+#include "parser.h"
+
+// Parsing a program's functions concurrently. A pre-scan splits the tokens
+// at function boundaries, TYPE IDENTIFIER ( ... ) and the block after it,
+// through TokenStream's brace index and without parsing. Each function then
+// parses on a worker thread as a program of its own, with its own symbol
+// table, tree and diagnostics: nothing a body declares is visible outside
+// it, so its checks need nothing from the other functions. Afterwards the
+// diagnostics and function tables are merged in source order and the calls
+// checked against the merged table. On syntactically valid input the result
+// is what a sequential Parser::parse() followed by FunctionTable::check()
+// gives; syntax errors are recovered from within their function.
+class ParallelParser {
+public:
+    // Tokens [begin, end) of one function definition
+    struct FunctionSpan {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // Every top-level function of tokens in order, or nothing if tokens are
+    // not a sequence of complete definitions
+    static std::vector<FunctionSpan> findFunctions(const TokenStream& tokens);
+
+    // threads of 0 uses one per hardware thread
+    explicit ParallelParser(unsigned threads = 0);
+
+    // Parse tokens, reporting to reporter, and merge the functions into
+    // symtable's table, then check it. Each function's tokens are moved to
+    // its worker. Input the pre-scan cannot split is parsed sequentially on
+    // the calling thread.
+    bool parse(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable);
+
+    // Trees of the last parse, one per function, or one for the whole
+    // program when it was not split; each is a ProgramNode root in an Ast
+    // shared with the other functions its worker parsed. Token indices are
+    // into the whole stream.
+    size_t getTreeCount() const { return units.size(); }
+    const Ast& getAst(size_t tree) const { return *units[tree]->ast; }
+    NodeRef getRoot(size_t tree) const { return units[tree]->root; }
+
+    // The trees as Ast::dump() renders a sequential parse's; empty if the
+    // parse failed
+    std::string dump() const;
+
+    // Work summed over the functions, with the deepest stack of any
+    const ParseStats& getStats() const { return stats; }
+    // Whether the last parse ran per function
+    bool wasSplit() const { return split; }
+    unsigned getThreadCount() const { return thread_count; }
+
+    // See Parser::setPrattExpressions()
+    void setPrattExpressions(bool enable) { pratt_expressions = enable; }
+
+private:
+    struct Unit {
+        FunctionSpan span;
+        Ast* ast = nullptr;  // The worker's
+        NodeRef root;
+        ErrorReporter reporter;
+        SymbolTable symbols;
+        ParseStats stats;
+        bool success = false;
+    };
+
+    unsigned thread_count;
+    bool pratt_expressions = false;
+    std::vector<std::unique_ptr<Unit>> units;
+    // One per worker: a function's nodes would fill a fraction of the chunk
+    // every node pool starts with
+    std::vector<std::unique_ptr<Ast>> trees;
+    ParseStats stats;
+    bool split = false;
+    bool success = false;
+
+    // Parse unit's tokens, taken from the whole stream tokens, into ast;
+    // runs on a worker
+    void parseFunction(Unit& unit, TokenStream& tokens, Ast& ast) const;
+};
+
+#endif // PARALLEL_PARSER_H
@@ -0,0 +1,177 @@
+#ifndef PARSE_ACTIONS_H
+#define PARSE_ACTIONS_H
+
+#include "parser.h"
+
+// Token handling and error recovery of Parser::parse(), for the parsers that
+// decide productions in code instead of through the table (GeneratedParser,
+// RecursiveDescentParser, LalrParser). Their semantic actions are the same
+// SemanticActions that Parser::parse() runs, and their recovery the same
+// PanicMode, so every parser's diagnostics and symbol-table effects are
+// identical.
+class ParseActions {
+protected:
+    ParseActions(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable)
+        : tokens(std::move(tokens)), error_reporter(reporter), symbol_table(symtable),
+          actions(reporter, symtable) {
+        this->tokens.reset();
+        current_token = &this->tokens.peek();
+    }
+
+    TokenStream tokens;
+    ErrorReporter& error_reporter;
+    SymbolTable& symbol_table;
+    SemanticActions actions;
+    PanicMode panic;
+    Token* current_token = nullptr;
+
+    // Checks the stream and opens the global scope; false if parsing cannot start
+    bool begin();
+    TerminalId lookahead() const { return current_token->terminal; }
+    TerminalId peekNext();  // Terminal after the lookahead
+    void advance();
+
+    // Called when a non-terminal is expanded
+    void onNonTerminal(NonTerminal nonterm);
+    bool defaultsToEmpty(NonTerminal nonterm) const;
+
+    // Match the expected terminal and run its action, or report it missing
+    // and leave the lookahead in place
+    bool match(Symbol expected);
+
+    // End of file expected after the start symbol; true if the whole parse
+    // succeeded
+    bool finish();
+
+    // No production for nonterm on the lookahead; expected lists the tokens
+    // that have one. True when the lookahead can follow nonterm, which is
+    // then taken to be missing and dropped in place; otherwise the caller
+    // recovers.
+    bool noProduction(NonTerminal nonterm, const char* name, const char* expected);
+    bool noProduction(NonTerminal nonterm);
+
+    // Skip the input past a syntax error (see PanicMode); false when there
+    // is nowhere to resume
+    bool resynchronize();
+
+    // Resume after a syntax error as Parser::parse() does, with stack cut
+    // back to the innermost STATEMENT_LIST whose block is open. missing, if
+    // given, is the terminal that failed to match.
+    bool recover(std::vector<Symbol>& stack, Symbol missing = terminal::END_OF_FILE);
+};
+
+inline bool ParseActions::begin() {
+    return actions.begin(tokens);
+}
+
+inline TerminalId ParseActions::peekNext() {
+    if (tokens.isAtEnd()) {
+        return terminal::END_OF_FILE;
+    }
+    tokens.advance();
+    TerminalId next = tokens.peek().terminal;
+    tokens.rewind();
+    return next;
+}
+
+inline void ParseActions::advance() {
+    tokens.advance();
+    current_token = &tokens.peek();
+    panic.tokenMatched();
+}
+
+inline void ParseActions::onNonTerminal(NonTerminal nonterm) {
+    if (nonterm == NonTerminal::DECLARATION) {
+        actions.declarationBegins();
+    }
+}
+
+// Statement lists end at any token that cannot start a statement; the error,
+// if any, is then reported against the '}' that was expected instead
+inline bool ParseActions::defaultsToEmpty(NonTerminal nonterm) const {
+    return nonterm == NonTerminal::STATEMENT_LIST || nonterm == NonTerminal::STATEMENT;
+}
+
+inline bool ParseActions::match(Symbol expected) {
+    const Token& token = *current_token;
+    if (!matchesTerminal(token, expected)) {
+        if (panic.reportable()) {
+            reportExpectedTerminal(error_reporter, token, expected);
+        }
+        return false;
+    }
+
+    actions.terminalMatched(expected, tokens, tokens.position());
+    if (expected == terminal::op(OperatorType::SEMICOLON)) {
+        panic.statementEnded();
+    }
+    advance();
+    return true;
+}
+
+inline bool ParseActions::finish() {
+    if (current_token->type != TokenType::Eof) {
+        if (panic.reportable()) {
+            error_reporter.report(diag::ExpectedEndOfFile{}, current_token->loc, current_token->lexeme);
+        }
+        return false;
+    }
+    return panic.getErrorCount() == 0;
+}
+
+inline bool ParseActions::noProduction(NonTerminal nonterm, const char* name, const char* expected) {
+    if (panic.reportable()) {
+        error_reporter.report(diag::NoProduction{}, current_token->loc, current_token->lexeme,
+                              tokenTypeToString(current_token->type), name, expected);
+    }
+    return LL1Grammar::builtin().canFollow(nonterm, current_token->terminal) &&
+           panic.dropsMissing(tokens.position());
+}
+
+inline bool ParseActions::noProduction(NonTerminal nonterm) {
+    // Same list as Parser::reportParseError()
+    std::string expected;
+    for (const auto& entry : LL1Grammar::builtin().getParseTable().at(nonterm)) {
+        if (!expected.empty()) {
+            expected += ", ";
+        }
+        expected += '\'';
+        expected += entry.first;
+        expected += '\'';
+    }
+    return noProduction(nonterm, nonTerminalToString(nonterm).c_str(), expected.c_str());
+}
+
+inline bool ParseActions::resynchronize() {
+    bool resumed = panic.resynchronize(tokens, error_reporter, actions);
+    current_token = &tokens.peek();
+    return resumed;
+}
+
+inline bool ParseActions::recover(std::vector<Symbol>& stack, Symbol missing) {
+    if (missing == terminal::punct(PunctuationType::LBRACE)) {
+        // The block stays unopened, so recovery skips past its statements
+        stack.push_back(missing);
+    } else if (missing == terminal::punct(PunctuationType::RBRACE)) {
+        // Something that cannot start a statement ended the list early; the
+        // block is still open
+        stack.push_back(missing);
+        stack.push_back(symbol::nt(NonTerminal::STATEMENT_LIST));
+    }
+    if (!resynchronize()) {
+        return false;
+    }
+
+    // A STATEMENT_LIST still under its '{' belongs to a block never opened
+    size_t resume = stack.size();
+    while (resume-- > 0) {
+        if (stack[resume] == symbol::nt(NonTerminal::STATEMENT_LIST) &&
+            !(resume + 1 < stack.size() && stack[resume + 1] == terminal::punct(PunctuationType::LBRACE))) {
+            stack.resize(resume + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // PARSE_ACTIONS_H
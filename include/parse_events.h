@@ -0,0 +1,71 @@
+#ifndef PARSE_EVENTS_H
+#define PARSE_EVENTS_H
+
+#include "symbol_table.h"
+#include "token.h"
+#include <cstdint>
+
+// Callbacks Parser::parse(handler) makes as it completes built-in grammar
+// constructs. Events arrive in post-order, like a SAX stream: operands
+// before their operator, a statement's expressions before the statement,
+// so a handler can evaluate or build with a plain stack. Each event gets
+// the construct's main token and that token's index in the stream.
+//
+// Handlers derive from ParseEvents and redeclare only the callbacks they
+// need. parse() is a template over the handler, so every call resolves
+// statically and the empty defaults compile to nothing.
+struct ParseEvents {
+    // TYPE name ( ... after the name, with the return type; and after the
+    // closing '}'. The parameters and the body's statements arrive in between.
+    void onFunctionBegin(SymbolType /*type*/, const Token& /*name*/, uint32_t /*index*/) {}
+    void onFunctionEnd(const Token& /*name*/, uint32_t /*index*/) {}
+
+    // TYPE name, after the name
+    void onParameter(SymbolType /*type*/, const Token& /*name*/, uint32_t /*index*/) {}
+
+    // After the ';'; the initializer, if any, was the last expression
+    void onDeclaration(SymbolType /*type*/, const Token& /*name*/, uint32_t /*index*/, bool /*has_initializer*/) {}
+
+    // After the ';'; the assigned value was the last expression
+    void onAssignment(const Token& /*name*/, uint32_t /*index*/) {}
+
+    // After "while"; and after the body's '}'. The condition and the body's
+    // statements arrive in between.
+    void onLoopBegin(const Token& /*keyword*/, uint32_t /*index*/) {}
+    void onLoopEnd(const Token& /*keyword*/, uint32_t /*index*/) {}
+
+    void onReturn(const Token& /*keyword*/, uint32_t /*index*/) {}
+    void onExpressionStatement(const Token& /*first*/, uint32_t /*index*/) {}
+
+    // Binary arithmetic or relational operator, after both operands
+    void onExpressionOperator(const Token& /*op*/, uint32_t /*index*/) {}
+
+    // Postfix ++ or --, after its operand
+    void onIncrement(const Token& /*op*/, uint32_t /*index*/) {}
+
+    // With Pratt expressions only (Parser::setPrattExpressions()): a prefix
+    // operator after its operand, and ?: after all three operands
+    void onUnaryOperator(const Token& /*op*/, uint32_t /*index*/) {}
+    void onConditional(const Token& /*question*/, uint32_t /*index*/) {}
+
+    // name ( ... after the '('; and after the ')'. The callee has just
+    // arrived as an identifier; the arguments arrive in between.
+    void onCallBegin(const Token& /*name*/, uint32_t /*index*/) {}
+    void onCall(const Token& /*name*/, uint32_t /*index*/) {}
+
+    // Operands
+    void onIdentifier(const Token& /*name*/, uint32_t /*index*/) {}
+    void onIntegerLiteral(const Token& /*literal*/, uint32_t /*index*/) {}
+    void onFloatLiteral(const Token& /*literal*/, uint32_t /*index*/) {}
+
+    // Incremental reparsing (see IncrementalParser). Only handlers that set
+    // REUSES_STATEMENTS hear where statements start and end, at any depth.
+    // onStatementBegin may hand over a statement it already has for the
+    // tokens from index on: it returns their end, and the parser skips them
+    // after replaying their declarations and uses. 0 has the statement parsed.
+    static constexpr bool REUSES_STATEMENTS = false;
+    uint32_t onStatementBegin(uint32_t /*index*/) { return 0; }
+    void onStatementEnd(uint32_t /*begin*/, uint32_t /*end*/) {}
+};
+
+#endif // PARSE_EVENTS_H
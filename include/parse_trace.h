@@ -0,0 +1,125 @@
+#ifndef PARSE_TRACE_H
+#define PARSE_TRACE_H
+
+#include "token.h"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class FirstFollowSets;
+
+// Step-by-step trace of Parser::parse(). The trace is a template policy of
+// parse(): NoTrace records nothing and every call to it compiles away, so the
+// untraced parser carries no trace branches; RingTrace appends fixed-size
+// binary records to a ring buffer, and TraceDecoder turns them into text
+// afterwards, in process or offline from a saved file.
+
+enum class TraceEvent : uint8_t {
+    Start,       // value: 1 if the token stream is empty
+    Expand,      // value: non-terminal on top of the stack
+    Choice,      // value: TraceChoice, for the hand-decided non-terminals
+    Production,  // value: production pushed from the table
+    Match,       // value: terminal matched
+    Capture,     // Identifier captured for a declaration
+    Declare,     // value: SymbolType; token: the declared identifier
+    Recover,     // Resumed after a syntax error
+};
+
+// How parse() decided STATEMENT_LIST and STATEMENT without the table
+enum class TraceChoice : uint8_t {
+    ListEndsAtBrace,
+    ListContinues,
+    ListEnds,
+    Declaration,
+    Assignment,
+    ExpressionStatement,
+    Loop,
+    Return,
+    NoStatement,
+};
+
+// token is the index of the lookahead in the parsed TokenStream unless the
+// event says otherwise
+struct TraceRecord {
+    uint32_t token;
+    uint16_t value;
+    TraceEvent event;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(TraceRecord) == 8, "trace records are 8 bytes");
+
+// Trace policy that records nothing
+struct NoTrace {
+    static constexpr bool ENABLED = false;
+    void record(TraceEvent, uint16_t, uint32_t) {}
+};
+
+// Trace policy that keeps the last 2^capacity_log2 records; older ones are
+// overwritten and counted in dropped()
+class RingTrace {
+public:
+    static constexpr bool ENABLED = true;
+
+    explicit RingTrace(unsigned capacity_log2 = 16)
+        : records(new TraceRecord[size_t(1) << capacity_log2]), mask((size_t(1) << capacity_log2) - 1) {}
+
+    void record(TraceEvent event, uint16_t value, uint32_t token) {
+        records[written++ & mask] = TraceRecord{token, value, event, 0};
+    }
+
+    size_t capacity() const { return mask + 1; }
+    size_t size() const { return written < capacity() ? static_cast<size_t>(written) : capacity(); }
+    uint64_t dropped() const { return written - size(); }
+    void clear() { written = 0; }
+
+    // Held records, oldest first
+    std::vector<TraceRecord> snapshot() const;
+
+    // Write the held records to path in the binary format read by load();
+    // builtin_grammar tells the decoder it may name non-terminals and
+    // productions. False if the file cannot be written.
+    bool save(const std::string& path, bool builtin_grammar) const;
+
+private:
+    std::unique_ptr<TraceRecord[]> records;
+    size_t mask;
+    uint64_t written = 0;
+};
+
+// A trace read back from a file written by RingTrace::save()
+struct SavedTrace {
+    bool builtin_grammar = false;
+    uint64_t dropped = 0;
+    std::vector<TraceRecord> records;
+
+    // False if path is missing or not a trace file
+    bool load(const std::string& path);
+};
+
+// Renders trace records as the text parse() used to print with
+// --show-parse-steps. Names come from sets and lexemes from tokens when they
+// are given; without them, non-terminals, productions and tokens are shown
+// by number and terminals by their grammar spelling.
+class TraceDecoder {
+public:
+    explicit TraceDecoder(const FirstFollowSets* sets = nullptr, const TokenStream* tokens = nullptr)
+        : sets(sets), tokens(tokens) {}
+
+    // Text for one record: zero or more lines, each ending in '\n'
+    std::string decode(const TraceRecord& record) const;
+
+    // Every record, preceded by a note if older ones were dropped
+    void print(const std::vector<TraceRecord>& records, uint64_t dropped, std::ostream& out) const;
+
+private:
+    const FirstFollowSets* sets;
+    const TokenStream* tokens;
+
+    std::string lexeme(uint32_t token, TerminalId fallback) const;
+    std::string nonTerminalName(uint16_t nonterm) const;
+};
+
+#endif // PARSE_TRACE_H
@@ -5,6 +5,13 @@
 #include "lexer.h"
 #include "error.h"
 #include "symbol_table.h"
+#include "semantic_actions.h"
+#include "panic_mode.h"
+#include "compilation_context.h"
+#include "grammar.h"
+#include "ast.h"
+#include "parse_trace.h"
+#include "operator_precedence.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -13,53 +20,8 @@
 #include <map>
 #include <set>
 #include <stack>
-
-// Non-terminal symbols in our grammar
-enum class NonTerminal {
-    PROGRAM,
-    MAIN_FUNCTION,
-    STATEMENT_LIST,
-    STATEMENT,
-    DECLARATION,
-    DECLARATION_TAIL,
-    TYPE,
-    ASSIGNMENT,
-    LOOP,
-    CONDITION,
-    RELATIONAL_OP,
-    RETURN_STMT,
-    EXPRESSION,
-    EXPRESSION_TAIL,
-    TERM,
-    TERM_TAIL,
-    FACTOR,
-    FACTOR_TAIL
-};
-
-// String representation for NonTerminals (for debugging)
-inline std::string nonTerminalToString(NonTerminal nt) {
-    switch (nt) {
-        case NonTerminal::PROGRAM: return "PROGRAM";
-        case NonTerminal::MAIN_FUNCTION: return "MAIN_FUNCTION";
-        case NonTerminal::STATEMENT_LIST: return "STATEMENT_LIST";
-        case NonTerminal::STATEMENT: return "STATEMENT";
-        case NonTerminal::DECLARATION: return "DECLARATION";
-        case NonTerminal::DECLARATION_TAIL: return "DECLARATION_TAIL";
-        case NonTerminal::TYPE: return "TYPE";
-        case NonTerminal::ASSIGNMENT: return "ASSIGNMENT";
-        case NonTerminal::LOOP: return "LOOP";
-        case NonTerminal::CONDITION: return "CONDITION";
-        case NonTerminal::RELATIONAL_OP: return "RELATIONAL_OP";
-        case NonTerminal::RETURN_STMT: return "RETURN_STMT";
-        case NonTerminal::EXPRESSION: return "EXPRESSION";
-        case NonTerminal::EXPRESSION_TAIL: return "EXPRESSION_TAIL";
-        case NonTerminal::TERM: return "TERM";
-        case NonTerminal::TERM_TAIL: return "TERM_TAIL";
-        case NonTerminal::FACTOR: return "FACTOR";
-        case NonTerminal::FACTOR_TAIL: return "FACTOR_TAIL";
-        default: return "UNKNOWN";
-    }
-}
+#include <memory>
+#include <cstdint>
 
 // Production rule representation A -> aBc | e
 struct Production {
@@ -71,6 +33,9 @@ struct Production {
         : lhs(left), rhs(right) {}
 };
 
+// Name of a token type as used in diagnostics, e.g. "Identifier"
+std::string tokenTypeToString(TokenType type);
+
 // Special epsilon symbol
 const std::string EPSILON = "ε";
 
@@ -81,15 +46,30 @@ public:
     std::map<NonTerminal, std::set<std::string>> first_sets;
     std::map<NonTerminal, std::set<std::string>> follow_sets;
     
+    // Names of non-terminals by index, for grammars loaded from a file;
+    // empty for the built-in grammar
+    std::vector<std::string> nonterminal_names;
+    
+    // Views of the compile-time grammar tables in GRAMMAR_TABLES
     FirstFollowSets();
     
+    // Arbitrary grammar; the sets are computed at run time
+    explicit FirstFollowSets(std::vector<Production> productions);
+    
+    // Grammar with precomputed sets, e.g. from a grammar table cache
+    FirstFollowSets(std::vector<Production> productions, std::vector<std::string> names,
+                    const bool* nullable, const TerminalSet* first, const TerminalSet* follow);
+    
+    // Shared instance for the built-in grammar; built on first use
+    static const FirstFollowSets& builtin();
+    
     // Add production to grammar
     void addProduction(const Production& prod);
     
     // Initialize the grammar with our language rules
     void initializeGrammar();
     
-    // Initialize the FIRST sets for all non-terminals
+    // Recompute the sets from grammar at run time
     void computeFirstSets();
     
     // Calculate FIRST for a specific symbol (terminal, non-terminal, or token type)
@@ -107,8 +87,36 @@ public:
     // Get string representation of a token type
     std::string getTokenTypeString(TokenType type) const;
     
+    // Display name of a non-terminal in this grammar
+    std::string nameOf(NonTerminal nt) const;
+    
+    // Production with token classes as TokenType and other terminals by spelling
+    static Production toProduction(NonTerminal lhs, const Symbol* rhs, size_t length);
+    // The reverse: the right-hand side as Symbols, empty for epsilon
+    static std::vector<Symbol> toSymbols(const Production& production);
+    
     // Helper method for debugging
     void printSets() const;
+
+private:
+    // Bit-level form of the grammar used by computeFirstSets()/computeFollowSets().
+    // Terminals are interned to bit positions; every set is set_words wide and
+    // the tables are non-terminal-major.
+    static constexpr uint32_t NONTERMINAL_BIT = 0x80000000u;
+    
+    std::vector<std::string> terminal_names;  // Bit position -> spelling
+    std::unordered_map<std::string, uint32_t> terminal_bits;
+    std::vector<uint32_t> encoded_symbols;    // Right-hand sides, epsilon dropped
+    std::vector<uint32_t> encoded_offsets;    // Production p is [offsets[p], offsets[p + 1])
+    size_t nonterminal_count = 0;
+    size_t set_words = 0;
+    std::vector<bool> nullable;
+    std::vector<uint64_t> first_bits;
+    std::vector<uint64_t> follow_bits;
+    
+    uint32_t internTerminal(const std::string& spelling);
+    void encodeGrammar();
+    void assignSets(size_t count, const bool* nullable, const TerminalSet* first, const TerminalSet* follow);
 };
 
 // Parsing table entry type
@@ -117,52 +125,246 @@ struct ParseTableEntry {
     const Production* production;
 };
 
+using ParseTableMap = std::map<NonTerminal, std::map<std::string, ParseTableEntry>>;
+
+// Right-hand sides in the order Parser pushes them: reversed, so a
+// production goes onto the parse stack as one copy with its first symbol on
+// top. Event markers (see symbol::event()) may sit among the symbols; the
+// tokens they name, as offsets past the lookahead, are listed bottom to top.
+struct PushTable {
+    std::vector<Symbol> symbols;
+    std::vector<uint32_t> offsets;        // Production p is [offsets[p], offsets[p + 1])
+    std::vector<uint8_t> token_offsets;   // One per event marker
+    std::vector<uint32_t> event_offsets;  // Production p's are [event_offsets[p], event_offsets[p + 1])
+    
+    const Symbol* begin(int production) const { return symbols.data() + offsets[production]; }
+    const Symbol* end(int production) const { return symbols.data() + offsets[production + 1]; }
+};
+
+// A grammar together with its LL(1) prediction table: either the built-in
+// Mini-C grammar, whose tables are compile-time constants, or one loaded from
+// a BNF file in the format of src/grammar.txt. Read-only once built, so one
+// instance can be shared by parsers on several threads.
+class LL1Grammar {
+public:
+    static const LL1Grammar& builtin();
+    
+    // Load a grammar file. Compiled tables are cached in path + ".cache" and
+    // reused while the file's hash matches. Returns nullptr after reporting
+    // an error to reporter.
+    static std::unique_ptr<LL1Grammar> load(const std::string& path, ErrorReporter& reporter,
+                                            bool use_cache = true);
+    
+    // Production to expand nonterm with on the given lookahead, or -1
+    int predict(NonTerminal nonterm, TerminalId lookahead) const {
+        size_t row = static_cast<size_t>(nonterm);
+        return row < nonterminal_count ? predict_rows[row * terminal::COUNT + lookahead] : -1;
+    }
+    
+    // Right-hand side of a production with every terminal resolved to its
+    // TerminalId when the grammar was built; empty for epsilon
+    const Symbol* rhs(int production) const { return rhs_symbols.data() + rhs_offsets[production]; }
+    size_t rhsLength(int production) const { return rhs_offsets[production + 1] - rhs_offsets[production]; }
+    
+    // The same right-hand sides reversed for pushing, without events
+    const PushTable& getPushTable() const { return pushes; }
+    
+    // Whether lookahead is in FOLLOW(nonterm)
+    bool canFollow(NonTerminal nonterm, TerminalId lookahead) const {
+        size_t row = static_cast<size_t>(nonterm);
+        return row < nonterminal_count && follow_rows[row].contains(lookahead);
+    }
+    
+    const FirstFollowSets& getSets() const { return sets; }
+    const ParseTableMap& getParseTable() const { return parse_table; }
+    size_t getNonTerminalCount() const { return nonterminal_count; }
+    
+    // Whether the last load() was served from the cache
+    bool loadedFromCache() const { return from_cache; }
+
+private:
+    FirstFollowSets sets;
+    size_t nonterminal_count;
+    const int16_t* predict_rows;        // nonterminal_count rows of terminal::COUNT
+    std::vector<int16_t> owned_predict;  // Storage for loaded grammars
+    const TerminalSet* follow_rows;     // nonterminal_count FOLLOW sets
+    std::vector<TerminalSet> owned_follow;
+    std::vector<Symbol> rhs_symbols;    // Every production's right-hand side, back to back
+    std::vector<uint32_t> rhs_offsets;  // Production p is [offsets[p], offsets[p + 1])
+    PushTable pushes;
+    ParseTableMap parse_table;          // String-keyed view for printing and diagnostics
+    bool from_cache = false;
+    
+    // The built-in grammar borrows GRAMMAR_TABLES; loaded grammars own their rows
+    LL1Grammar(FirstFollowSets grammar_sets, const int16_t* rows, const TerminalSet* follow, size_t count);
+    LL1Grammar(FirstFollowSets grammar_sets, std::vector<int16_t> rows, std::vector<TerminalSet> follow,
+               size_t count);
+    void buildParseTableView();
+    void resolveProductions();
+};
+
+// Work done by one Parser::parse() call
+struct ParseStats {
+    size_t steps = 0;            // Stack operations: matches, expansions, epsilon pops and AST reductions
+    size_t max_stack_depth = 0;
+};
+
+// Kinds of ParseEvents callback Parser schedules on its stack
+enum class ParseEventKind : uint8_t {
+    FunctionBegin,
+    FunctionEnd,
+    Parameter,
+    Declaration,
+    Assignment,
+    LoopBegin,
+    LoopEnd,
+    Return,
+    ExpressionStatement,
+    Operator,
+    RelationalOperator,  // Resolved to the condition's RELATIONAL_OP when fired
+    Increment,
+    Unary,
+    Conditional,
+    CallBegin,  // Both name the '(' and are resolved to the callee before it when fired
+    Call,
+    Identifier,
+    IntegerLiteral,
+    FloatLiteral,
+    StatementEnd,  // Only for handlers with REUSES_STATEMENTS
+};
+
+// Whether token is the terminal expected. "main" is contextual: the lexer
+// emits it as an identifier, so only that one terminal looks at the spelling.
+inline bool matchesTerminal(const Token& token, TerminalId expected) {
+    return expected == terminal::MAIN ? token.terminal == terminal::IDENTIFIER && token.lexeme == "main"
+                                      : token.terminal == expected;
+}
+
+// Type named by an int or float keyword
+inline SymbolType typeOf(const Token& keyword) {
+    return keyword.terminal == terminal::keyword(KeywordType::Int) ? SymbolType::INT : SymbolType::FLOAT;
+}
+
+// Report that expected was missing at token
+void reportExpectedTerminal(ErrorReporter& reporter, const Token& token, TerminalId expected);
+
+// Where a production's event goes: after its first `after` right-hand-side
+// symbols (END for after all of them), naming the token token_offset past
+// the lookahead the production was chosen on
+struct EventSlot {
+    static constexpr uint8_t END = UINT8_MAX;
+    static constexpr size_t MAX_PER_PRODUCTION = 2;
+
+    uint8_t after;
+    ParseEventKind kind;
+    uint32_t token_offset;
+};
+
 // Top-down parser for Mini-C
 class Parser {
+public:
+    // Syntax errors reported before parse() gives up on the rest of the input
+    static constexpr size_t DEFAULT_MAX_ERRORS = PanicMode::DEFAULT_MAX_ERRORS;
+    // Ring size, as a power of two, for the steps setVerbose() prints
+    static constexpr unsigned VERBOSE_TRACE_LOG2 = 20;
+
 private:
     TokenStream tokens;
     ErrorReporter& error_reporter;
     SymbolTable& symbol_table;
-    FirstFollowSets first_follow;
+    const LL1Grammar& grammar;
+    const FirstFollowSets& first_follow;
     Token* current_token;
     bool verbose; // Control debugging output
+    size_t max_errors;
+    bool pratt_expressions = false;
+    ParseStats stats;
     
-    // Productions for grammar initialization
-    std::vector<Production> productions;
+    // The tree goes into the compilation's arena when there is one
+    std::unique_ptr<Ast> owned_ast;
+    Ast* ast;
     
-    // LL(1) parsing table
-    std::map<NonTerminal, std::map<std::string, ParseTableEntry>> parse_table;
+    // LL(1) parsing table by terminal spelling, for printing and diagnostics;
+    // parse() predicts through grammar.predict()
+    const ParseTableMap& parse_table;
     
-    // Helper function to get token representation for parsing table
-    std::string getTokenKey(const Token& token);
-    
-    // Check if a token matches expected type or lexeme
-    bool matchToken(const std::variant<std::string, TokenType>& expected);
+    // Whether the lookahead is the terminal expected
+    bool matchToken(TerminalId expected) const { return matchesTerminal(*current_token, expected); }
     
     // Error reporting
-    void syntaxError(const std::string& message);
     void reportParseError(NonTerminal nonterm);
     
-    // Initialize grammar with productions
-    void initGrammar();
+    Parser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable, Ast* ast,
+           const LL1Grammar& grammar);
+    
+    // Events of the built-in production chosen for nonterm on lookahead
+    static size_t builtinEvents(NonTerminal nonterm, TerminalId lookahead, EventSlot* slots);
+    // The built-in grammar's pushes with its events placed; built on first use
+    static const PushTable& builtinEventPushes();
+    
+    // Call handler for an event marker popped off the stack, naming token index
+    template <typename Handler>
+    void fireEvent(Handler& handler, ParseEventKind kind, uint32_t index, uint32_t relational_op);
+    
+    template <typename Trace>
+    bool buildAst(Trace& trace);
 
 public:
-    Parser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable);
+    Parser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable,
+           const LL1Grammar& grammar = LL1Grammar::builtin());
+    // Uses the context's reporter, symbol table and AST
+    Parser(TokenStream tokens, CompilationContext& context,
+           const LL1Grammar& grammar = LL1Grammar::builtin());
     
-    // Build the parsing table
-    void buildParseTable();
-    
-    // Parse the entire program
+    // Parse the entire program, building getAst(). After a syntax error the
+    // parser resynchronizes and carries on, so one call reports every
+    // independent error; it still returns false.
     bool parse();
     
+    // Parse the entire program, reporting what it contains to handler (see
+    // ParseEvents) instead of building a tree. Only the built-in grammar
+    // produces events, and they stop at the first syntax error.
+    template <typename Handler>
+    bool parse(Handler& handler);
+    
+    // Either of the above, recording every step into trace, a policy from
+    // parse_trace.h. With NoTrace the steps cost nothing; setVerbose()
+    // parses through a RingTrace and prints it afterwards.
+    template <typename Handler, typename Trace>
+    bool parse(Handler& handler, Trace& trace);
+    bool parseTraced(RingTrace& trace);
+    
     // For testing purposes
     const FirstFollowSets& getFirstFollowSets() const;
+    const ParseTableMap& getParseTable() const { return parse_table; }
+    const ParseStats& getStats() const { return stats; }
+    
+    // Tree built by the last successful parse(). Only the built-in grammar
+    // has node-building reductions; other grammars leave it empty.
+    const Ast& getAst() const { return *ast; }
+    
+    // Production to expand nonterm with on the given lookahead, or -1
+    int predict(NonTerminal nonterm, TerminalId lookahead) const {
+        return grammar.predict(nonterm, lookahead);
+    }
     
     // Print parsing table (for debugging)
     void printParseTable() const;
     
     // Enable or disable verbose debugging output
     void setVerbose(bool enable);
+    
+    // Cap on the syntax errors one parse() reports
+    void setMaxErrors(size_t count) { max_errors = count; }
+    
+    // Parse EXPRESSION and CONDITION by precedence climbing over every C
+    // operator (see operator_precedence.h) instead of through the
+    // EXPRESSION_TAIL/TERM_TAIL productions. The language grows to unary,
+    // bitwise, logical, conditional and assignment operators. Only the
+    // built-in grammar has these non-terminals; other grammars ignore it.
+    void setPrattExpressions(bool enable) { pratt_expressions = enable; }
 };
 
+#include "parser_impl.h"
+
 #endif // PARSER_H
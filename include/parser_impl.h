@@ -0,0 +1,613 @@
+#ifndef PARSER_IMPL_H
+#define PARSER_IMPL_H
+
+// Definitions of Parser's handler templates; included by parser.h
+
+#include <iostream>
+
+template <typename Handler>
+bool Parser::parse(Handler& handler) {
+    if (!verbose) {
+        NoTrace untraced;
+        return parse(handler, untraced);
+    }
+    
+    // Record the steps, then print them
+    RingTrace trace(VERBOSE_TRACE_LOG2);
+    bool result = parse(handler, trace);
+    TraceDecoder(&first_follow, &tokens).print(trace.snapshot(), trace.dropped(), std::cout);
+    return result;
+}
+
+template <typename Handler, typename Trace>
+bool Parser::parse(Handler& handler, Trace& trace) {
+    if constexpr (Trace::ENABLED) {
+        trace.record(TraceEvent::Start, tokens.isAtEnd(), static_cast<uint32_t>(tokens.position()));
+    }
+    
+    // Scopes, declarations and uses, as in every other parser; also checks
+    // there is something to parse and opens the global scope
+    SemanticActions actions(error_reporter, symbol_table);
+    if (!actions.begin(tokens)) {
+        return false;
+    }
+    
+    // Events are placed for the built-in productions only
+    bool emit_events = &grammar == &LL1Grammar::builtin();
+    const PushTable& pushes = emit_events ? builtinEventPushes() : grammar.getPushTable();
+    
+    // Initialize parse stack with EOF marker and start symbol. Event markers
+    // on it take their tokens from event_tokens, in the same order.
+    std::vector<Symbol> parse_stack;
+    std::vector<uint32_t> event_tokens;
+    parse_stack.push_back(terminal::END_OF_FILE); // EOF marker at bottom of stack
+    parse_stack.push_back(symbol::nt(NonTerminal::PROGRAM)); // Start symbol
+    
+    uint32_t relational_op = 0;  // Index of the last RELATIONAL_OP; conditions never nest
+    PanicMode panic(max_errors);  // See recover below
+    
+    auto consume = [&]() {
+        tokens.advance();
+        current_token = &tokens.peek();
+        panic.tokenMatched();
+    };
+    auto schedule = [&](ParseEventKind kind) {
+        if (emit_events) {
+            parse_stack.push_back(symbol::event(static_cast<uint8_t>(kind)));
+            event_tokens.push_back(static_cast<uint32_t>(tokens.position()));
+        }
+    };
+    
+    auto traceChoice = [&](TraceChoice choice) {
+        if constexpr (Trace::ENABLED) {
+            trace.record(TraceEvent::Choice, static_cast<uint16_t>(choice), static_cast<uint32_t>(tokens.position()));
+        }
+    };
+    
+    // Declaration names are traced where they are captured and entered
+    auto terminalMatched = [&](TerminalId matched) {
+        if constexpr (Trace::ENABLED) {
+            if (matched == terminal::op(OperatorType::SEMICOLON) && actions.hasDeclaredName()) {
+                trace.record(TraceEvent::Declare, static_cast<uint16_t>(actions.getDeclaredType()),
+                             actions.getDeclaredIndex());
+            }
+        }
+        actions.terminalMatched(matched, tokens, tokens.position());
+        if constexpr (Trace::ENABLED) {
+            if (matched == terminal::IDENTIFIER && actions.hasDeclaredName() &&
+                actions.getDeclaredIndex() == tokens.position()) {
+                trace.record(TraceEvent::Capture, 0, actions.getDeclaredIndex());
+            }
+        }
+        if (matched == terminal::op(OperatorType::SEMICOLON)) {
+            panic.statementEnded();
+        }
+    };
+    
+    // Resume after a syntax error. Input is skipped to a ';', '}' or
+    // statement keyword, a ';' is consumed, and the stack is cut back to the
+    // innermost STATEMENT_LIST whose block is open, so parsing picks up at the
+    // next statement. Returns false when there is nowhere to resume or too
+    // many errors have been reported.
+    auto recover = [&]() {
+        bool resumed = panic.resynchronize(tokens, error_reporter, actions);
+        current_token = &tokens.peek();
+        if (!resumed) {
+            return false;
+        }
+        
+        // A STATEMENT_LIST still under its '{' belongs to a block that was
+        // never opened
+        size_t resume = parse_stack.size();
+        size_t cut_events = 0;
+        while (resume-- > 0) {
+            if (parse_stack[resume] == symbol::nt(NonTerminal::STATEMENT_LIST) &&
+                !(resume + 1 < parse_stack.size() && parse_stack[resume + 1] == terminal::punct(PunctuationType::LBRACE))) {
+                break;
+            }
+            cut_events += symbol::isEvent(parse_stack[resume]);
+        }
+        if (resume == SIZE_MAX) {
+            return false;
+        }
+        parse_stack.resize(resume + 1);
+        event_tokens.resize(event_tokens.size() - cut_events);
+        
+        if constexpr (Trace::ENABLED) {
+            trace.record(TraceEvent::Recover, 0, static_cast<uint32_t>(tokens.position()));
+        }
+        return true;
+    };
+    
+    // Precedence climbing for EXPRESSION and CONDITION (see
+    // setPrattExpressions()). One frame per operand and one loop turn per
+    // operator replace the tail expansions; events go out as each operator
+    // completes, in the order the productions would give. Operands inside
+    // parentheses, prefix operators, arguments and right-hand sides push
+    // frames on a stack of their own instead of recursing, so nesting is
+    // bounded by memory as it is for parse_stack. Returns false after a
+    // syntax error.
+    bool pratt = pratt_expressions && emit_events;  // Only the built-in grammar has these non-terminals
+    enum class Pending : uint8_t {
+        None,
+        Unary,        // Prefix operator at index
+        Parenthesis,  // Then ')'
+        Argument,     // Of the call whose '(' is at index; then ',' or ')'
+        Middle,       // Of the '?' at index; then ':' and the last operand
+        Conditional,  // Last operand of the '?' at index
+        Operator      // Right operand of the infix operator at index
+    };
+    struct ExpressionFrame {
+        uint8_t min_power;  // Infix operators binding less tightly end the operand
+        Pending pending;    // What completes with the frame above
+        uint32_t index;
+    };
+    std::vector<ExpressionFrame> expression_frames;
+    auto emit = [&](ParseEventKind kind, uint32_t index) {
+        stats.steps++;
+        if (panic.getErrorCount() == 0) {
+            fireEvent(handler, kind, index, relational_op);
+        }
+    };
+    auto take = [&]() {
+        stats.steps++;
+        uint32_t index = static_cast<uint32_t>(tokens.position());
+        if constexpr (Trace::ENABLED) {
+            trace.record(TraceEvent::Match, current_token->terminal, index);
+        }
+        terminalMatched(current_token->terminal);
+        consume();
+        return index;
+    };
+    auto missing = [&](TerminalId expected) {
+        if (panic.reportable()) {
+            reportExpectedTerminal(error_reporter, *current_token, expected);
+        }
+        return false;
+    };
+    auto expression = [&](uint8_t min_power) -> bool {
+        expression_frames.clear();
+        expression_frames.push_back({min_power, Pending::None, 0});
+        bool operand = true;  // Whether the top frame still needs its operand
+        while (true) {
+            stats.max_stack_depth = std::max(stats.max_stack_depth, parse_stack.size() + expression_frames.size());
+            ExpressionFrame& frame = expression_frames.back();
+            
+            // Operand, with any prefix operators
+            if (operand) {
+                TerminalId next = current_token->terminal;
+                BindingPower power = precedence::of(next);
+                if (power.prefix != 0) {
+                    frame.pending = Pending::Unary;
+                    frame.index = take();
+                    expression_frames.push_back({power.prefix, Pending::None, 0});
+                    continue;
+                } else if (next == terminal::IDENTIFIER) {
+                    emit(ParseEventKind::Identifier, take());
+                    if (current_token->terminal == terminal::punct(PunctuationType::LPAREN)) {
+                        // A call, whose arguments stop at the commas between them
+                        uint32_t open = take();
+                        emit(ParseEventKind::CallBegin, open);
+                        if (current_token->terminal != terminal::punct(PunctuationType::RPAREN)) {
+                            frame.pending = Pending::Argument;
+                            frame.index = open;
+                            expression_frames.push_back({precedence::ARGUMENT, Pending::None, 0});
+                            continue;
+                        }
+                        take();
+                        emit(ParseEventKind::Call, open);
+                    }
+                } else if (next == terminal::INTEGER_LITERAL) {
+                    emit(ParseEventKind::IntegerLiteral, take());
+                } else if (next == terminal::FLOAT_LITERAL) {
+                    emit(ParseEventKind::FloatLiteral, take());
+                } else if (next == terminal::punct(PunctuationType::LPAREN)) {
+                    take();
+                    frame.pending = Pending::Parenthesis;
+                    expression_frames.push_back({0, Pending::None, 0});
+                    continue;
+                } else {
+                    if (panic.reportable()) {
+                        error_reporter.report(diag::ExpectedTokenKind{}, current_token->loc, "expression",
+                                              current_token->lexeme);
+                    }
+                    return false;
+                }
+                operand = false;
+            }
+            
+            // Postfix and infix operators that bind at least as tightly as min_power
+            TerminalId op = current_token->terminal;
+            BindingPower power = precedence::of(op);
+            if (power.postfix != 0 ? power.postfix >= frame.min_power
+                                   : power.left != 0 && power.left >= frame.min_power) {
+                uint32_t index = take();
+                if (power.postfix != 0) {
+                    emit(ParseEventKind::Increment, index);
+                    continue;
+                }
+                bool conditional = op == terminal::op(OperatorType::QUESTION);
+                frame.pending = conditional ? Pending::Middle : Pending::Operator;
+                frame.index = index;
+                expression_frames.push_back({conditional ? uint8_t(0) : power.right, Pending::None, 0});
+                operand = true;
+                continue;
+            }
+            
+            // The operand is complete: finish what the frame below was waiting for
+            expression_frames.pop_back();
+            if (expression_frames.empty()) {
+                return true;
+            }
+            ExpressionFrame& below = expression_frames.back();
+            switch (below.pending) {
+                case Pending::Unary:
+                    emit(ParseEventKind::Unary, below.index);
+                    break;
+                case Pending::Parenthesis:
+                    if (current_token->terminal != terminal::punct(PunctuationType::RPAREN)) {
+                        return missing(terminal::punct(PunctuationType::RPAREN));
+                    }
+                    take();
+                    break;
+                case Pending::Argument:
+                    if (current_token->terminal == terminal::op(OperatorType::COMMA)) {
+                        take();
+                        expression_frames.push_back({precedence::ARGUMENT, Pending::None, 0});
+                        operand = true;
+                        continue;
+                    }
+                    if (current_token->terminal != terminal::punct(PunctuationType::RPAREN)) {
+                        return missing(terminal::punct(PunctuationType::RPAREN));
+                    }
+                    take();
+                    emit(ParseEventKind::Call, below.index);
+                    break;
+                case Pending::Middle:
+                    if (current_token->terminal != terminal::op(OperatorType::COLON)) {
+                        return missing(terminal::op(OperatorType::COLON));
+                    }
+                    take();
+                    below.pending = Pending::Conditional;
+                    expression_frames.push_back({precedence::of(terminal::op(OperatorType::QUESTION)).right,
+                                                 Pending::None, 0});
+                    operand = true;
+                    continue;
+                case Pending::Conditional:
+                    emit(ParseEventKind::Conditional, below.index);
+                    break;
+                case Pending::Operator:
+                    emit(ParseEventKind::Operator, below.index);
+                    break;
+                case Pending::None:
+                    break;
+            }
+        }
+    };
+    
+    // Grammars never expand without consuming input (see
+    // findExpansionCycle()), so every step either consumes a token or is one
+    // of a bounded number of expansions and epsilon pops before the next one:
+    // linear time, and a stack no deeper than the program's nesting
+    stats = ParseStats();
+    while (!parse_stack.empty()) {
+        stats.steps++;
+        stats.max_stack_depth = std::max(stats.max_stack_depth, parse_stack.size());
+        
+        // Check what's on top of the stack
+        Symbol top = parse_stack.back();
+        parse_stack.pop_back();
+        
+        if (symbol::isEvent(top)) {
+            // After a syntax error the constructs are incomplete; stay quiet
+            if (panic.getErrorCount() == 0) {
+                fireEvent(handler, static_cast<ParseEventKind>(symbol::eventKind(top)), event_tokens.back(),
+                          relational_op);
+            }
+            event_tokens.pop_back();
+        } else if (!symbol::isNonTerminal(top)) {
+            // Terminal on top of the stack: one integer compare with the lookahead
+            TerminalId expected = top;
+            
+            if (expected == terminal::END_OF_FILE) {
+                // If we reached the EOF marker, check if input is also at EOF
+                if (current_token->terminal == terminal::END_OF_FILE) {
+                    return panic.getErrorCount() == 0; // Successful parse unless something was recovered from
+                } else {
+                    if (panic.reportable()) {
+                        error_reporter.report(diag::ExpectedEndOfFile{}, current_token->loc, current_token->lexeme);
+                    }
+                    return false;
+                }
+            }
+            
+            if (!matchToken(expected)) {
+                if (panic.reportable()) {
+                    reportExpectedTerminal(error_reporter, *current_token, expected);
+                }
+                if (expected == terminal::punct(PunctuationType::LBRACE)) {
+                    // The block stays unopened, so recovery skips past its statements
+                    parse_stack.push_back(expected);
+                } else if (expected == terminal::punct(PunctuationType::RBRACE)) {
+                    // Something that cannot start a statement ended the list
+                    // early; the block is still open
+                    parse_stack.push_back(expected);
+                    parse_stack.push_back(symbol::nt(NonTerminal::STATEMENT_LIST));
+                }
+                if (!recover()) {
+                    return false;
+                }
+                continue;
+            }
+            
+            if constexpr (Trace::ENABLED) {
+                trace.record(TraceEvent::Match, expected, static_cast<uint32_t>(tokens.position()));
+            }
+            terminalMatched(expected);
+            consume();
+        } else {
+            // Non-terminal on top of stack, look up in parse table
+            NonTerminal nonterm = static_cast<NonTerminal>(symbol::nonTerminalIndex(top));
+            
+            if constexpr (Trace::ENABLED) {
+                trace.record(TraceEvent::Expand, static_cast<uint16_t>(nonterm),
+                             static_cast<uint32_t>(tokens.position()));
+            }
+            
+            // Special case for DECLARATION - prepare to process a new declaration
+            if (nonterm == NonTerminal::DECLARATION) {
+                actions.declarationBegins();
+            }
+            
+            if (pratt && nonterm == NonTerminal::EXPRESSION) {
+                if (!expression(0)) {
+                    if (!recover()) {
+                        return false;
+                    }
+                }
+                continue;
+            }
+            
+            // Both operands stop at the relational and equality operators,
+            // so the one between them is the condition's
+            if (pratt && nonterm == NonTerminal::CONDITION) {
+                bool parsed = expression(precedence::RELATIONAL_OPERAND);
+                if (parsed && predict(NonTerminal::RELATIONAL_OP, current_token->terminal) == GrammarTables::NO_PRODUCTION) {
+                    if (panic.reportable()) {
+                        reportParseError(NonTerminal::RELATIONAL_OP);
+                    }
+                    parsed = false;
+                }
+                if (parsed) {
+                    uint32_t op = take();
+                    parsed = expression(precedence::RELATIONAL_OPERAND);
+                    if (parsed) {
+                        emit(ParseEventKind::Operator, op);
+                    }
+                }
+                if (!parsed) {
+                    if (!recover()) {
+                        return false;
+                    }
+                }
+                continue;
+            }
+            
+            // Special case for STATEMENT_LIST to avoid infinite loops with epsilon productions
+            if (nonterm == NonTerminal::STATEMENT_LIST) {
+                // If we see '}', we use the epsilon production
+                if (current_token->terminal == terminal::punct(PunctuationType::RBRACE)) {
+                    traceChoice(TraceChoice::ListEndsAtBrace);
+                    continue; // Skip to next iteration
+                }
+                
+                // Check if we are at the beginning of a statement
+                bool isStatementStart = false;
+                
+                // Check for statement start tokens
+                switch (current_token->terminal) {
+                    // Keywords that can start a statement: int, float, while, return
+                    case terminal::keyword(KeywordType::Int):
+                    case terminal::keyword(KeywordType::Float):
+                    case terminal::keyword(KeywordType::While):
+                    case terminal::keyword(KeywordType::Return):
+                    // Statements can start with identifiers (assignments or expressions)
+                    case terminal::IDENTIFIER:
+                    // Expressions can also start with literals or a parenthesis
+                    case terminal::INTEGER_LITERAL:
+                    case terminal::FLOAT_LITERAL:
+                    case terminal::punct(PunctuationType::LPAREN):
+                        isStatementStart = true;
+                        break;
+                    default:
+                        // Pratt expressions may also open with a prefix operator
+                        isStatementStart = pratt && precedence::startsExpression(current_token->terminal);
+                        break;
+                }
+                
+                if (isStatementStart) {
+                    traceChoice(TraceChoice::ListContinues);
+                    // Push STATEMENT_LIST first (top of stack gets processed first)
+                    parse_stack.push_back(symbol::nt(NonTerminal::STATEMENT_LIST));
+                    if constexpr (Handler::REUSES_STATEMENTS) {
+                        // A statement parses from its own tokens alone, so
+                        // one the handler already has only needs the symbol
+                        // table brought up to date
+                        uint32_t end = panic.getErrorCount() == 0 ? handler.onStatementBegin(
+                                                                static_cast<uint32_t>(tokens.position()))
+                                                          : 0;
+                        if (end != 0) {
+                            while (tokens.position() < end) {
+                                terminalMatched(current_token->terminal);
+                                consume();
+                            }
+                            continue;
+                        }
+                        schedule(ParseEventKind::StatementEnd);
+                    }
+                    parse_stack.push_back(symbol::nt(NonTerminal::STATEMENT));
+                    continue; // Skip to next iteration
+                } else {
+                    // If not at start of statement, use epsilon production
+                    traceChoice(TraceChoice::ListEnds);
+                    continue; // Skip to next iteration
+                }
+            }
+            
+            // Special case for STATEMENT to help with decision making
+            if (nonterm == NonTerminal::STATEMENT) {
+                // Declarations start with type keywords
+                if (current_token->terminal == terminal::keyword(KeywordType::Int) ||
+                    current_token->terminal == terminal::keyword(KeywordType::Float)) {
+                    traceChoice(TraceChoice::Declaration);
+                    parse_stack.push_back(symbol::nt(NonTerminal::DECLARATION));
+                    continue;
+                }
+                
+                // Assignments start with identifiers
+                else if (current_token->terminal == terminal::IDENTIFIER) {
+                    // Look ahead to check if this is an assignment or just an expression
+                    // We need to check if the next token is '='
+                    Token* next_token = nullptr;
+                    if (!tokens.isAtEnd()) {
+                        tokens.advance();
+                        next_token = &tokens.peek();
+                        tokens.rewind(); // Go back to current token
+                    }
+                    
+                    if (next_token && next_token->terminal == terminal::op(OperatorType::EQUAL)) {
+                        traceChoice(TraceChoice::Assignment);
+                        parse_stack.push_back(symbol::nt(NonTerminal::ASSIGNMENT));
+                    } else {
+                        // This is an expression statement
+                        traceChoice(TraceChoice::ExpressionStatement);
+                        schedule(ParseEventKind::ExpressionStatement);
+                        parse_stack.push_back(terminal::op(OperatorType::SEMICOLON));
+                        parse_stack.push_back(symbol::nt(NonTerminal::EXPRESSION));
+                    }
+                    continue;
+                }
+                
+                // Loops start with 'while'
+                else if (current_token->terminal == terminal::keyword(KeywordType::While)) {
+                    traceChoice(TraceChoice::Loop);
+                    parse_stack.push_back(symbol::nt(NonTerminal::LOOP));
+                    continue;
+                }
+                
+                // Return statements start with 'return'
+                else if (current_token->terminal == terminal::keyword(KeywordType::Return)) {
+                    traceChoice(TraceChoice::Return);
+                    parse_stack.push_back(symbol::nt(NonTerminal::RETURN_STMT));
+                    continue;
+                }
+                
+                // Expression statements
+                else if (current_token->terminal == terminal::INTEGER_LITERAL ||
+                         current_token->terminal == terminal::FLOAT_LITERAL ||
+                         current_token->terminal == terminal::punct(PunctuationType::LPAREN) ||
+                         (pratt && precedence::startsExpression(current_token->terminal))) {
+                    traceChoice(TraceChoice::ExpressionStatement);
+                    schedule(ParseEventKind::ExpressionStatement);
+                    parse_stack.push_back(terminal::op(OperatorType::SEMICOLON));
+                    parse_stack.push_back(symbol::nt(NonTerminal::EXPRESSION));
+                    continue;
+                }
+                
+                // If nothing matches, use epsilon
+                else {
+                    traceChoice(TraceChoice::NoStatement);
+                    continue;
+                }
+            }
+            
+            // Look up production in the dense parse table
+            int production_index = predict(nonterm, current_token->terminal);
+            
+            if (production_index != GrammarTables::NO_PRODUCTION) {
+                // Valid production, push RHS onto stack in reverse order
+                if constexpr (Trace::ENABLED) {
+                    trace.record(TraceEvent::Production, static_cast<uint16_t>(production_index),
+                                 static_cast<uint32_t>(tokens.position()));
+                }
+                
+                // The span is already reversed, events included: one copy
+                uint32_t position = static_cast<uint32_t>(tokens.position());
+                parse_stack.insert(parse_stack.end(), pushes.begin(production_index), pushes.end(production_index));
+                for (uint32_t e = pushes.event_offsets[production_index];
+                     e < pushes.event_offsets[production_index + 1]; e++) {
+                    event_tokens.push_back(position + pushes.token_offsets[e]);
+                }
+                if (emit_events && nonterm == NonTerminal::RELATIONAL_OP) {
+                    relational_op = position;
+                }
+            } else {
+                // Error: No valid production for the current input
+                if (panic.reportable()) {
+                    reportParseError(nonterm);
+                }
+                
+                // If the token can follow nonterm, the construct is just
+                // missing: drop it and carry on from here. Only once per
+                // token, so a run of such errors still makes progress.
+                if (grammar.canFollow(nonterm, current_token->terminal) && panic.dropsMissing(tokens.position())) {
+                    continue;
+                }
+                if (!recover()) {
+                    return false;
+                }
+            }
+        }
+    }
+    
+    // If we exhausted the parse stack but not the input, we have an error
+    if (current_token->type != TokenType::Eof) {
+        if (panic.reportable()) {
+            error_reporter.report(diag::UnexpectedToken{}, current_token->loc, current_token->lexeme);
+        }
+        return false;
+    }
+    
+    return panic.getErrorCount() == 0;
+}
+
+template <typename Handler>
+void Parser::fireEvent(Handler& handler, ParseEventKind kind, uint32_t index, uint32_t relational_op) {
+    const Token& token = tokens[index];
+    switch (kind) {
+        case ParseEventKind::FunctionBegin:
+            // TYPE IDENTIFIER, from the name
+            handler.onFunctionBegin(typeOf(tokens[index - 1]), token, index);
+            break;
+        case ParseEventKind::FunctionEnd: handler.onFunctionEnd(token, index); break;
+        case ParseEventKind::Parameter: handler.onParameter(typeOf(token), tokens[index + 1], index + 1); break;
+        case ParseEventKind::Declaration: {
+            // TYPE IDENTIFIER ( = | ; ), from the type keyword
+            bool has_initializer = tokens[index + 2].terminal == terminal::op(OperatorType::EQUAL);
+            handler.onDeclaration(typeOf(token), tokens[index + 1], index + 1, has_initializer);
+            break;
+        }
+        case ParseEventKind::Assignment: handler.onAssignment(token, index); break;
+        case ParseEventKind::LoopBegin: handler.onLoopBegin(token, index); break;
+        case ParseEventKind::LoopEnd: handler.onLoopEnd(token, index); break;
+        case ParseEventKind::Return: handler.onReturn(token, index); break;
+        case ParseEventKind::ExpressionStatement: handler.onExpressionStatement(token, index); break;
+        case ParseEventKind::Operator: handler.onExpressionOperator(token, index); break;
+        case ParseEventKind::RelationalOperator:
+            handler.onExpressionOperator(tokens[relational_op], relational_op);
+            break;
+        case ParseEventKind::Increment: handler.onIncrement(token, index); break;
+        case ParseEventKind::Unary: handler.onUnaryOperator(token, index); break;
+        case ParseEventKind::Conditional: handler.onConditional(token, index); break;
+        case ParseEventKind::CallBegin: handler.onCallBegin(tokens[index - 1], index - 1); break;
+        case ParseEventKind::Call: handler.onCall(tokens[index - 1], index - 1); break;
+        case ParseEventKind::Identifier: handler.onIdentifier(token, index); break;
+        case ParseEventKind::IntegerLiteral: handler.onIntegerLiteral(token, index); break;
+        case ParseEventKind::FloatLiteral: handler.onFloatLiteral(token, index); break;
+        case ParseEventKind::StatementEnd:
+            handler.onStatementEnd(index, static_cast<uint32_t>(tokens.position()));
+            break;
+    }
+}
+
+#endif // PARSER_IMPL_H
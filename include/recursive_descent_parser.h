@@ -0,0 +1,69 @@
+#ifndef RECURSIVE_DESCENT_PARSER_H
+#define RECURSIVE_DESCENT_PARSER_H
+
+#include "parse_actions.h"
+
+// Hand-written parser for the built-in Mini-C grammar: one function per
+// non-terminal, with loops in place of the list and tail non-terminals
+// (FUNCTION_LIST, PARAMETER_TAIL, STATEMENT_LIST, EXPRESSION_TAIL, TERM_TAIL,
+// ARGUMENT_TAIL). It makes the same decisions as Parser::parse(), and
+// ParseActions gives it the same diagnostics, recovery and symbol-table
+// effects, except past MAX_NESTING, where it stops instead of recursing
+// further.
+class RecursiveDescentParser : private ParseActions {
+public:
+    RecursiveDescentParser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable)
+        : ParseActions(std::move(tokens), reporter, symtable) {}
+
+    RecursiveDescentParser(TokenStream tokens, CompilationContext& context)
+        : RecursiveDescentParser(std::move(tokens), context.getReporter(), context.getSymbolTable()) {}
+
+    bool parse();
+
+    // Expressions and loops nested deeper than this are reported rather
+    // than parsed: each level is a few native calls deep
+    static constexpr size_t MAX_NESTING = 4096;
+
+private:
+    size_t nesting = 0;  // Expressions and loops open
+    bool stopped = false;  // Nowhere left to resume after a syntax error
+
+    // Each returns false after a syntax error it did not drop in place, and
+    // the innermost open block's statement list recovers from it (see
+    // parseBlock()); once stopped, every one returns false
+    bool parseFunctionList();
+    bool parseFunction();
+    bool parseParameterList();
+    bool parseParameter();
+    bool parseBlock();
+    bool parseStatementList();
+    bool parseStatement();
+    bool parseDeclaration();
+    bool parseAssignment();
+    bool parseLoop();
+    bool parseCondition();
+    bool parseReturn();
+    bool parseExpression();
+    bool parseTerm();
+    bool parseFactor();
+    bool parseArgumentList();
+
+    // Whether the lookahead starts a statement, as Parser::parse() decides it
+    bool atStatementStart() const;
+
+    // Whether the LL(1) table has a production for nonterm on the lookahead
+    bool hasProduction(NonTerminal nonterm) const;
+    // Report a missing production unless there is one, where
+    // Parser::parse() would check. Constructs that can be dropped in place
+    // (see ParseActions::noProduction()) check hasProduction() themselves.
+    bool expectProduction(NonTerminal nonterm);
+
+    // Skip the input past a syntax error; false, and stopped, when there is
+    // nowhere to resume
+    bool recover();
+
+    // Report nesting past MAX_NESTING and stop; always false
+    bool nestingTooDeep();
+};
+
+#endif // RECURSIVE_DESCENT_PARSER_H
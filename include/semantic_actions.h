@@ -0,0 +1,75 @@
+#ifndef SEMANTIC_ACTIONS_H
+#define SEMANTIC_ACTIONS_H
+
+#include "token.h"
+#include "error.h"
+#include "symbol_table.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// What parsing Mini-C does besides checking syntax, shared by every parser:
+// braces open and close scopes, a declaration's name is entered at its ';'
+// and a parameter's at the ',' or ')' after it, other identifiers are
+// checked as uses, and function definitions and calls are collected for
+// FunctionTable::check(). Parsers report each terminal as they match it, in
+// source order, so they all make the same symbol-table changes and report
+// the same diagnostics.
+class SemanticActions {
+public:
+    SemanticActions(ErrorReporter& reporter, SymbolTable& symtable)
+        : error_reporter(reporter), symbol_table(symtable) {}
+
+    // Check that tokens can be parsed and open the global scope. An empty
+    // stream is reported; a reporter that already has errors is left as is.
+    bool begin(const TokenStream& tokens);
+
+    // A DECLARATION is being expanded
+    void declarationBegins();
+
+    // matched was matched by tokens[index], before the parser moves past it
+    void terminalMatched(TerminalId matched, const TokenStream& tokens, size_t index);
+
+    // Parsing resumes elsewhere after a syntax error. A half-parsed
+    // declaration keeps its name, so its uses don't cascade.
+    void abandonDeclaration();
+
+    // The declaration whose name has been matched but not yet entered
+    bool hasDeclaredName() const { return processing_declaration && !declared_name.empty(); }
+    SymbolType getDeclaredType() const { return current_type; }
+    uint32_t getDeclaredIndex() const { return declared_index; }
+
+private:
+    ErrorReporter& error_reporter;
+    SymbolTable& symbol_table;
+
+    // Declaration being parsed
+    SymbolType current_type = SymbolType::UNKNOWN;
+    std::string declared_name;  // Only ever the identifier after the type
+    uint32_t declared_index = 0;
+    bool processing_declaration = false;
+
+    // Function header being parsed
+    int global_scope = 0;
+    bool in_parameters = false;       // Between a function header's parentheses
+    bool parameters_pending = false;  // Until the body's '{' declares them
+
+    // Parentheses open, innermost last. Calls' arguments are counted as
+    // their tokens are matched: the first one, and one more per ',' between
+    // the call's own parentheses.
+    static constexpr size_t NOT_A_CALL = SIZE_MAX;
+    struct Parenthesis {
+        size_t call;  // In FunctionTable::getCalls(), or NOT_A_CALL
+        bool started;  // A token has followed the '('
+    };
+    std::vector<Parenthesis> parentheses;
+    size_t callee = NOT_A_CALL;  // Call whose '(' is the next token
+
+    void identifierMatched(const TokenStream& tokens, size_t index);
+    // A token matched between parentheses
+    void argumentMatched(TerminalId matched);
+    // A parameter's TYPE IDENTIFIER ends at the ',' or ')' at index
+    void parameterMatched(const TokenStream& tokens, size_t index);
+};
+
+#endif // SEMANTIC_ACTIONS_H
@@ -0,0 +1,33 @@
+#ifndef SOURCE_MANAGER_H
+#define SOURCE_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// A loaded source file. The text is shared so the lexer and the error
+// reporter can both read it without copying.
+struct SourceFile {
+    uint32_t id;
+    std::string path;
+    std::shared_ptr<const std::string> text;
+};
+
+// Loads and owns the source files of one compilation
+class SourceManager {
+public:
+    // Load a file (or return the already-loaded copy); nullptr if unreadable
+    const SourceFile* load(const std::string& path);
+    
+    const SourceFile* getFile(uint32_t id) const;
+    size_t getFileCount() const { return files.size(); }
+    
+    // Read a whole file into a shared buffer; nullptr if it cannot be opened
+    static std::shared_ptr<const std::string> readFile(const std::string& path);
+
+private:
+    std::vector<std::unique_ptr<SourceFile>> files;
+};
+
+#endif // SOURCE_MANAGER_H
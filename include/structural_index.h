@@ -0,0 +1,49 @@
+#ifndef STRUCTURAL_INDEX_H
+#define STRUCTURAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The block structure of a source buffer, found without lexing it: every
+// '{', '}', '(', ')' and ';' outside comments and string literals, and which
+// brackets match. The buffer is classified 64 bytes at a time into
+// bitmasks, one bit per byte, with SSE2 where the target has it. Whether a
+// block starts inside a string or comment is carried over from the one
+// before. In a block where no comment starts and no string holds a
+// backslash, the bytes inside strings are the prefix XOR of the quote
+// mask; otherwise the block is walked from one quote, backslash, comment
+// delimiter or newline to the next. Comments and strings end where the
+// Lexer ends them, so the characters found are exactly the Lexer's tokens
+// for them, in the same order.
+class StructuralIndex {
+public:
+    static constexpr uint32_t NO_MATCH = UINT32_MAX;
+
+    // Index text[0, size), which ends at its first NUL as it does for the Lexer
+    void build(const char* text, size_t size);
+    void build(const std::string& text) { build(text.data(), text.size()); }
+
+    // The structural characters in order: byte offset and the character
+    size_t size() const { return offsets.size(); }
+    uint32_t offset(size_t i) const { return offsets[i]; }
+    char character(size_t i) const { return characters[i]; }
+
+    // Entry holding the bracket that matches entry i's, or NO_MATCH for a
+    // ';' and for brackets left unmatched. Braces and parentheses are
+    // matched separately, each as TokenStream matches braces: a closer
+    // with nothing open matches nothing.
+    uint32_t match(size_t i) const { return matches[i]; }
+
+private:
+    std::vector<uint32_t> offsets;
+    std::vector<char> characters;
+    std::vector<uint32_t> matches;
+
+    // Store the characters of the block at base that structural marks from
+    // entry count on, advancing count past them
+    void flatten(size_t base, uint64_t structural, const char* text, size_t& count);
+};
+
+#endif // STRUCTURAL_INDEX_H
@@ -1,6 +1,7 @@
 #ifndef SYMBOL_TABLE_H
 #define SYMBOL_TABLE_H
 
+#include "error.h"
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -33,6 +34,59 @@ struct SymbolInfo {
         : name(name), type(type), scope_level(scope), is_initialized(false) {}
 };
 
+// A function's parameter, declared in its body's scope
+struct ParameterInfo {
+    std::string name;
+    SymbolType type;
+    SourceLocation loc;
+};
+
+struct FunctionInfo {
+    std::string name;
+    SymbolType return_type;
+    SourceLocation loc;
+    std::vector<ParameterInfo> parameters;
+};
+
+struct CallSite {
+    std::string name;
+    uint32_t argument_count;
+    SourceLocation loc;
+};
+
+// Every function defined and called in a program. Calls may come before
+// the definition they refer to, so they are only checked by check(), once
+// every function is known; with functions parsed separately, their tables
+// are merged first.
+class FunctionTable {
+public:
+    // Definitions and calls, in the order the parser meets them
+    void define(const std::string& name, SymbolType return_type, const SourceLocation& loc);
+    // Parameter of the function defined last
+    void addParameter(const std::string& name, SymbolType type, const SourceLocation& loc);
+    // A call, with no arguments until addArgument() counts them as the
+    // parser reaches them; returns its index for that
+    size_t addCall(const std::string& name, const SourceLocation& loc);
+    void addArgument(size_t call) { calls[call].argument_count++; }
+    
+    // Append other's definitions and calls after these
+    void merge(FunctionTable&& other);
+    
+    // Report functions defined twice, calls to functions never defined and
+    // calls with the wrong number of arguments; returns the errors reported
+    size_t check(ErrorReporter& reporter) const;
+    
+    // The first definition of name, or nullptr
+    const FunctionInfo* find(const std::string& name) const;
+    
+    const std::vector<FunctionInfo>& getFunctions() const { return functions; }
+    const std::vector<CallSite>& getCalls() const { return calls; }
+
+private:
+    std::vector<FunctionInfo> functions;
+    std::vector<CallSite> calls;
+};
+
 // Class that manages symbols and their scopes
 class SymbolTable {
 private:
@@ -42,10 +96,12 @@ private:
     // Current scope level
     int current_scope;
     
+    FunctionTable functions;
+    
 public:
     SymbolTable();
     
-    // Enter a new scope
+    // Enter a new scope, empty even where a sibling block's was
     void enterScope();
     
     // Exit the current scope
@@ -78,6 +134,10 @@ public:
     
     // Get all symbols in the symbol table
     std::vector<SymbolInfo> getAllSymbols() const;
+    
+    // Functions, which live outside the scopes
+    FunctionTable& getFunctions() { return functions; }
+    const FunctionTable& getFunctions() const { return functions; }
 };
 
 #endif // SYMBOL_TABLE_H
@@ -4,6 +4,8 @@
 #include <error.h>
 #include <string>
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 
 enum class TokenType {
     Keyword,
@@ -39,6 +41,40 @@ enum class LiteralType {
     Boolean,
 };
 
+// Dense ids for every terminal a grammar can name, assigned to each token by
+// the lexer so the parser can index its tables without touching the lexeme.
+// Keywords, operators and punctuation keep their enum order inside their range.
+using TerminalId = uint16_t;
+
+namespace terminal {
+constexpr TerminalId KEYWORD_BASE = 0;
+constexpr TerminalId KEYWORD_COUNT = static_cast<TerminalId>(KeywordType::Return) + 1;
+constexpr TerminalId OPERATOR_BASE = KEYWORD_BASE + KEYWORD_COUNT;
+constexpr TerminalId OPERATOR_COUNT = static_cast<TerminalId>(OperatorType::CARET) + 1;
+constexpr TerminalId PUNCTUATION_BASE = OPERATOR_BASE + OPERATOR_COUNT;
+constexpr TerminalId PUNCTUATION_COUNT = static_cast<TerminalId>(PunctuationType::RANGLE) + 1;
+
+constexpr TerminalId IDENTIFIER = PUNCTUATION_BASE + PUNCTUATION_COUNT;
+constexpr TerminalId INTEGER_LITERAL = IDENTIFIER + 1;
+constexpr TerminalId FLOAT_LITERAL = IDENTIFIER + 2;
+constexpr TerminalId STRING_LITERAL = IDENTIFIER + 3;
+constexpr TerminalId MAIN = IDENTIFIER + 4;  // Contextual: an identifier spelled "main"
+constexpr TerminalId END_OF_FILE = IDENTIFIER + 5;
+constexpr TerminalId ERROR = IDENTIFIER + 6;
+constexpr TerminalId COUNT = IDENTIFIER + 7;
+
+constexpr TerminalId keyword(KeywordType kw) { return KEYWORD_BASE + static_cast<TerminalId>(kw); }
+constexpr TerminalId op(OperatorType op) { return OPERATOR_BASE + static_cast<TerminalId>(op); }
+constexpr TerminalId punct(PunctuationType punct) { return PUNCTUATION_BASE + static_cast<TerminalId>(punct); }
+// Identifiers and literals: terminals that stand for a class of lexemes
+constexpr bool isTokenClass(TerminalId id) { return id >= IDENTIFIER && id <= STRING_LITERAL; }
+
+// Grammar spelling of a terminal: "int", "(", "$1" for identifiers, "$" for end of file
+const char* spelling(TerminalId id);
+// Inverse of spelling(); COUNT if text names no terminal
+TerminalId fromSpelling(const std::string& text);
+}
+
 typedef union{
     int int_value;
     char char_value;
@@ -59,22 +95,85 @@ struct Token {
     SourceLocation loc;
     TokenValue value;
     std::string lexeme;
+    TerminalId terminal = terminal::ERROR;
+};
+
+// Terminal id for a token from its type and subtype
+TerminalId classifyTerminal(const Token& token);
+
+// Kind of token that error recovery can resynchronize on
+enum class SyncKind : uint8_t {
+    Terminator,      // ';'
+    StatementStart,  // int, float, while, if, return
+    BlockEnd         // '}'
+};
+
+// Entry in the synchronization-point index built while tokens are appended
+struct SyncPoint {
+    uint32_t token_index;
+    uint32_t brace_depth;  // Number of '{' still open at this token
+    SyncKind kind;
 };
 
+// Tokens are stored in fixed-size blocks reached through a block directory.
+// Appending only ever allocates a new block, so existing tokens never move and
+// Token pointers/references handed out by peek()/advance() stay valid.
 class TokenStream {
 private:
-    std::vector<Token> tokens;
+    static constexpr size_t BLOCK_SHIFT = 8;
+    static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_SHIFT;
+    static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+    static constexpr uint32_t NO_MATCH = UINT32_MAX;
+
+    std::vector<Token*> blocks;  // Directory of raw blocks of BLOCK_SIZE tokens
+    size_t count;
     size_t current;
+
+    // Recovery index, filled by add() as the lexer emits tokens
+    std::vector<SyncPoint> sync_points;
+    std::vector<std::pair<uint32_t, uint32_t>> brace_pairs;  // ('{' index, matching '}' index)
+    std::vector<uint32_t> open_braces;  // Positions in brace_pairs still awaiting a '}'
+    size_t sync_cursor;  // Hint into sync_points; recovery mostly moves forward
+
+    void indexToken(const Token& token, size_t index);
+    size_t nextSyncPoint(size_t from);
+
+    Token& at(size_t index) { return blocks[index >> BLOCK_SHIFT][index & BLOCK_MASK]; }
+    const Token& at(size_t index) const { return blocks[index >> BLOCK_SHIFT][index & BLOCK_MASK]; }
+    void clear();
+
 public:
-    TokenStream() : current(0) {}
-    TokenStream(const std::vector<Token>& tokens) : tokens(tokens), current(0) {}
+    TokenStream() : count(0), current(0), sync_cursor(0) {}
+    TokenStream(const std::vector<Token>& tokens);
+    TokenStream(const TokenStream& other);
+    TokenStream(TokenStream&& other) noexcept;
+    TokenStream& operator=(TokenStream other) noexcept;
+    ~TokenStream();
+
     Token& peek();
     void add(Token token);
     Token& advance();
     bool isAtEnd() const;
     void reset();
-    void synchronize();
+    // Skip past the current token to the next sync point. With skip_blocks,
+    // a '{' met on the way is skipped together with its block, so recovery
+    // never lands inside a block the parser has not opened.
+    void synchronize(bool skip_blocks = false);
+    // Whether the current token is a sync point, or the end of input
+    bool atSyncPoint();
     void rewind();
+
+    // Skip from a '{' to just past its matching '}'; false if unbalanced
+    bool skipBlock();
+    // Index of the '}' matching the '{' at open_index, or size() if none
+    size_t matchingBrace(size_t open_index) const;
+    const std::vector<SyncPoint>& getSyncPoints() const { return sync_points; }
+
+    size_t size() const { return count; }
+    size_t position() const { return current; }
+    Token& operator[](size_t index) { return at(index); }
+    const Token& operator[](size_t index) const { return at(index); }
 };
 
 #endif // TOKEN_H
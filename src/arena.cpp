@@ -0,0 +1,45 @@
+#include "arena.h"
+#include <algorithm>
+
+Arena::~Arena() {
+    for (const auto& block : blocks) {
+        ::operator delete(block.first);
+    }
+}
+
+void Arena::grow(size_t min_size) {
+    size_t size = std::max(block_size, min_size);
+    char* block = static_cast<char*>(::operator new(size));
+    blocks.push_back({block, size});
+    cursor = block;
+    limit = block + size;
+    bytes_reserved += size;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    if (!cursor || aligned + size > reinterpret_cast<uintptr_t>(limit)) {
+        grow(size + alignment);
+        aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    }
+    
+    cursor = reinterpret_cast<char*>(aligned + size);
+    bytes_allocated += size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::reset() {
+    for (size_t i = 1; i < blocks.size(); i++) {
+        ::operator delete(blocks[i].first);
+    }
+    if (blocks.empty()) {
+        cursor = limit = nullptr;
+        bytes_reserved = 0;
+    } else {
+        blocks.resize(1);
+        cursor = blocks[0].first;
+        limit = blocks[0].first + blocks[0].second;
+        bytes_reserved = blocks[0].second;
+    }
+    bytes_allocated = 0;
+}
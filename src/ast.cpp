@@ -0,0 +1,390 @@
+#include "ast.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+Ast::Ast() : owned_arena(std::make_unique<Arena>()), arena(*owned_arena) {}
+
+Ast::Ast(Arena& arena) : arena(arena) {}
+
+NodeList Ast::addList(const NodeRef* refs, size_t count) {
+    NodeList list{lists.size(), static_cast<uint32_t>(count)};
+    for (size_t i = 0; i < count; i++) {
+        lists.add(arena, refs[i]);
+    }
+    return list;
+}
+
+uint32_t Ast::addName(std::string_view name) {
+    char* copy = static_cast<char*>(arena.allocate(name.size(), 1));
+    std::memcpy(copy, name.data(), name.size());
+    return names.add(arena, std::string_view(copy, name.size()));
+}
+
+size_t Ast::getNodeCount() const {
+    size_t count = 0;
+    std::apply([&count](const auto&... pool) { ((count += pool.size()), ...); }, pools);
+    return count;
+}
+
+size_t Ast::getBytesUsed() const {
+    size_t bytes = arena.getBytesAllocated() + lists.directoryBytes() + names.directoryBytes();
+    std::apply([&bytes](const auto&... pool) { ((bytes += pool.directoryBytes()), ...); }, pools);
+    return bytes;
+}
+
+// The token field of node, for a const or mutable Ast
+template <typename AstType>
+auto& Ast::tokenField(AstType& ast, NodeRef node) {
+    switch (node.kind()) {
+        case NodeKind::Program: return ast.template get<ProgramNode>(node).token;
+        case NodeKind::Function: return ast.template get<FunctionNode>(node).token;
+        case NodeKind::Declaration: return ast.template get<DeclarationNode>(node).token;
+        case NodeKind::Assignment: return ast.template get<AssignmentNode>(node).token;
+        case NodeKind::Loop: return ast.template get<LoopNode>(node).token;
+        case NodeKind::Return: return ast.template get<ReturnNode>(node).token;
+        case NodeKind::ExpressionStatement: return ast.template get<ExpressionStatementNode>(node).token;
+        case NodeKind::Binary: return ast.template get<BinaryNode>(node).token;
+        case NodeKind::Increment: return ast.template get<IncrementNode>(node).token;
+        case NodeKind::Unary: return ast.template get<UnaryNode>(node).token;
+        case NodeKind::Conditional: return ast.template get<ConditionalNode>(node).token;
+        case NodeKind::Call: return ast.template get<CallNode>(node).token;
+        case NodeKind::Identifier: return ast.template get<IdentifierNode>(node).token;
+        case NodeKind::IntegerLiteral: return ast.template get<IntegerLiteralNode>(node).token;
+        case NodeKind::FloatLiteral: break;
+    }
+    return ast.template get<FloatLiteralNode>(node).token;
+}
+
+uint32_t Ast::tokenOf(NodeRef node) const {
+    return tokenField(*this, node);
+}
+
+void Ast::shiftTokens(NodeRef node, int64_t delta) {
+    forEachNode(node, [this, delta](NodeRef each) {
+        uint32_t& token = tokenField(*this, each);
+        token = static_cast<uint32_t>(token + delta);
+    });
+}
+
+void Ast::clear() {
+    std::apply([](auto&... pool) { (pool.clear(), ...); }, pools);
+    lists.clear();
+    names.clear();
+    root = NodeRef();
+    arena.reset();
+}
+
+namespace {
+const char* operatorSpelling(OperatorType op) {
+    return terminal::spelling(terminal::op(op));
+}
+
+const char* typeName(SymbolType type) {
+    return type == SymbolType::INT ? "int" : type == SymbolType::FLOAT ? "float" : "?";
+}
+}
+
+void Ast::dumpBody(NodeList body, int depth, std::string& out) const {
+    for (uint32_t i = 0; i < body.count; i++) {
+        out += '\n';
+        out.append(depth * 2, ' ');
+        dumpNode(listAt(body, i), depth, out);
+    }
+}
+
+void Ast::dumpNode(NodeRef node, int depth, std::string& out) const {
+    if (!node.isValid()) {
+        out += "()";
+        return;
+    }
+    switch (node.kind()) {
+        case NodeKind::Program: {
+            const ProgramNode& program = get<ProgramNode>(node);
+            for (uint32_t i = 0; i < program.functions.count; i++) {
+                if (i > 0) {
+                    out += '\n';
+                }
+                dumpNode(listAt(program.functions, i), depth, out);
+            }
+            break;
+        }
+        case NodeKind::Function: {
+            const FunctionNode& function = get<FunctionNode>(node);
+            out += "(function ";
+            out += name(function.name);
+            for (uint32_t i = 0; i < function.parameters.count; i++) {
+                const DeclarationNode& parameter = get<DeclarationNode>(listAt(function.parameters, i));
+                out += " (";
+                out += typeName(parameter.type);
+                out += ' ';
+                out += name(parameter.name);
+                out += ')';
+            }
+            dumpBody(function.body, depth + 1, out);
+            out += ')';
+            break;
+        }
+        case NodeKind::Declaration: {
+            const DeclarationNode& declaration = get<DeclarationNode>(node);
+            out += "(declare ";
+            out += typeName(declaration.type);
+            out += ' ';
+            out += name(declaration.name);
+            if (declaration.init.isValid()) {
+                out += ' ';
+                dumpNode(declaration.init, depth, out);
+            }
+            out += ')';
+            break;
+        }
+        case NodeKind::Assignment: {
+            const AssignmentNode& assignment = get<AssignmentNode>(node);
+            out += "(assign ";
+            out += name(assignment.name);
+            out += ' ';
+            dumpNode(assignment.value, depth, out);
+            out += ')';
+            break;
+        }
+        case NodeKind::Loop: {
+            const LoopNode& loop = get<LoopNode>(node);
+            out += "(while ";
+            dumpNode(loop.condition, depth, out);
+            dumpBody(loop.body, depth + 1, out);
+            out += ')';
+            break;
+        }
+        case NodeKind::Return:
+            out += "(return ";
+            dumpNode(get<ReturnNode>(node).value, depth, out);
+            out += ')';
+            break;
+        case NodeKind::ExpressionStatement:
+            out += "(expr ";
+            dumpNode(get<ExpressionStatementNode>(node).expression, depth, out);
+            out += ')';
+            break;
+        case NodeKind::Binary: {
+            const BinaryNode& binary = get<BinaryNode>(node);
+            out += '(';
+            out += operatorSpelling(binary.op);
+            out += ' ';
+            dumpNode(binary.lhs, depth, out);
+            out += ' ';
+            dumpNode(binary.rhs, depth, out);
+            out += ')';
+            break;
+        }
+        case NodeKind::Increment: {
+            const IncrementNode& increment = get<IncrementNode>(node);
+            out += '(';
+            out += operatorSpelling(increment.op);
+            out += ' ';
+            dumpNode(increment.operand, depth, out);
+            out += ')';
+            break;
+        }
+        case NodeKind::Unary: {
+            const UnaryNode& unary = get<UnaryNode>(node);
+            out += "(prefix ";
+            out += operatorSpelling(unary.op);
+            out += ' ';
+            dumpNode(unary.operand, depth, out);
+            out += ')';
+            break;
+        }
+        case NodeKind::Conditional: {
+            const ConditionalNode& conditional = get<ConditionalNode>(node);
+            out += "(? ";
+            dumpNode(conditional.condition, depth, out);
+            out += ' ';
+            dumpNode(conditional.then, depth, out);
+            out += ' ';
+            dumpNode(conditional.otherwise, depth, out);
+            out += ')';
+            break;
+        }
+        case NodeKind::Call: {
+            const CallNode& call = get<CallNode>(node);
+            out += "(call ";
+            out += name(call.name);
+            for (uint32_t i = 0; i < call.arguments.count; i++) {
+                out += ' ';
+                dumpNode(listAt(call.arguments, i), depth, out);
+            }
+            out += ')';
+            break;
+        }
+        case NodeKind::Identifier:
+            out += name(get<IdentifierNode>(node).name);
+            break;
+        case NodeKind::IntegerLiteral:
+            out += std::to_string(get<IntegerLiteralNode>(node).value);
+            break;
+        case NodeKind::FloatLiteral: {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%g", get<FloatLiteralNode>(node).value);
+            out += buffer;
+            break;
+        }
+    }
+}
+
+std::string Ast::dump() const {
+    return dump(root);
+}
+
+std::string Ast::dump(NodeRef node) const {
+    std::string out;
+    dumpNode(node, 0, out);
+    out += '\n';
+    return out;
+}
+
+// AstBuilder
+
+uint32_t AstBuilder::nameOf(const Token& token) {
+    auto it = name_ids.find(token.lexeme);
+    if (it != name_ids.end()) {
+        return it->second;
+    }
+    uint32_t id = ast.addName(token.lexeme);
+    name_ids.emplace(ast.name(id), id);
+    return id;
+}
+
+NodeRef AstBuilder::pop() {
+    NodeRef node = nodes.back();
+    nodes.pop_back();
+    return node;
+}
+
+NodeList AstBuilder::popBody(uint32_t base) {
+    NodeList body = ast.addList(nodes.data() + base, nodes.size() - base);
+    nodes.resize(base);
+    return body;
+}
+
+namespace {
+OperatorType operatorOf(const Token& token) {
+    if (token.terminal == terminal::punct(PunctuationType::LANGLE)) {
+        return OperatorType::LESS;
+    }
+    if (token.terminal == terminal::punct(PunctuationType::RANGLE)) {
+        return OperatorType::GREATER;
+    }
+    return static_cast<OperatorType>(token.terminal - terminal::OPERATOR_BASE);
+}
+}
+
+void AstBuilder::onFunctionBegin(SymbolType type, const Token& /*name*/, uint32_t /*index*/) {
+    blocks.push_back(static_cast<uint32_t>(nodes.size()));
+    function_type = type;
+    parameter_count = 0;
+}
+
+void AstBuilder::onFunctionEnd(const Token& name, uint32_t index) {
+    // The parameters, then the body
+    uint32_t base = blocks.back();
+    blocks.pop_back();
+    NodeList body = popBody(base + parameter_count);
+    NodeList parameters = popBody(base);
+    nodes.push_back(ast.add(FunctionNode{nameOf(name), parameters, body, index, function_type}));
+}
+
+void AstBuilder::onParameter(SymbolType type, const Token& name, uint32_t index) {
+    nodes.push_back(ast.add(DeclarationNode{nameOf(name), NodeRef(), index, type}));
+    parameter_count++;
+}
+
+void AstBuilder::onDeclaration(SymbolType type, const Token& name, uint32_t index, bool has_initializer) {
+    NodeRef init = has_initializer ? pop() : NodeRef();
+    nodes.push_back(ast.add(DeclarationNode{nameOf(name), init, index, type}));
+}
+
+void AstBuilder::onAssignment(const Token& name, uint32_t index) {
+    NodeRef value = pop();
+    nodes.push_back(ast.add(AssignmentNode{nameOf(name), value, index}));
+}
+
+void AstBuilder::onLoopBegin(const Token& /*keyword*/, uint32_t /*index*/) {
+    blocks.push_back(static_cast<uint32_t>(nodes.size()));
+}
+
+void AstBuilder::onLoopEnd(const Token& /*keyword*/, uint32_t index) {
+    // The condition, then the body
+    uint32_t base = blocks.back();
+    blocks.pop_back();
+    NodeRef condition = nodes[base];
+    NodeList body = popBody(base + 1);
+    nodes.pop_back();
+    nodes.push_back(ast.add(LoopNode{condition, body, index}));
+}
+
+void AstBuilder::onReturn(const Token& /*keyword*/, uint32_t index) {
+    NodeRef value = pop();
+    nodes.push_back(ast.add(ReturnNode{value, index}));
+}
+
+void AstBuilder::onExpressionStatement(const Token& /*first*/, uint32_t index) {
+    NodeRef expression = pop();
+    nodes.push_back(ast.add(ExpressionStatementNode{expression, index}));
+}
+
+void AstBuilder::onExpressionOperator(const Token& op, uint32_t index) {
+    NodeRef rhs = pop();
+    NodeRef lhs = pop();
+    nodes.push_back(ast.add(BinaryNode{lhs, rhs, index, operatorOf(op)}));
+}
+
+void AstBuilder::onIncrement(const Token& op, uint32_t index) {
+    NodeRef operand = pop();
+    nodes.push_back(ast.add(IncrementNode{operand, index, operatorOf(op)}));
+}
+
+void AstBuilder::onUnaryOperator(const Token& op, uint32_t index) {
+    NodeRef operand = pop();
+    nodes.push_back(ast.add(UnaryNode{operand, index, operatorOf(op)}));
+}
+
+void AstBuilder::onConditional(const Token& /*question*/, uint32_t index) {
+    NodeRef otherwise = pop();
+    NodeRef then = pop();
+    NodeRef condition = pop();
+    nodes.push_back(ast.add(ConditionalNode{condition, then, otherwise, index}));
+}
+
+void AstBuilder::onCallBegin(const Token& /*name*/, uint32_t /*index*/) {
+    // The callee came in as an operand; the call node names it instead
+    nodes.pop_back();
+    blocks.push_back(static_cast<uint32_t>(nodes.size()));
+}
+
+void AstBuilder::onCall(const Token& name, uint32_t index) {
+    NodeList arguments = popBody(blocks.back());
+    blocks.pop_back();
+    nodes.push_back(ast.add(CallNode{nameOf(name), arguments, index}));
+}
+
+void AstBuilder::onIdentifier(const Token& name, uint32_t index) {
+    nodes.push_back(ast.add(IdentifierNode{nameOf(name), index}));
+}
+
+void AstBuilder::onIntegerLiteral(const Token& literal, uint32_t index) {
+    nodes.push_back(ast.add(IntegerLiteralNode{std::strtoll(literal.lexeme.c_str(), nullptr, 10), index}));
+}
+
+void AstBuilder::onFloatLiteral(const Token& literal, uint32_t index) {
+    nodes.push_back(ast.add(FloatLiteralNode{std::strtod(literal.lexeme.c_str(), nullptr), index}));
+}
+
+void AstBuilder::finish() {
+    if (nodes.empty()) {
+        ast.setRoot(NodeRef());
+        return;
+    }
+    uint32_t token = ast.tokenOf(nodes.front()) - 1;
+    NodeList functions = popBody(0);
+    ast.setRoot(ast.add(ProgramNode{functions, token}));
+}
@@ -0,0 +1,66 @@
+#include "compilation_context.h"
+#include <algorithm>
+
+CompilationContext::CompilationContext(const std::string& filename, uint32_t unit_index)
+    : filename(filename), unit_index(unit_index) {
+    reporter.setFileIdBase(unit_index);
+}
+
+void CompilationContext::captureDiagnostics() {
+    reporter.setOutput(&diagnostic_output);
+}
+
+void CompilationAggregator::add(CompilationSummary summary) {
+    std::lock_guard<std::mutex> lock(mutex);
+    results.push_back(std::move(summary));
+}
+
+std::vector<CompilationSummary> CompilationAggregator::getResults() const {
+    std::vector<CompilationSummary> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = results;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const CompilationSummary& a, const CompilationSummary& b) {
+        return a.unit_index < b.unit_index;
+    });
+    return sorted;
+}
+
+int CompilationAggregator::getTotalErrors() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    int total = 0;
+    for (const auto& result : results) {
+        total += result.error_count;
+    }
+    return total;
+}
+
+void CompilationAggregator::writeDiagnostics(FILE* out) const {
+    std::string merged;
+    bool sarif = format == DiagnosticFormat::Sarif;
+    
+    if (sarif) {
+        merged += DiagnosticSerializer::SARIF_LOG_HEADER;
+    }
+    
+    bool first = true;
+    for (const auto& result : getResults()) {
+        if (result.diagnostics.empty()) {
+            continue;
+        }
+        // Each captured SARIF output is one run object
+        if (sarif && !first) {
+            merged += ',';
+        }
+        merged += result.diagnostics;
+        first = false;
+    }
+    
+    if (sarif) {
+        merged += DiagnosticSerializer::SARIF_LOG_FOOTER;
+    }
+    
+    fwrite(merged.data(), 1, merged.size(), out);
+    fflush(out);
+}
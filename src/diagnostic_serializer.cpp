@@ -0,0 +1,243 @@
+#include "diagnostic_serializer.h"
+#include "error.h"
+#include <charconv>
+#include <cstring>
+#include <iterator>
+
+const char* const DiagnosticSerializer::SARIF_LOG_HEADER =
+    "{\"version\":\"2.1.0\","
+    "\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+    "\"runs\":[";
+const char* const DiagnosticSerializer::SARIF_LOG_FOOTER = "]}\n";
+
+DiagnosticSerializer::DiagnosticSerializer(DiagnosticFormat format, FILE* out, std::string* sink)
+    : format(format), out(out), sink(sink) {
+    buffer.reserve(BUFFER_CAPACITY);
+}
+
+DiagnosticSerializer::~DiagnosticSerializer() {
+    finish();
+}
+
+void DiagnosticSerializer::append(const char* text) {
+    buffer.append(text, strlen(text));
+}
+
+void DiagnosticSerializer::appendNumber(uint32_t value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr - digits);
+}
+
+void DiagnosticSerializer::appendEscaped(const char* text, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    
+    buffer += '"';
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+            case '"': buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\n': buffer += "\\n"; break;
+            case '\r': buffer += "\\r"; break;
+            case '\t': buffer += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                    buffer.append(escape, sizeof(escape));
+                } else {
+                    buffer += static_cast<char>(c);
+                }
+        }
+    }
+    buffer += '"';
+}
+
+void DiagnosticSerializer::appendUri(const std::string& path) {
+    static const char hex[] = "0123456789ABCDEF";
+    
+    // Nothing percent-encoded needs JSON escaping
+    buffer += '"';
+    if (!path.empty() && path[0] == '/') {
+        buffer += "file://";
+    }
+    for (char ch : path) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '.' || c == '_' || c == '~' || c == '/') {
+            buffer += ch;
+        } else {
+            char escape[3] = {'%', hex[c >> 4], hex[c & 0xF]};
+            buffer.append(escape, sizeof(escape));
+        }
+    }
+    buffer += '"';
+}
+
+void DiagnosticSerializer::appendArg(const DiagnosticArg& arg, const std::string& strings, bool as_string) {
+    if (arg.kind == DiagnosticArg::Kind::String) {
+        appendEscaped(strings.data() + arg.string_offset, arg.string_length);
+        return;
+    }
+    if (arg.kind == DiagnosticArg::Kind::Char) {
+        appendEscaped(&arg.char_value, 1);
+        return;
+    }
+    
+    // SARIF message arguments are strings; JSON lines keep numbers as numbers
+    if (as_string) {
+        buffer += '"';
+    }
+    auto out = std::back_inserter(buffer);
+    switch (arg.kind) {
+        case DiagnosticArg::Kind::Int: fmt::format_to(out, "{}", arg.int_value); break;
+        case DiagnosticArg::Kind::UInt: fmt::format_to(out, "{}", arg.uint_value); break;
+        default: fmt::format_to(out, "{}", arg.double_value); break;
+    }
+    if (as_string) {
+        buffer += '"';
+    }
+}
+
+void DiagnosticSerializer::begin() {
+    started = true;
+    if (format == DiagnosticFormat::Sarif) {
+        if (!sink) {
+            append(SARIF_LOG_HEADER);
+        }
+        append("{\"tool\":{\"driver\":{\"name\":\"minicompiler\"}},\"results\":[");
+    }
+}
+
+void DiagnosticSerializer::addFile(uint32_t file_id, const std::string& path) {
+    if (!started) {
+        begin();
+    }
+    
+    if (format == DiagnosticFormat::JsonLines) {
+        append("{\"kind\":\"file\",\"id\":");
+        appendNumber(file_id);
+        append(",\"path\":");
+        appendEscaped(path.data(), path.size());
+        append("}\n");
+    } else if (format == DiagnosticFormat::Sarif) {
+        uint32_t index = file_id - file_id_base;
+        if (artifacts.size() <= index) {
+            artifacts.resize(index + 1);
+        }
+        artifacts[index] = path;
+    }
+}
+
+void DiagnosticSerializer::write(DiagnosticId id, uint32_t file_id, uint32_t line, uint32_t column,
+                                 std::string_view message, const DiagnosticArg* args, size_t arg_count,
+                                 const std::string& strings) {
+    if (!started) {
+        begin();
+    }
+    
+    const DiagnosticInfo& info = getDiagnosticInfo(id);
+    const char* severity = "error";
+    if (info.severity == DiagnosticType::Warning) {
+        severity = "warning";
+    } else if (info.severity == DiagnosticType::Note) {
+        severity = "note";
+    }
+    
+    if (format == DiagnosticFormat::JsonLines) {
+        append("{\"kind\":\"diagnostic\",\"severity\":\"");
+        append(severity);
+        append("\",\"id\":\"");
+        append(info.code);
+        append("\",\"file\":");
+        appendNumber(file_id);
+        append(",\"range\":{\"line\":");
+        appendNumber(line);
+        append(",\"column\":");
+        appendNumber(column);
+        append("},\"message\":");
+        appendEscaped(message.data(), message.size());
+        append(",\"args\":[");
+        for (size_t i = 0; i < arg_count; i++) {
+            if (i > 0) {
+                buffer += ',';
+            }
+            appendArg(args[i], strings, false);
+        }
+        append("]}\n");
+    } else if (format == DiagnosticFormat::Sarif) {
+        if (!first_result) {
+            buffer += ',';
+        }
+        first_result = false;
+        
+        append("{\"ruleId\":\"");
+        append(info.code);
+        append("\",\"level\":\"");
+        append(severity);
+        append("\",\"message\":{\"text\":");
+        appendEscaped(message.data(), message.size());
+        if (arg_count > 0) {
+            append(",\"arguments\":[");
+            for (size_t i = 0; i < arg_count; i++) {
+                if (i > 0) {
+                    buffer += ',';
+                }
+                appendArg(args[i], strings, true);
+            }
+            buffer += ']';
+        }
+        append("},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"index\":");
+        appendNumber(file_id - file_id_base);
+        append("},\"region\":{\"startLine\":");
+        appendNumber(line > 0 ? line : 1);
+        append(",\"startColumn\":");
+        appendNumber(column > 0 ? column : 1);
+        append("}}}]}");
+    }
+    
+    if (buffer.size() >= BUFFER_CAPACITY - 1024) {
+        flush();
+    }
+}
+
+void DiagnosticSerializer::finish() {
+    if (finished || format == DiagnosticFormat::Text) {
+        return;
+    }
+    finished = true;
+    
+    if (format == DiagnosticFormat::Sarif) {
+        if (!started) {
+            begin();
+        }
+        append("],\"artifacts\":[");
+        for (size_t i = 0; i < artifacts.size(); i++) {
+            if (i > 0) {
+                buffer += ',';
+            }
+            append("{\"location\":{\"uri\":");
+            appendUri(artifacts[i]);
+            append("}}");
+        }
+        append("]}");
+        if (!sink) {
+            append(SARIF_LOG_FOOTER);
+        }
+    }
+    flush();
+}
+
+void DiagnosticSerializer::flush() {
+    if (buffer.empty()) {
+        return;
+    }
+    
+    if (sink) {
+        sink->append(buffer);
+    } else {
+        fwrite(buffer.data(), 1, buffer.size(), out);
+        fflush(out);
+    }
+    buffer.clear();
+}
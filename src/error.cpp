@@ -2,90 +2,312 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <cstdarg>
+#include <cstdio>
+#include <algorithm>
+#include <charconv>
 
 ErrorReporter errorReporter;
 
 ErrorReporter::~ErrorReporter() {
+    finish();
     cleanup();
 }
 
+// Append an unsigned integer without going through iostreams
+static void appendNumber(std::string& out, uint32_t value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr - digits);
+}
+
 bool ErrorReporter::init(const std::string& src_filename) {
+    // Pending source lines refer to the previous file's buffer
+    flush();
+    
     current_file = src_filename;
     error_count = 0;
-    source_lines.clear();
+    sources.clear();
     
+    // The file itself is only read if a diagnostic needs a source line
     std::ifstream file(src_filename);
-    if (!file.is_open()) {
-        return false;
+    return file.is_open();
+}
+
+void ErrorReporter::setSourceBuffer(std::shared_ptr<const std::string> text) {
+    setSourceBuffer(current_file, std::move(text));
+}
+
+void ErrorReporter::setSourceBuffer(const std::string& filename, std::shared_ptr<const std::string> text) {
+    SourceLines& lines = sources[filename];
+    lines.text = std::move(text);
+    lines.offsets.clear();
+    lines.indexed = false;
+}
+
+void ErrorReporter::setFormat(DiagnosticFormat new_format) {
+    flush();
+    if (serializer) {
+        serializer->finish();
+        serializer.reset();
     }
     
-    std::string line;
-    while (std::getline(file, line)) {
-        source_lines.push_back(line);
+    format = new_format;
+    files.clear();
+    if (format != DiagnosticFormat::Text) {
+        serializer = std::make_unique<DiagnosticSerializer>(format, stderr, output_sink);
+        serializer->setFileIdBase(file_id_base);
+    }
+}
+
+void ErrorReporter::setFileIdBase(uint32_t base) {
+    file_id_base = base;
+    if (serializer) {
+        serializer->setFileIdBase(base);
     }
+}
+
+void ErrorReporter::setOutput(std::string* sink) {
+    flush();
+    output_sink = sink;
+    if (serializer) {
+        serializer->setSink(sink);
+    }
+}
+
+uint32_t ErrorReporter::fileId(const std::string& filename) {
+    // Few files per run, and lookups hit the most recent one
+    for (size_t i = files.size(); i > 0; i--) {
+        if (files[i - 1] == filename) {
+            return file_id_base + static_cast<uint32_t>(i - 1);
+        }
+    }
+    
+    uint32_t id = file_id_base + static_cast<uint32_t>(files.size());
+    files.push_back(filename);
+    serializer->addFile(id, filename);
+    return id;
+}
+
+const ErrorReporter::SourceLines& ErrorReporter::indexSourceLines(const std::string& filename) {
+    SourceLines& lines = sources[filename];
+    if (lines.indexed) {
+        return lines;
+    }
+    lines.indexed = true;
     
-    file.close();
-    return true;
+    // Fall back to reading the file when nobody lent us a buffer
+    if (!lines.text) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return lines;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        lines.text = std::make_shared<const std::string>(contents.str());
+    }
+    
+    const std::string& text = *lines.text;
+    if (text.empty()) {
+        return lines;
+    }
+    
+    lines.offsets.push_back(0);
+    for (size_t pos = text.find('\n'); pos != std::string::npos; pos = text.find('\n', pos + 1)) {
+        lines.offsets.push_back(static_cast<uint32_t>(pos + 1));
+    }
+    
+    // A trailing newline does not start another line
+    if (text.back() == '\n') {
+        lines.offsets.pop_back();
+    }
+    return lines;
 }
 
-void ErrorReporter::printSourceLine(const SourceLocation& loc) {
-    if (loc.line > 0 && loc.line <= source_lines.size()) {
-        const std::string& line = source_lines[loc.line - 1];
-        std::cerr << line << std::endl;
+void ErrorReporter::renderSourceLine(const Diagnostic& diag) {
+    const std::string& filename = pending_files[diag.file_index];
+    if (filename.empty()) {
+        return;
+    }
+    const SourceLines& lines = indexSourceLines(filename);
+    const std::vector<uint32_t>& line_offsets = lines.offsets;
+    
+    if (diag.line > 0 && diag.line <= line_offsets.size()) {
+        const std::string& text = *lines.text;
+        size_t start = line_offsets[diag.line - 1];
+        size_t end = diag.line < line_offsets.size() ? line_offsets[diag.line] - 1 : text.size();
+        if (end > start && text[end - 1] == '\r') {
+            end--;  // CRLF line ending
+        }
+        output.append(text, start, end - start);
+        output += '\n';
         
-        // Print caret pointer
-        for (uint32_t i = 0; i < loc.column; i++) {
-            std::cerr << ' ';
+        // Caret under the 1-based column; tabs before it are kept so it lines up
+        for (size_t i = start; i + 1 < start + diag.column; i++) {
+            output += i < end && text[i] == '\t' ? '\t' : ' ';
+        }
+        output += "^\n";
+    }
+}
+
+void ErrorReporter::renderMessage(DiagnosticId id, uint32_t arg_offset, uint32_t arg_count,
+                                  std::string& out) {
+    format_args.clear();
+    for (uint32_t i = arg_offset; i < arg_offset + arg_count; i++) {
+        const DiagnosticArg& arg = arg_pool[i];
+        switch (arg.kind) {
+            case DiagnosticArg::Kind::Int:
+                format_args.push_back(arg.int_value);
+                break;
+            case DiagnosticArg::Kind::UInt:
+                format_args.push_back(arg.uint_value);
+                break;
+            case DiagnosticArg::Kind::Double:
+                format_args.push_back(arg.double_value);
+                break;
+            case DiagnosticArg::Kind::Char:
+                format_args.push_back(arg.char_value);
+                break;
+            case DiagnosticArg::Kind::String:
+                // Views into the pool, which stays put while rendering
+                format_args.push_back(fmt::string_view(string_pool.data() + arg.string_offset,
+                                                       arg.string_length));
+                break;
         }
-        std::cerr << "^" << std::endl;
     }
+    fmt::vformat_to(std::back_inserter(out), getDiagnosticInfo(id).format, format_args);
 }
 
-void ErrorReporter::reportDiagnostic(DiagnosticType type, const SourceLocation& loc, 
-                                   const char* format, va_list args) {
-    std::cerr << loc.filename << ":" << loc.line << ":" << loc.column << ": ";
+void ErrorReporter::recordDiagnostic(DiagnosticId id, const SourceLocation& loc, uint32_t arg_offset) {
+    if (getDiagnosticInfo(id).severity == DiagnosticType::Error) {
+        error_count++;
+    }
+    uint32_t arg_count = static_cast<uint32_t>(arg_pool.size()) - arg_offset;
     
-    switch (type) {
-        case DiagnosticType::Error:
-            std::cerr << "error: ";
-            error_count++;
-            break;
-        case DiagnosticType::Warning:
-            std::cerr << "warning: ";
-            break;
-        case DiagnosticType::Note:
-            std::cerr << "note: ";
-            break;
+    // Machine-readable formats are streamed as they are produced
+    if (serializer) {
+        output.clear();
+        renderMessage(id, arg_offset, arg_count, output);
+        serializer->write(id, fileId(loc.filename), loc.line, loc.column, output,
+                          arg_pool.data() + arg_offset, arg_count, string_pool);
+        arg_pool.clear();
+        string_pool.clear();
+        return;
     }
     
-    // Format the message using vsnprintf
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    std::cerr << buffer << std::endl;
+    // Diagnostics of one compilation almost always share a file name
+    if (pending_files.empty() || pending_files.back() != loc.filename) {
+        pending_files.push_back(loc.filename);
+    }
+    
+    Diagnostic diag;
+    diag.id = id;
+    diag.file_index = static_cast<uint32_t>(pending_files.size() - 1);
+    diag.line = loc.line;
+    diag.column = loc.column;
+    diag.arg_offset = arg_offset;
+    diag.arg_count = arg_count;
+    diag.sequence = static_cast<uint32_t>(pending.size());
+    pending.push_back(diag);
     
-    printSourceLine(loc);
+    if (auto_flush && pending.size() >= FLUSH_THRESHOLD) {
+        flush();
+    }
 }
 
-void ErrorReporter::error(const SourceLocation& loc, const char* format, ...) {
-    va_list args;
-    va_start(args, format);
-    reportDiagnostic(DiagnosticType::Error, loc, format, args);
-    va_end(args);
+void ErrorReporter::adopt(ErrorReporter& other) {
+    for (const auto& [filename, lines] : other.sources) {
+        if (lines.text && !sources[filename].text) {
+            setSourceBuffer(filename, lines.text);
+        }
+    }
+    for (const Diagnostic& diag : other.pending) {
+        uint32_t arg_offset = static_cast<uint32_t>(arg_pool.size());
+        for (uint32_t i = diag.arg_offset; i < diag.arg_offset + diag.arg_count; i++) {
+            DiagnosticArg arg = other.arg_pool[i];
+            if (arg.kind == DiagnosticArg::Kind::String) {
+                uint32_t offset = arg.string_offset;
+                arg.string_offset = static_cast<uint32_t>(string_pool.size());
+                string_pool.append(other.string_pool, offset, arg.string_length);
+            }
+            arg_pool.push_back(arg);
+        }
+        recordDiagnostic(diag.id, SourceLocation(other.pending_files[diag.file_index], diag.line, diag.column),
+                         arg_offset);
+    }
+    other.pending.clear();
+    other.pending_files.clear();
+    other.arg_pool.clear();
+    other.string_pool.clear();
 }
 
-void ErrorReporter::warning(const SourceLocation& loc, const char* format, ...) {
-    va_list args;
-    va_start(args, format);
-    reportDiagnostic(DiagnosticType::Warning, loc, format, args);
-    va_end(args);
+void ErrorReporter::flush() {
+    if (serializer) {
+        serializer->flush();
+    }
+    if (pending.empty()) {
+        return;
+    }
+    
+    std::stable_sort(pending.begin(), pending.end(), [this](const Diagnostic& a, const Diagnostic& b) {
+        if (a.file_index != b.file_index) {
+            return pending_files[a.file_index] < pending_files[b.file_index];
+        }
+        if (a.line != b.line) {
+            return a.line < b.line;
+        }
+        if (a.column != b.column) {
+            return a.column < b.column;
+        }
+        return a.sequence < b.sequence;
+    });
+    
+    output.clear();
+    output.reserve(string_pool.size() + pending.size() * 128);
+    for (const Diagnostic& diag : pending) {
+        output += pending_files[diag.file_index];
+        output += ':';
+        appendNumber(output, diag.line);
+        output += ':';
+        appendNumber(output, diag.column);
+        output += ": ";
+        
+        switch (getDiagnosticInfo(diag.id).severity) {
+            case DiagnosticType::Error:
+                output += "error: ";
+                break;
+            case DiagnosticType::Warning:
+                output += "warning: ";
+                break;
+            case DiagnosticType::Note:
+                output += "note: ";
+                break;
+        }
+        
+        renderMessage(diag.id, diag.arg_offset, diag.arg_count, output);
+        output += '\n';
+        renderSourceLine(diag);
+    }
+    
+    // One write for the whole batch
+    if (output_sink) {
+        output_sink->append(output);
+    } else {
+        std::cerr.flush();
+        fwrite(output.data(), 1, output.size(), stderr);
+        fflush(stderr);
+    }
+    
+    pending.clear();
+    pending_files.clear();
+    arg_pool.clear();
+    string_pool.clear();
 }
 
-void ErrorReporter::note(const SourceLocation& loc, const char* format, ...) {
-    va_list args;
-    va_start(args, format);
-    reportDiagnostic(DiagnosticType::Note, loc, format, args);
-    va_end(args);
+void ErrorReporter::finish() {
+    flush();
+    if (serializer) {
+        serializer->finish();
+    }
 }
 
 int ErrorReporter::getErrorCount() const {
@@ -93,6 +315,7 @@ int ErrorReporter::getErrorCount() const {
 }
 
 void ErrorReporter::cleanup() {
-    source_lines.clear();
+    flush();
+    sources.clear();
     current_file.clear();
 }
\ No newline at end of file
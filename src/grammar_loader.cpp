@@ -0,0 +1,569 @@
+#include "parser.h"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+// Loading LL(1) grammars from text files such as src/grammar.txt:
+//
+//   // comment
+//   LHS → alt | alt      (or ->)
+//       | alt            (continues the previous rule)
+//
+// Names that appear on a left-hand side are non-terminals, ε is the empty
+// alternative, IDENTIFIER, INTEGER_LITERAL, FLOAT_LITERAL and STRING_LITERAL
+// are token classes, and anything else must be a token spelling. Quote a
+// terminal ('|', '->') to keep it from being read as grammar syntax.
+//
+// Compiled tables are cached next to the grammar in a binary file keyed by
+// the hash of its text, so an unchanged grammar skips FIRST/FOLLOW entirely.
+
+namespace {
+constexpr char CACHE_MAGIC[8] = {'M', 'C', 'L', 'L', 'T', 'A', 'B', '1'};
+constexpr uint64_t CACHE_VERSION = 1;
+
+struct LoadedRule {
+    uint16_t lhs;
+    std::vector<Symbol> rhs;
+    uint32_t line;
+};
+
+// Everything the cache stores
+struct CompiledGrammar {
+    std::vector<std::string> names;
+    std::vector<LoadedRule> rules;
+    std::vector<bool> nullable;
+    std::vector<TerminalSet> first;
+    std::vector<TerminalSet> follow;
+    std::vector<int16_t> predict;
+};
+
+// FNV-1a, seeded so a change to the cache layout or terminal ids invalidates old caches
+uint64_t hashGrammarText(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t byte) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    };
+    mix(CACHE_VERSION);
+    mix(terminal::COUNT);
+    for (unsigned char c : text) {
+        mix(c);
+    }
+    return hash;
+}
+
+// Run-time counterpart of findExpansionCycle() in grammar.h, for grammars
+// whose non-terminal count is only known after loading. Returns the
+// non-terminal and lookahead of the first cycle, or a count of names.
+std::pair<size_t, TerminalId> findExpansionCycle(const CompiledGrammar& grammar) {
+    size_t count = grammar.names.size();
+    enum : uint8_t { UNVISITED, ON_PATH, DONE };
+    std::vector<uint8_t> state;
+    std::vector<std::vector<size_t>> corners(count);
+    std::vector<std::pair<size_t, size_t>> path;  // (non-terminal, next corner)
+
+    for (TerminalId t = 0; t < terminal::COUNT; t++) {
+        auto production = [&](size_t nt) -> const LoadedRule* {
+            int16_t p = grammar.predict[nt * terminal::COUNT + t];
+            return p == GrammarTables::NO_PRODUCTION ? nullptr : &grammar.rules[p];
+        };
+
+        // Non-terminals that vanish on t, to a fixed point
+        std::vector<bool> vanishes(count, false);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t nt = 0; nt < count; nt++) {
+                const LoadedRule* rule = production(nt);
+                if (vanishes[nt] || !rule) {
+                    continue;
+                }
+                bool all_vanish = true;
+                for (size_t i = 0; i < rule->rhs.size() && all_vanish; i++) {
+                    all_vanish = symbol::isNonTerminal(rule->rhs[i]) &&
+                                 vanishes[symbol::nonTerminalIndex(rule->rhs[i])];
+                }
+                if (all_vanish) {
+                    vanishes[nt] = true;
+                    changed = true;
+                }
+            }
+        }
+
+        for (size_t nt = 0; nt < count; nt++) {
+            corners[nt].clear();
+            const LoadedRule* rule = production(nt);
+            for (size_t i = 0; rule && i < rule->rhs.size() && symbol::isNonTerminal(rule->rhs[i]); i++) {
+                size_t corner = symbol::nonTerminalIndex(rule->rhs[i]);
+                corners[nt].push_back(corner);
+                if (!vanishes[corner]) {
+                    break;
+                }
+            }
+        }
+
+        // Iterative DFS; reaching a non-terminal still on the path closes a cycle
+        state.assign(count, UNVISITED);
+        for (size_t root = 0; root < count; root++) {
+            if (state[root] != UNVISITED) {
+                continue;
+            }
+            state[root] = ON_PATH;
+            path.assign(1, {root, 0});
+            while (!path.empty()) {
+                auto& [nt, next] = path.back();
+                if (next == corners[nt].size()) {
+                    state[nt] = DONE;
+                    path.pop_back();
+                    continue;
+                }
+                size_t corner = corners[nt][next++];
+                if (state[corner] == ON_PATH) {
+                    return {corner, t};
+                }
+                if (state[corner] == UNVISITED) {
+                    state[corner] = ON_PATH;
+                    path.push_back({corner, 0});
+                }
+            }
+        }
+    }
+    return {count, 0};
+}
+
+struct Word {
+    std::string text;
+    uint32_t column;
+    bool quoted;
+};
+
+// Split a line into words, dropping // comments
+std::vector<Word> splitWords(const std::string& line) {
+    std::vector<Word> words;
+    size_t i = 0;
+    while (i < line.size()) {
+        if (std::isspace(static_cast<unsigned char>(line[i]))) {
+            i++;
+            continue;
+        }
+        if (line.compare(i, 2, "//") == 0) {
+            break;
+        }
+        size_t start = i;
+        while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i]))) {
+            i++;
+        }
+        std::string text = line.substr(start, i - start);
+        bool quoted = text.size() >= 3 && text.front() == '\'' && text.back() == '\'';
+        if (quoted) {
+            text = text.substr(1, text.size() - 2);
+        }
+        words.push_back({text, static_cast<uint32_t>(start + 1), quoted});
+    }
+    return words;
+}
+
+struct RawRule {
+    std::string lhs;
+    std::vector<Word> rhs;  // Alternatives separated by unquoted "|"
+    uint32_t line;
+};
+
+bool isSeparator(const Word& word) {
+    return !word.quoted && word.text == "|";
+}
+
+bool parseRules(const std::string& text, const std::string& path, ErrorReporter& reporter,
+                std::vector<RawRule>& rules) {
+    std::istringstream lines(text);
+    std::string line;
+    uint32_t line_number = 0;
+    bool ok = true;
+
+    while (std::getline(lines, line)) {
+        line_number++;
+        std::vector<Word> words = splitWords(line);
+        if (words.empty()) {
+            continue;
+        }
+
+        if (isSeparator(words[0])) {
+            if (rules.empty()) {
+                reporter.report(diag::GrammarSyntax{}, SourceLocation(path, line_number, words[0].column),
+                                "alternative before any rule");
+                ok = false;
+                continue;
+            }
+            rules.back().rhs.insert(rules.back().rhs.end(), words.begin(), words.end());
+            continue;
+        }
+
+        if (words.size() < 2 || words[0].quoted || words[1].quoted ||
+            (words[1].text != "→" && words[1].text != "->")) {
+            reporter.report(diag::GrammarSyntax{}, SourceLocation(path, line_number, words[0].column),
+                            "expected 'NAME → symbols'");
+            ok = false;
+            continue;
+        }
+        rules.push_back({words[0].text, std::vector<Word>(words.begin() + 2, words.end()), line_number});
+    }
+    return ok;
+}
+
+// Resolve names, then compute the sets and the prediction table
+bool compileGrammar(const std::string& text, const std::string& path, ErrorReporter& reporter,
+                    CompiledGrammar& out) {
+    std::vector<RawRule> raw;
+    if (!parseRules(text, path, reporter, raw)) {
+        return false;
+    }
+
+    // Built-in names keep their NonTerminal value so the parser's special
+    // cases still apply; new ones are numbered after them
+    std::map<std::string, uint16_t> indices;
+    for (size_t nt = 0; nt < NONTERMINAL_COUNT; nt++) {
+        out.names.push_back(nonTerminalToString(static_cast<NonTerminal>(nt)));
+    }
+    std::map<std::string, uint16_t> builtin_indices;
+    for (size_t nt = 0; nt < NONTERMINAL_COUNT; nt++) {
+        builtin_indices[out.names[nt]] = static_cast<uint16_t>(nt);
+    }
+    for (const RawRule& rule : raw) {
+        if (indices.count(rule.lhs)) {
+            continue;
+        }
+        auto known = builtin_indices.find(rule.lhs);
+        if (known != builtin_indices.end()) {
+            indices[rule.lhs] = known->second;
+        } else if (out.names.size() < symbol::NONTERMINAL_FLAG) {
+            indices[rule.lhs] = static_cast<uint16_t>(out.names.size());
+            out.names.push_back(rule.lhs);
+        }
+    }
+    if (!indices.count(nonTerminalToString(NonTerminal::PROGRAM))) {
+        reporter.report(diag::GrammarMissingStart{}, SourceLocation(path, 0, 0),
+                        nonTerminalToString(NonTerminal::PROGRAM));
+        return false;
+    }
+
+    bool ok = true;
+    for (const RawRule& rule : raw) {
+        LoadedRule current{indices.at(rule.lhs), {}, rule.line};
+        for (const Word& word : rule.rhs) {
+            if (isSeparator(word)) {
+                out.rules.push_back(current);
+                current.rhs.clear();
+                continue;
+            }
+            if (!word.quoted) {
+                auto nt = indices.find(word.text);
+                if (nt != indices.end()) {
+                    current.rhs.push_back(symbol::NONTERMINAL_FLAG | nt->second);
+                    continue;
+                }
+                if (word.text == "ε") {
+                    continue;
+                }
+            }
+
+            TerminalId id = terminal::COUNT;
+            if (word.quoted) {
+                id = terminal::fromSpelling(word.text);
+            } else if (word.text == "IDENTIFIER") {
+                id = terminal::IDENTIFIER;
+            } else if (word.text == "INTEGER_LITERAL") {
+                id = terminal::INTEGER_LITERAL;
+            } else if (word.text == "FLOAT_LITERAL") {
+                id = terminal::FLOAT_LITERAL;
+            } else if (word.text == "STRING_LITERAL") {
+                id = terminal::STRING_LITERAL;
+            } else {
+                id = terminal::fromSpelling(word.text);
+            }
+            if (id == terminal::COUNT) {
+                reporter.report(diag::GrammarUnknownSymbol{}, SourceLocation(path, rule.line, word.column),
+                                word.text);
+                ok = false;
+                continue;
+            }
+            current.rhs.push_back(id);
+        }
+        out.rules.push_back(current);
+    }
+    if (!ok) {
+        return false;
+    }
+    if (out.rules.size() > static_cast<size_t>(INT16_MAX)) {
+        reporter.report(diag::GrammarSyntax{}, SourceLocation(path, 0, 0), "too many productions");
+        return false;
+    }
+
+    // FIRST/FOLLOW through the run-time bitset implementation, read back by id
+    std::vector<Production> productions;
+    for (const LoadedRule& rule : out.rules) {
+        productions.push_back(FirstFollowSets::toProduction(static_cast<NonTerminal>(rule.lhs),
+                                                            rule.rhs.data(), rule.rhs.size()));
+    }
+    FirstFollowSets computed(std::move(productions));
+    size_t count = out.names.size();
+    out.nullable.assign(count, false);
+    out.first.assign(count, TerminalSet());
+    out.follow.assign(count, TerminalSet());
+    for (size_t nt = 0; nt < count; nt++) {
+        for (const std::string& spelling : computed.first_sets[static_cast<NonTerminal>(nt)]) {
+            if (spelling == EPSILON) {
+                out.nullable[nt] = true;
+            } else {
+                out.first[nt].insert(terminal::fromSpelling(spelling));
+            }
+        }
+        for (const std::string& spelling : computed.follow_sets[static_cast<NonTerminal>(nt)]) {
+            out.follow[nt].insert(terminal::fromSpelling(spelling));
+        }
+    }
+
+    // Prediction table, with the same conflict policy as computeGrammarTables()
+    out.predict.assign(count * terminal::COUNT, GrammarTables::NO_PRODUCTION);
+    for (bool by_first : {false, true}) {
+        for (size_t p = 0; p < out.rules.size(); p++) {
+            const LoadedRule& rule = out.rules[p];
+            TerminalSet select;
+            bool nullable = true;
+            for (size_t i = 0; i < rule.rhs.size() && nullable; i++) {
+                Symbol sym = rule.rhs[i];
+                if (symbol::isNonTerminal(sym)) {
+                    select.merge(out.first[symbol::nonTerminalIndex(sym)]);
+                    nullable = out.nullable[symbol::nonTerminalIndex(sym)];
+                } else {
+                    select.insert(sym);
+                    nullable = false;
+                }
+            }
+            if (!by_first) {
+                select = nullable ? out.follow[rule.lhs] : TerminalSet();
+            }
+
+            NonTerminal lhs = static_cast<NonTerminal>(rule.lhs);
+            for (TerminalId t = 0; t < terminal::COUNT; t++) {
+                if (!select.contains(t)) {
+                    continue;
+                }
+                int16_t& cell = out.predict[rule.lhs * terminal::COUNT + t];
+                if (cell != GrammarTables::NO_PRODUCTION && cell != static_cast<int16_t>(p) &&
+                    !isExpectedConflict(lhs, t)) {
+                    reporter.report(diag::ParserConflict{}, SourceLocation(path, rule.line, 1),
+                                    out.names[rule.lhs], terminal::spelling(t));
+                    ok = false;
+                    continue;
+                }
+                cell = static_cast<int16_t>(p);
+            }
+        }
+    }
+
+    // Checked even after a conflict, since the table is complete either way
+    auto [cycle, lookahead] = findExpansionCycle(out);
+    if (cycle != count) {
+        for (const LoadedRule& rule : out.rules) {
+            if (rule.lhs == cycle) {
+                reporter.report(diag::GrammarExpansionCycle{}, SourceLocation(path, rule.line, 1),
+                                out.names[cycle], terminal::spelling(lookahead));
+                break;
+            }
+        }
+        ok = false;
+    }
+    return ok;
+}
+
+// Cache I/O in native byte order; the cache only ever serves the machine that wrote it
+class CacheWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(const std::string& text) {
+        put(static_cast<uint32_t>(text.size()));
+        data += text;
+    }
+
+    std::string data;
+};
+
+class CacheReader {
+public:
+    explicit CacheReader(const std::string& data) : data(data) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (data.size() - pos < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string& text) {
+        uint32_t length;
+        if (!get(length) || data.size() - pos < length) {
+            return false;
+        }
+        text.assign(data, pos, length);
+        pos += length;
+        return true;
+    }
+
+    bool atEnd() const { return pos == data.size(); }
+
+private:
+    const std::string& data;
+    size_t pos = 0;
+};
+
+void writeCache(const std::string& cache_path, uint64_t key, const CompiledGrammar& grammar) {
+    CacheWriter out;
+    out.data.append(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    out.put(key);
+    out.put(static_cast<uint32_t>(grammar.names.size()));
+    for (const std::string& name : grammar.names) {
+        out.putString(name);
+    }
+    out.put(static_cast<uint32_t>(grammar.rules.size()));
+    for (const LoadedRule& rule : grammar.rules) {
+        out.put(rule.lhs);
+        out.put(static_cast<uint16_t>(rule.rhs.size()));
+        for (Symbol sym : rule.rhs) {
+            out.put(sym);
+        }
+    }
+    for (size_t nt = 0; nt < grammar.names.size(); nt++) {
+        out.put(static_cast<uint8_t>(grammar.nullable[nt]));
+        out.put(grammar.first[nt]);
+        out.put(grammar.follow[nt]);
+    }
+    for (int16_t cell : grammar.predict) {
+        out.put(cell);
+    }
+
+    // Write then rename, so a reader never sees half a cache
+    std::string temp_path = cache_path + ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file.write(out.data.data(), static_cast<std::streamsize>(out.data.size()))) {
+        return;
+    }
+    file.close();
+    std::rename(temp_path.c_str(), cache_path.c_str());
+}
+
+bool readCache(const std::string& cache_path, uint64_t key, CompiledGrammar& grammar) {
+    std::ifstream file(cache_path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(CACHE_MAGIC) || std::memcmp(data.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        return false;
+    }
+
+    CacheReader in(data);
+    char magic[sizeof(CACHE_MAGIC)];
+    uint64_t stored_key;
+    uint32_t name_count, rule_count;
+    if (!in.get(magic) || !in.get(stored_key) || stored_key != key || !in.get(name_count) ||
+        name_count >= symbol::NONTERMINAL_FLAG) {
+        return false;
+    }
+    grammar.names.resize(name_count);
+    for (std::string& name : grammar.names) {
+        if (!in.getString(name)) {
+            return false;
+        }
+    }
+    if (!in.get(rule_count) || rule_count > static_cast<uint32_t>(INT16_MAX)) {
+        return false;
+    }
+    grammar.rules.resize(rule_count);
+    for (LoadedRule& rule : grammar.rules) {
+        uint16_t length;
+        if (!in.get(rule.lhs) || rule.lhs >= name_count || !in.get(length)) {
+            return false;
+        }
+        rule.rhs.resize(length);
+        for (Symbol& sym : rule.rhs) {
+            if (!in.get(sym)) {
+                return false;
+            }
+            bool valid = symbol::isNonTerminal(sym) ? symbol::nonTerminalIndex(sym) < name_count
+                                                    : sym < terminal::COUNT;
+            if (!valid) {
+                return false;
+            }
+        }
+        rule.line = 0;
+    }
+    grammar.nullable.assign(name_count, false);
+    grammar.first.resize(name_count);
+    grammar.follow.resize(name_count);
+    for (size_t nt = 0; nt < name_count; nt++) {
+        uint8_t nullable;
+        if (!in.get(nullable) || !in.get(grammar.first[nt]) || !in.get(grammar.follow[nt])) {
+            return false;
+        }
+        grammar.nullable[nt] = nullable != 0;
+    }
+    grammar.predict.resize(static_cast<size_t>(name_count) * terminal::COUNT);
+    for (int16_t& cell : grammar.predict) {
+        if (!in.get(cell) || cell < GrammarTables::NO_PRODUCTION || cell >= static_cast<int16_t>(rule_count)) {
+            return false;
+        }
+    }
+    return in.atEnd();
+}
+}
+
+std::unique_ptr<LL1Grammar> LL1Grammar::load(const std::string& path, ErrorReporter& reporter,
+                                             bool use_cache) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        reporter.report(diag::CannotOpenFile{}, SourceLocation(path, 0, 0), path);
+        return nullptr;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    uint64_t key = hashGrammarText(text);
+    std::string cache_path = path + ".cache";
+    CompiledGrammar compiled;
+    bool hit = use_cache && readCache(cache_path, key, compiled);
+    if (!hit) {
+        compiled = CompiledGrammar();
+        if (!compileGrammar(text, path, reporter, compiled)) {
+            return nullptr;
+        }
+        if (use_cache) {
+            writeCache(cache_path, key, compiled);
+        }
+    }
+
+    std::vector<Production> productions;
+    for (const LoadedRule& rule : compiled.rules) {
+        productions.push_back(FirstFollowSets::toProduction(static_cast<NonTerminal>(rule.lhs),
+                                                            rule.rhs.data(), rule.rhs.size()));
+    }
+    size_t count = compiled.names.size();
+    std::unique_ptr<bool[]> nullable(new bool[count]);
+    for (size_t nt = 0; nt < count; nt++) {
+        nullable[nt] = compiled.nullable[nt];
+    }
+    FirstFollowSets sets(std::move(productions), std::move(compiled.names), nullable.get(),
+                         compiled.first.data(), compiled.follow.data());
+
+    std::unique_ptr<LL1Grammar> grammar(new LL1Grammar(std::move(sets), std::move(compiled.predict),
+                                                        std::move(compiled.follow), count));
+    grammar->from_cache = hit;
+    return grammar;
+}
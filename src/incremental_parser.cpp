@@ -0,0 +1,141 @@
+#include "incremental_parser.h"
+#include <algorithm>
+
+TokenEdit TokenEdit::between(const TokenStream& before, const TokenStream& after) {
+    auto same = [](const Token& a, const Token& b) { return a.terminal == b.terminal && a.lexeme == b.lexeme; };
+    size_t limit = std::min(before.size(), after.size());
+    size_t prefix = 0;
+    while (prefix < limit && same(before[prefix], after[prefix])) {
+        prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < limit - prefix &&
+           same(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix])) {
+        suffix++;
+    }
+    return {static_cast<uint32_t>(prefix), static_cast<uint32_t>(before.size() - suffix),
+            static_cast<uint32_t>(after.size() - suffix)};
+}
+
+namespace {
+
+using StatementSpan = IncrementalParser::StatementSpan;
+
+// AstBuilder that hands the parser the previous tree's statements wherever
+// one starts outside the edit, and records every statement's span for the
+// next reparse
+class ReusingAstBuilder : public AstBuilder {
+public:
+    static constexpr bool REUSES_STATEMENTS = true;
+
+    // edit is null for a full parse, which reuses nothing
+    ReusingAstBuilder(Ast& ast, const std::vector<StatementSpan>& previous, const TokenEdit* edit,
+                      std::unordered_map<std::string_view, uint32_t>& names)
+        : AstBuilder(ast), previous(previous), edit(edit) {
+        name_ids.swap(names);
+    }
+
+    uint32_t onStatementBegin(uint32_t index);
+    void onStatementEnd(uint32_t begin, uint32_t end);
+
+    // Give the name map back, for the names the tree holds
+    void releaseNames(std::unordered_map<std::string_view, uint32_t>& names) { names.swap(name_ids); }
+
+    std::vector<StatementSpan> statements;  // This parse's, by begin
+    size_t reused_statements = 0;
+    size_t reused_tokens = 0;
+
+private:
+    const std::vector<StatementSpan>& previous;
+    const TokenEdit* edit;
+    size_t cursor = 0;         // Statements start in order, so previous is walked once
+    std::vector<size_t> open;  // Statements begun and not yet ended, innermost last
+};
+
+uint32_t ReusingAstBuilder::onStatementBegin(uint32_t index) {
+    if (edit && (index < edit->start || index >= edit->new_end)) {
+        int64_t shift = index < edit->start ? 0 : int64_t(edit->new_end) - int64_t(edit->old_end);
+        uint32_t old_begin = static_cast<uint32_t>(index - shift);
+        while (cursor < previous.size() && previous[cursor].begin < old_begin) {
+            cursor++;
+        }
+        // Every token of it must be on the same side of the edit
+        if (cursor < previous.size() && previous[cursor].begin == old_begin &&
+            (previous[cursor].end <= edit->start || old_begin >= edit->old_end)) {
+            StatementSpan reused = previous[cursor];
+            if (shift != 0) {
+                ast.shiftTokens(reused.node, shift);
+            }
+            nodes.push_back(reused.node);
+
+            // The statements nested in it stay reusable next time
+            for (; cursor < previous.size() && previous[cursor].begin < reused.end; cursor++) {
+                const StatementSpan& nested = previous[cursor];
+                statements.push_back({static_cast<uint32_t>(nested.begin + shift),
+                                      static_cast<uint32_t>(nested.end + shift), nested.node});
+            }
+            reused_statements++;
+            reused_tokens += reused.end - reused.begin;
+            return static_cast<uint32_t>(reused.end + shift);
+        }
+    }
+    open.push_back(statements.size());
+    statements.push_back({index, 0, NodeRef()});
+    return 0;
+}
+
+void ReusingAstBuilder::onStatementEnd(uint32_t /*begin*/, uint32_t end) {
+    StatementSpan& span = statements[open.back()];
+    open.pop_back();
+    span.end = end;
+    span.node = nodes.back();
+}
+
+}
+
+bool IncrementalParser::parse(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable) {
+    ast.clear();
+    names.clear();
+    statements.clear();
+    bool result = run(std::move(tokens), nullptr, reporter, symtable);
+    full_parse_bytes = ast.getBytesUsed();
+    return result;
+}
+
+bool IncrementalParser::reparse(TokenStream tokens, const TokenEdit& edit, ErrorReporter& reporter,
+                                SymbolTable& symtable) {
+    // Replaced nodes stay in the arena until the next full parse
+    bool reusable = valid && parsed_pratt == pratt_expressions && edit.start <= edit.old_end &&
+                    edit.start <= edit.new_end && edit.old_end <= token_count &&
+                    token_count - edit.old_end == tokens.size() - edit.new_end &&
+                    ast.getBytesUsed() <= MAX_GROWTH * full_parse_bytes;
+    if (!reusable) {
+        return parse(std::move(tokens), reporter, symtable);
+    }
+    return run(std::move(tokens), &edit, reporter, symtable);
+}
+
+bool IncrementalParser::run(TokenStream tokens, const TokenEdit* edit, ErrorReporter& reporter,
+                            SymbolTable& symtable) {
+    token_count = tokens.size();
+    Parser parser(std::move(tokens), reporter, symtable);
+    parser.setPrattExpressions(pratt_expressions);
+    ReusingAstBuilder builder(ast, statements, edit, names);
+
+    // Reused nodes may have been moved already, so a failed parse leaves
+    // nothing to reuse
+    valid = parser.parse(builder);
+    stats = parser.getStats();
+    builder.releaseNames(names);
+    reused_statements = builder.reused_statements;
+    reused_tokens = builder.reused_tokens;
+    if (!valid) {
+        ast.setRoot(NodeRef());
+        statements.clear();
+        return false;
+    }
+    builder.finish();
+    statements = std::move(builder.statements);
+    parsed_pratt = pratt_expressions;
+    return true;
+}
@@ -0,0 +1,524 @@
+#include "lalr_parser.h"
+#include <algorithm>
+#include <map>
+
+void CombTable::pack(const std::vector<std::vector<int16_t>>& rows, std::vector<int16_t> row_defaults) {
+    size_t columns = rows.empty() ? 0 : rows[0].size();
+    defaults = std::move(row_defaults);
+    base.assign(rows.size(), 0);
+    values.assign(columns, 0);
+    check.assign(columns, EMPTY);
+    stored_count = 0;
+
+    // Fullest rows first, while the array is still sparse
+    std::vector<std::vector<size_t>> kept(rows.size());
+    std::vector<size_t> order(rows.size());
+    for (size_t r = 0; r < rows.size(); r++) {
+        for (size_t c = 0; c < columns; c++) {
+            if (rows[r][c] != defaults[r]) {
+                kept[r].push_back(c);
+            }
+        }
+        order[r] = r;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return kept[a].size() > kept[b].size(); });
+
+    for (size_t r : order) {
+        if (kept[r].empty()) {
+            continue;  // Never stored, so every column reads the default
+        }
+        size_t at = 0;
+        while (std::any_of(kept[r].begin(), kept[r].end(),
+                           [&](size_t c) { return at + c < check.size() && check[at + c] != EMPTY; })) {
+            at++;
+        }
+        if (at + columns > check.size()) {
+            values.resize(at + columns, 0);
+            check.resize(at + columns, EMPTY);
+        }
+        base[r] = static_cast<uint32_t>(at);
+        for (size_t c : kept[r]) {
+            values[at + c] = rows[r][c];
+            check[at + c] = static_cast<uint16_t>(r);
+        }
+        stored_count += kept[r].size();
+    }
+}
+
+size_t CombTable::bytes() const {
+    return base.size() * sizeof(uint32_t) + defaults.size() * sizeof(int16_t) + values.size() * sizeof(int16_t) +
+           check.size() * sizeof(uint16_t);
+}
+
+namespace {
+
+using Item = uint64_t;  // Production in the high half, dot position in the low
+
+constexpr Item item(size_t production, size_t dot) { return (uint64_t(production) << 32) | dot; }
+constexpr size_t itemProduction(Item it) { return static_cast<size_t>(it >> 32); }
+constexpr size_t itemDot(Item it) { return static_cast<size_t>(it & UINT32_MAX); }
+
+struct State {
+    std::vector<Item> items;  // Kernel first, sorted, then the closure
+    size_t kernel_size = 0;
+    std::map<Symbol, uint32_t> next;
+    std::vector<TerminalSet> lookaheads;  // Per item
+
+    size_t indexOf(Item it) const {
+        return static_cast<size_t>(std::find(items.begin(), items.end(), it) - items.begin());
+    }
+};
+
+// The grammar as Symbols, augmented with production P' → start at the end
+struct LalrGrammar {
+    std::vector<size_t> lhs;
+    std::vector<std::vector<Symbol>> rhs;
+    std::vector<std::vector<size_t>> by_lhs;
+    size_t nonterminal_count = 0;  // Including the augmented start
+
+    // FIRST and nullability of every production's suffix from each dot
+    std::vector<std::vector<TerminalSet>> suffix_first;
+    std::vector<std::vector<bool>> suffix_nullable;
+
+    LalrGrammar(const std::vector<Production>& productions, NonTerminal start) {
+        for (const Production& production : productions) {
+            lhs.push_back(static_cast<size_t>(production.lhs));
+            rhs.push_back(FirstFollowSets::toSymbols(production));
+            nonterminal_count = std::max(nonterminal_count, lhs.back() + 1);
+            for (Symbol sym : rhs.back()) {
+                if (symbol::isNonTerminal(sym)) {
+                    nonterminal_count = std::max(nonterminal_count, symbol::nonTerminalIndex(sym) + 1);
+                }
+            }
+        }
+        lhs.push_back(nonterminal_count++);
+        rhs.push_back({symbol::nt(start)});
+        by_lhs.resize(nonterminal_count);
+        for (size_t p = 0; p < lhs.size(); p++) {
+            by_lhs[lhs[p]].push_back(p);
+        }
+
+        std::vector<bool> nullable(nonterminal_count, false);
+        std::vector<TerminalSet> first(nonterminal_count);
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (size_t p = 0; p < lhs.size(); p++) {
+                bool vanishes = true;
+                for (size_t i = 0; i < rhs[p].size() && vanishes; i++) {
+                    Symbol sym = rhs[p][i];
+                    if (!symbol::isNonTerminal(sym)) {
+                        changed |= first[lhs[p]].insert(sym);
+                        vanishes = false;
+                    } else {
+                        size_t b = symbol::nonTerminalIndex(sym);
+                        changed |= first[lhs[p]].merge(first[b]);
+                        vanishes = nullable[b];
+                    }
+                }
+                if (vanishes && !nullable[lhs[p]]) {
+                    nullable[lhs[p]] = true;
+                    changed = true;
+                }
+            }
+        }
+
+        suffix_first.resize(lhs.size());
+        suffix_nullable.resize(lhs.size());
+        for (size_t p = 0; p < lhs.size(); p++) {
+            size_t length = rhs[p].size();
+            suffix_first[p].assign(length + 1, TerminalSet());
+            suffix_nullable[p].assign(length + 1, true);
+            for (size_t i = length; i-- > 0;) {
+                Symbol sym = rhs[p][i];
+                if (!symbol::isNonTerminal(sym)) {
+                    suffix_first[p][i].insert(sym);
+                    suffix_nullable[p][i] = false;
+                } else {
+                    size_t b = symbol::nonTerminalIndex(sym);
+                    suffix_first[p][i] = first[b];
+                    if (nullable[b]) {
+                        suffix_first[p][i].merge(suffix_first[p][i + 1]);
+                    }
+                    suffix_nullable[p][i] = nullable[b] && suffix_nullable[p][i + 1];
+                }
+            }
+        }
+    }
+
+    size_t augmented() const { return lhs.size() - 1; }
+
+    // Symbol after the item's dot; false at the end of the production
+    bool symbolAfterDot(Item it, Symbol& sym) const {
+        const std::vector<Symbol>& symbols = rhs[itemProduction(it)];
+        if (itemDot(it) >= symbols.size()) {
+            return false;
+        }
+        sym = symbols[itemDot(it)];
+        return true;
+    }
+
+    // Kernel items plus every production of a non-terminal after a dot
+    void close(State& state) const {
+        std::vector<bool> added(nonterminal_count, false);
+        for (size_t i = 0; i < state.items.size(); i++) {
+            Symbol sym;
+            if (symbolAfterDot(state.items[i], sym) && symbol::isNonTerminal(sym) &&
+                !added[symbol::nonTerminalIndex(sym)]) {
+                added[symbol::nonTerminalIndex(sym)] = true;
+                for (size_t p : by_lhs[symbol::nonTerminalIndex(sym)]) {
+                    if (std::find(state.items.begin(), state.items.begin() + state.kernel_size, item(p, 0)) ==
+                        state.items.begin() + state.kernel_size) {
+                        state.items.push_back(item(p, 0));
+                    }
+                }
+            }
+        }
+    }
+};
+
+}
+
+std::vector<Production> LalrTables::builtinProductions() {
+    using NT = NonTerminal;
+    using Rhs = std::vector<std::variant<NonTerminal, std::string, TokenType>>;
+    const TokenType ID = TokenType::Identifier;
+    return {
+        Production(NT::PROGRAM, Rhs{NT::FUNCTION_LIST}),
+        // Lists are left-recursive. Comma lists are never empty: the
+        // productions that hold one have a form without it.
+        Production(NT::FUNCTION_LIST, Rhs{NT::FUNCTION_LIST, NT::FUNCTION}),
+        Production(NT::FUNCTION_LIST, Rhs{NT::FUNCTION}),
+        Production(NT::FUNCTION, Rhs{NT::TYPE, ID, "(", ")", "{", NT::STATEMENT_LIST, "}"}),
+        Production(NT::FUNCTION, Rhs{NT::TYPE, ID, "(", NT::PARAMETER_LIST, ")", "{", NT::STATEMENT_LIST, "}"}),
+        Production(NT::PARAMETER_LIST, Rhs{NT::PARAMETER_LIST, ",", NT::PARAMETER}),
+        Production(NT::PARAMETER_LIST, Rhs{NT::PARAMETER}),
+        Production(NT::PARAMETER, Rhs{NT::TYPE, ID}),
+        Production(NT::STATEMENT_LIST, Rhs{NT::STATEMENT_LIST, NT::STATEMENT}),
+        Production(NT::STATEMENT_LIST, Rhs{EPSILON}),
+        Production(NT::STATEMENT, Rhs{NT::DECLARATION}),
+        Production(NT::STATEMENT, Rhs{NT::ASSIGNMENT}),
+        Production(NT::STATEMENT, Rhs{NT::LOOP}),
+        Production(NT::STATEMENT, Rhs{NT::RETURN_STMT}),
+        Production(NT::STATEMENT, Rhs{NT::EXPRESSION, ";"}),
+        Production(NT::DECLARATION, Rhs{NT::TYPE, ID, ";"}),
+        Production(NT::DECLARATION, Rhs{NT::TYPE, ID, "=", NT::EXPRESSION, ";"}),
+        Production(NT::TYPE, Rhs{"int"}),
+        Production(NT::TYPE, Rhs{"float"}),
+        Production(NT::ASSIGNMENT, Rhs{ID, "=", NT::EXPRESSION, ";"}),
+        Production(NT::LOOP, Rhs{"while", "(", NT::CONDITION, ")", "{", NT::STATEMENT_LIST, "}"}),
+        Production(NT::CONDITION, Rhs{NT::EXPRESSION, NT::RELATIONAL_OP, NT::EXPRESSION}),
+        Production(NT::RELATIONAL_OP, Rhs{"<"}),
+        Production(NT::RELATIONAL_OP, Rhs{">"}),
+        Production(NT::RELATIONAL_OP, Rhs{"<="}),
+        Production(NT::RELATIONAL_OP, Rhs{">="}),
+        Production(NT::RELATIONAL_OP, Rhs{"=="}),
+        Production(NT::RELATIONAL_OP, Rhs{"!="}),
+        Production(NT::RETURN_STMT, Rhs{"return", NT::EXPRESSION, ";"}),
+        // Left-recursive, so operators associate to the left without tails
+        Production(NT::EXPRESSION, Rhs{NT::EXPRESSION, "+", NT::TERM}),
+        Production(NT::EXPRESSION, Rhs{NT::EXPRESSION, "-", NT::TERM}),
+        Production(NT::EXPRESSION, Rhs{NT::TERM}),
+        Production(NT::TERM, Rhs{NT::TERM, "*", NT::FACTOR}),
+        Production(NT::TERM, Rhs{NT::TERM, "/", NT::FACTOR}),
+        Production(NT::TERM, Rhs{NT::FACTOR}),
+        Production(NT::FACTOR, Rhs{ID}),
+        Production(NT::FACTOR, Rhs{ID, "++"}),
+        Production(NT::FACTOR, Rhs{ID, "--"}),
+        Production(NT::FACTOR, Rhs{ID, "(", ")"}),
+        Production(NT::FACTOR, Rhs{ID, "(", NT::ARGUMENT_LIST, ")"}),
+        Production(NT::FACTOR, Rhs{TokenType::IntegerLiteral}),
+        Production(NT::FACTOR, Rhs{TokenType::FloatLiteral}),
+        Production(NT::FACTOR, Rhs{"(", NT::EXPRESSION, ")"}),
+        Production(NT::ARGUMENT_LIST, Rhs{NT::ARGUMENT_LIST, ",", NT::EXPRESSION}),
+        Production(NT::ARGUMENT_LIST, Rhs{NT::EXPRESSION}),
+    };
+}
+
+const LalrTables& LalrTables::builtin() {
+    static const std::unique_ptr<LalrTables> tables = [] {
+        ErrorReporter reporter;
+        return build(FirstFollowSets(builtinProductions()), NonTerminal::PROGRAM, reporter);
+    }();
+    return *tables;
+}
+
+std::unique_ptr<LalrTables> LalrTables::build(const FirstFollowSets& sets, NonTerminal start,
+                                              ErrorReporter& reporter, const std::string& source) {
+    LalrGrammar grammar(sets.grammar, start);
+
+    // LR(0) automaton: states are identified by their kernels
+    std::vector<State> states(1);
+    std::map<std::vector<Item>, uint32_t> by_kernel;
+    states[0].items = {item(grammar.augmented(), 0)};
+    states[0].kernel_size = 1;
+    by_kernel[states[0].items] = 0;
+    for (size_t s = 0; s < states.size(); s++) {
+        grammar.close(states[s]);
+        std::map<Symbol, std::vector<Item>> successors;
+        for (Item it : states[s].items) {
+            Symbol sym;
+            if (grammar.symbolAfterDot(it, sym)) {
+                successors[sym].push_back(item(itemProduction(it), itemDot(it) + 1));
+            }
+        }
+        for (auto& [sym, kernel] : successors) {
+            std::sort(kernel.begin(), kernel.end());
+            auto found = by_kernel.find(kernel);
+            if (found == by_kernel.end()) {
+                found = by_kernel.emplace(kernel, static_cast<uint32_t>(states.size())).first;
+                State state;
+                state.items = kernel;
+                state.kernel_size = kernel.size();
+                states.push_back(std::move(state));
+            }
+            states[s].next[sym] = found->second;
+        }
+    }
+
+    // LALR(1) lookaheads: spread them through each state's closure and on to
+    // its successors' kernels until nothing changes
+    for (State& state : states) {
+        state.lookaheads.assign(state.items.size(), TerminalSet());
+    }
+    states[0].lookaheads[0].insert(terminal::END_OF_FILE);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (State& state : states) {
+            for (bool spreading = true; spreading;) {
+                spreading = false;
+                for (size_t i = 0; i < state.items.size(); i++) {
+                    Symbol sym;
+                    if (!grammar.symbolAfterDot(state.items[i], sym) || !symbol::isNonTerminal(sym)) {
+                        continue;
+                    }
+                    size_t p = itemProduction(state.items[i]);
+                    size_t after = itemDot(state.items[i]) + 1;
+                    TerminalSet follow = grammar.suffix_first[p][after];
+                    if (grammar.suffix_nullable[p][after]) {
+                        follow.merge(state.lookaheads[i]);
+                    }
+                    for (size_t q : grammar.by_lhs[symbol::nonTerminalIndex(sym)]) {
+                        spreading |= state.lookaheads[state.indexOf(item(q, 0))].merge(follow);
+                    }
+                }
+            }
+            for (size_t i = 0; i < state.items.size(); i++) {
+                Symbol sym;
+                if (grammar.symbolAfterDot(state.items[i], sym)) {
+                    State& target = states[state.next[sym]];
+                    Item advanced = item(itemProduction(state.items[i]), itemDot(state.items[i]) + 1);
+                    changed |= target.lookaheads[target.indexOf(advanced)].merge(state.lookaheads[i]);
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<LalrTables> tables(new LalrTables(sets));
+    tables->state_count = states.size();
+    tables->nonterminal_count = grammar.nonterminal_count - 1;
+    tables->accept_production = static_cast<int>(grammar.augmented());
+    if (states.size() >= static_cast<size_t>(INT16_MAX) || grammar.lhs.size() >= static_cast<size_t>(INT16_MAX)) {
+        reporter.report(diag::GrammarSyntax{}, SourceLocation(source, 0, 0), "too many LALR(1) states");
+        return nullptr;
+    }
+    for (size_t p = 0; p < grammar.lhs.size(); p++) {
+        tables->lhs_of.push_back(static_cast<NonTerminal>(grammar.lhs[p]));
+        tables->rhs_length.push_back(static_cast<uint8_t>(grammar.rhs[p].size()));
+    }
+
+    auto productionText = [&](size_t p) {
+        std::string text = grammar.lhs[p] == grammar.augmented() ? sets.nameOf(start) + "'"
+                                                                  : sets.nameOf(tables->lhs_of[p]);
+        text += " →";
+        for (Symbol sym : grammar.rhs[p]) {
+            text += " ";
+            text += symbol::isNonTerminal(sym) ? sets.nameOf(static_cast<NonTerminal>(symbol::nonTerminalIndex(sym)))
+                                               : terminal::spelling(sym);
+        }
+        return text;
+    };
+
+    // Dense rows first, then compressed
+    std::vector<std::vector<int16_t>> action_rows(states.size(), std::vector<int16_t>(terminal::COUNT, ERROR));
+    std::vector<int16_t> default_reductions(states.size(), ERROR);
+    bool conflicts = false;
+    for (size_t s = 0; s < states.size(); s++) {
+        std::vector<int16_t>& row = action_rows[s];
+        for (const auto& [sym, target] : states[s].next) {
+            if (!symbol::isNonTerminal(sym)) {
+                row[sym] = static_cast<int16_t>(target + 1);
+            }
+        }
+        std::map<int16_t, size_t> reductions;
+        for (size_t i = 0; i < states[s].items.size(); i++) {
+            Item it = states[s].items[i];
+            size_t p = itemProduction(it);
+            if (itemDot(it) != grammar.rhs[p].size()) {
+                continue;
+            }
+            int16_t reduce = static_cast<int16_t>(-static_cast<int>(p) - 1);
+            for (TerminalId t = 0; t < terminal::COUNT; t++) {
+                if (!states[s].lookaheads[i].contains(t)) {
+                    continue;
+                }
+                if (row[t] != ERROR) {
+                    bool shift = row[t] > 0;
+                    std::string detail = shift ? "shift or reduce by " + productionText(p)
+                                               : "reduce by " + productionText(-row[t] - 1) + " or by " +
+                                                     productionText(p);
+                    reporter.report(diag::GrammarLalrConflict{}, SourceLocation(source, 0, 0),
+                                    shift ? "shift/reduce" : "reduce/reduce", s, terminal::spelling(t), detail);
+                    conflicts = true;
+                    continue;
+                }
+                row[t] = reduce;
+                reductions[reduce]++;
+            }
+        }
+
+        // The commonest reduction also stands in for errors; they surface
+        // in the state the reduction leads to
+        size_t most = 0;
+        for (const auto& [reduce, count] : reductions) {
+            if (count > most) {
+                most = count;
+                default_reductions[s] = reduce;
+            }
+        }
+    }
+    if (conflicts) {
+        return nullptr;
+    }
+    for (size_t s = 0; s < states.size(); s++) {
+        if (default_reductions[s] != ERROR) {
+            std::replace(action_rows[s].begin(), action_rows[s].end(), ERROR, default_reductions[s]);
+        }
+    }
+    tables->actions.pack(action_rows, default_reductions);
+
+    std::vector<std::vector<int16_t>> goto_rows(tables->nonterminal_count, std::vector<int16_t>(states.size(), -1));
+    std::vector<int16_t> default_gotos(tables->nonterminal_count, -1);
+    for (size_t s = 0; s < states.size(); s++) {
+        for (const auto& [sym, target] : states[s].next) {
+            if (symbol::isNonTerminal(sym) && symbol::nonTerminalIndex(sym) < tables->nonterminal_count) {
+                goto_rows[symbol::nonTerminalIndex(sym)][s] = static_cast<int16_t>(target);
+            }
+        }
+    }
+    for (size_t nt = 0; nt < tables->nonterminal_count; nt++) {
+        std::map<int16_t, size_t> targets;
+        for (int16_t target : goto_rows[nt]) {
+            if (target >= 0) {
+                targets[target]++;
+            }
+        }
+        size_t most = 0;
+        for (const auto& [target, count] : targets) {
+            if (count > most) {
+                most = count;
+                default_gotos[nt] = target;
+            }
+        }
+        // Unused cells are never read, so they may as well be the default
+        std::replace(goto_rows[nt].begin(), goto_rows[nt].end(), int16_t(-1), default_gotos[nt]);
+    }
+    tables->gotos.pack(goto_rows, default_gotos);
+    return tables;
+}
+
+size_t LalrTables::denseTableBytes() const {
+    return state_count * (terminal::COUNT + nonterminal_count) * sizeof(int16_t);
+}
+
+namespace {
+std::string expectedName(TerminalId t) {
+    switch (t) {
+        case terminal::IDENTIFIER: return "identifier";
+        case terminal::INTEGER_LITERAL: return "integer literal";
+        case terminal::FLOAT_LITERAL: return "float literal";
+        case terminal::END_OF_FILE: return "end of file";
+        default: return std::string("'") + terminal::spelling(t) + "'";
+    }
+}
+}
+
+bool LalrParser::parse() {
+    if (!begin()) {
+        return false;
+    }
+
+    // Reductions pop one state per right-hand-side symbol, so the stack
+    // holds the open constructs and no predicted ones
+    stats = ParseStats();
+    std::vector<uint32_t> states{0};
+    while (true) {
+        stats.steps++;
+        stats.max_stack_depth = std::max(stats.max_stack_depth, states.size());
+        uint32_t state = states.back();
+
+        // "main" is an identifier unless the state is waiting for it
+        TerminalId next = lookahead();
+        if (next == terminal::IDENTIFIER && tables.expects(state, terminal::MAIN) && current_token->lexeme == "main") {
+            next = terminal::MAIN;
+        }
+
+        int16_t act = tables.action(state, next);
+        if (act > 0) {
+            match(next);
+            states.push_back(static_cast<uint32_t>(act - 1));
+        } else if (act < 0) {
+            int production = -act - 1;
+            if (production == tables.acceptProduction()) {
+                return finish();
+            }
+            states.resize(states.size() - tables.rhsLength(production));
+            states.push_back(tables.go(states.back(), tables.lhs(production)));
+        } else {
+            if (panic.reportable()) {
+                reportUnexpected(state);
+            }
+            if (!recover(states)) {
+                return false;
+            }
+        }
+    }
+}
+
+bool LalrParser::recover(std::vector<uint32_t>& states) {
+    if (!resynchronize()) {
+        return false;
+    }
+    // Only the state inside an open block, past its statements so far,
+    // shifts '}'; what is above it is the broken statement
+    constexpr TerminalId RBRACE = terminal::punct(PunctuationType::RBRACE);
+    while (!states.empty()) {
+        uint32_t state = states.back();
+        if (tables.expects(state, RBRACE) && tables.action(state, RBRACE) > 0) {
+            return true;
+        }
+        states.pop_back();
+    }
+    return false;
+}
+
+void LalrParser::reportUnexpected(uint32_t state) {
+    std::vector<TerminalId> expected;
+    for (TerminalId t = 0; t < terminal::COUNT; t++) {
+        if (tables.expects(state, t) && tables.action(state, t) != LalrTables::ERROR) {
+            expected.push_back(t);
+        }
+    }
+    if (expected.size() == 1) {
+        reportExpectedTerminal(error_reporter, *current_token, expected[0]);
+        return;
+    }
+    std::string list;
+    for (TerminalId t : expected) {
+        if (!list.empty()) {
+            list += ", ";
+        }
+        list += expectedName(t);
+    }
+    error_reporter.report(diag::UnexpectedTokenExpecting{}, current_token->loc, current_token->lexeme, list);
+}
@@ -1,4 +1,6 @@
 #include "lexer.h"
+#include "compilation_context.h"
+#include "source_manager.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -41,60 +43,44 @@ const std::unordered_map<std::string, KeywordType> Lexer::keywords = {
     {"return", KeywordType::Return}
 };
 
-Lexer::Lexer(std::string filename) {
-    source = fopen(filename.c_str(), "r");
-    if (!source) {
+Lexer::Lexer(std::string filename) : Lexer(filename, errorReporter) {}
+
+Lexer::Lexer(const std::string& filename, ErrorReporter& reporter)
+    : error_reporter(reporter), filename(filename) {
+    start(SourceManager::readFile(filename));
+}
+
+Lexer::Lexer(const std::string& filename, CompilationContext& context)
+    : error_reporter(context.getReporter()), filename(filename) {
+    const SourceFile* file = context.getSourceManager().load(filename);
+    start(file ? file->text : nullptr);
+}
+
+void Lexer::start(std::shared_ptr<const std::string> text) {
+    line = 1;
+    column = 1;
+    pos = 0;
+    
+    if (!text) {
         SourceLocation loc(filename, 0, 0);
-        errorReporter.error(loc, "Cannot open source file '%s'", filename.c_str());
+        error_reporter.report(diag::CannotOpenFile{}, loc, filename);
         buffer = nullptr;
         buffer_size = 0;
+        current_char = '\0';
         return;
     }
     
-    fseek(source, 0, SEEK_END);
-    buffer_size = ftell(source);
-    fseek(source, 0, SEEK_SET);
-    
-    // Allocate buffer and read file
-    buffer = new char[buffer_size + 1];
-    if (buffer) {
-        size_t bytes_read = fread(buffer, 1, buffer_size, source);
-        buffer[bytes_read] = '\0';  // Null terminate
-        
-        if (bytes_read < buffer_size) {
-            SourceLocation loc(filename, 0, 0);
-            errorReporter.warning(loc, "File read incomplete: expected %zu bytes, got %zu", 
-                                buffer_size, bytes_read);
-            buffer_size = bytes_read;
-        }
-    } else {
-        SourceLocation loc(filename, 0, 0);
-        errorReporter.error(loc, "Memory allocation failed for file '%s'", filename.c_str());
-        buffer_size = 0;
-    }
-    
-    line = 1;
-    column = 1;
-    
-    // Initialize error reporter with filename
-    errorReporter.init(filename);
+    source_text = std::move(text);
+    buffer = source_text->c_str();
+    buffer_size = source_text->size();
     
-    if (buffer && buffer_size > 0) {
-        current_char = buffer[0];
-    } else {
-        current_char = '\0';
-    }
-    pos = 0;  // Initialize position counter
-}
-
-Lexer::~Lexer() {
-    if (source) {
-        fclose(source);
+    // Point the error reporter at this file, reusing our copy of its contents
+    if (error_reporter.getCurrentFile() != filename) {
+        error_reporter.init(filename);
     }
+    error_reporter.setSourceBuffer(source_text);
     
-    if (buffer) {
-        delete[] buffer;
-    }
+    current_char = buffer_size > 0 ? buffer[0] : '\0';
 }
 
 void Lexer::advance() {
@@ -122,7 +108,7 @@ void Lexer::skipWhitespace() {
 Token Lexer::identifier() {
     Token token;
     std::string id;
-    SourceLocation loc(errorReporter.getCurrentFile(), line, column);
+    SourceLocation loc(filename, line, column);
     
     // Record starting location
     token.loc = loc;
@@ -150,7 +136,7 @@ Token Lexer::identifier() {
 Token Lexer::number() {
     Token token;
     std::string num_str;
-    SourceLocation loc(errorReporter.getCurrentFile(), line, column);
+    SourceLocation loc(filename, line, column);
     bool is_float = false;
     
     token.loc = loc;
@@ -187,8 +173,14 @@ Token Lexer::number() {
     return token;
 }
 
+void Lexer::emit(TokenStream& tokens, Token token) {
+    // Resolved once here so the parser never has to look at the lexeme
+    token.terminal = classifyTerminal(token);
+    tokens.add(std::move(token));
+}
+
 TokenStream Lexer::tokenize() {
-    std::vector<Token> tokens;
+    TokenStream tokens;
     
     while (current_char != '\0') {
         skipWhitespace();
@@ -197,23 +189,23 @@ TokenStream Lexer::tokenize() {
             break;  // End of file
         }
         
-        SourceLocation loc(errorReporter.getCurrentFile(), line, column);
+        SourceLocation loc(filename, line, column);
         Token token;
         token.loc = loc;
         
         if (isalpha(current_char) || current_char == '_') {
             // Identifier or keyword
-            tokens.push_back(identifier());
+            emit(tokens, identifier());
         }
         else if (isdigit(current_char)) {
             // Number
-            tokens.push_back(number());
+            emit(tokens, number());
         }
         else if (current_char == '"') {
             // String literal
             advance();  // Skip opening quote
             std::string string_value;
-            loc = SourceLocation(errorReporter.getCurrentFile(), line, column);
+            loc = SourceLocation(filename, line, column);
             
             while (current_char != '"' && current_char != '\0') {
                 if (current_char == '\\') {
@@ -225,7 +217,7 @@ TokenStream Lexer::tokenize() {
                         case '\\': string_value += '\\'; break;
                         case '"': string_value += '"'; break;
                         default:
-                            errorReporter.error(loc, "Invalid escape sequence '\\%c'", current_char);
+                            error_reporter.report(diag::InvalidEscape{}, loc, current_char);
                             // Include the character literally, with the backslash
                             string_value += '\\';
                             string_value += current_char;
@@ -237,12 +229,12 @@ TokenStream Lexer::tokenize() {
                 }
             }
             if (current_char == '\0') {
-                errorReporter.error(loc, "Unterminated string literal");
+                error_reporter.report(diag::UnterminatedString{}, loc);
                 token.type = TokenType::Error;
                 token.lexeme = ""; // Empty lexeme for error token
                 
                 // Add the error token to the token stream
-                tokens.push_back(token);
+                emit(tokens, token);
                 
                 // Force recovery - attempt to continue at the next line if possible
                 while (current_char != '\0' && current_char != '\n') {
@@ -269,7 +261,7 @@ TokenStream Lexer::tokenize() {
                 token.value.string_value = str_value;
                 
                 // Add the string literal token to the token stream
-                tokens.push_back(token);
+                emit(tokens, token);
             }
             continue;
         }
@@ -417,7 +409,7 @@ TokenStream Lexer::tokenize() {
                         }
                         
                         if (!comment_ended) {
-                            errorReporter.error(loc, "Unterminated multi-line comment");
+                            error_reporter.report(diag::UnterminatedComment{}, loc);
                         }
                         continue;  // Skip creating token for comments
                     } else if (current_char == '=') {
@@ -587,27 +579,27 @@ TokenStream Lexer::tokenize() {
                     
                 default:
                     // Unrecognized character
-                    errorReporter.error(loc, "Unexpected character '%c'", current_char);
+                    error_reporter.report(diag::UnexpectedCharacter{}, loc, current_char);
                     token.type = TokenType::Error;
                     token.lexeme = std::string(1, current_char);
                     advance();
                     
                     // Always add the error token to the token stream
-                    tokens.push_back(token);
+                    emit(tokens, token);
                     continue; // Skip the check below
             }
             
             // Only regular tokens (non-errors) reach here
-            tokens.push_back(token);
+            emit(tokens, token);
         }
     }
     
     // Add EOF token
     Token eof_token;
     eof_token.type = TokenType::Eof;
-    eof_token.loc = SourceLocation(errorReporter.getCurrentFile(), line, column);
+    eof_token.loc = SourceLocation(filename, line, column);
     eof_token.lexeme = "<EOF>";
-    tokens.push_back(eof_token);
+    emit(tokens, eof_token);
     
-    return TokenStream(tokens);
+    return tokens;
 }
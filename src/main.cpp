@@ -3,56 +3,80 @@
 #include "error.h"
 #include "parser.h"
 #include "symbol_table.h"
+#include "compilation_context.h"
+#include "recursive_descent_parser.h"
+#include "lalr_parser.h"
+#include "parallel_parser.h"
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <thread>
 #include <string>
 #include <vector>
 #include <algorithm>
 
+// Which parser runs the syntax analysis
+enum class ParserChoice {
+    LL1,
+    RecursiveDescent,
+    Lalr
+};
+
+// Parse steps kept for --trace-file: the last 2^22 (32 MB)
+constexpr unsigned TRACE_FILE_LOG2 = 22;
+
 // Options struct to store command line flags
 struct Options {
     bool show_tokens = false;
     bool show_parse_table = false;
     bool show_parse_steps = false;
     bool show_symbol_table = false;
+    bool show_ast = false;
     bool verbose = false;
-    std::string input_file = "";
+    DiagnosticFormat diagnostics_format = DiagnosticFormat::Text;
+    std::string grammar_file;  // Empty for the built-in grammar
+    std::string trace_file;    // Binary parse trace to write; empty for none
+    ParserChoice parser = ParserChoice::LL1;
+    bool pratt_expressions = false;
+    bool parallel_functions = false;
+    std::vector<std::string> input_files;
 };
 
-void printToken(const Token& token) {
-    std::cout << "Token: " << token.lexeme << " | ";
+void printToken(const Token& token, std::ostream& out = std::cout) {
+    out << "Token: " << token.lexeme << " | ";
     
     switch (token.type) {
         case TokenType::Keyword:
-            std::cout << "Type: Keyword";
+            out << "Type: Keyword";
             break;
         case TokenType::Identifier:
-            std::cout << "Type: Identifier";
+            out << "Type: Identifier";
             break;
         case TokenType::IntegerLiteral:
-            std::cout << "Type: IntegerLiteral, Value: " << token.value.int_value;
+            out << "Type: IntegerLiteral, Value: " << token.value.int_value;
             break;
         case TokenType::FloatLiteral:
-            std::cout << "Type: FloatLiteral, Value: " << token.value.float_value;
+            out << "Type: FloatLiteral, Value: " << token.value.float_value;
             break;
         case TokenType::StringLiteral:
-            std::cout << "Type: StringLiteral, Value: " << token.value.string_value;
+            out << "Type: StringLiteral, Value: " << token.value.string_value;
             break;
         case TokenType::Operator:
-            std::cout << "Type: Operator";
+            out << "Type: Operator";
             break;
         case TokenType::Punctuation:
-            std::cout << "Type: Punctuation";
+            out << "Type: Punctuation";
             break;
         case TokenType::Eof:
-            std::cout << "Type: EOF";
+            out << "Type: EOF";
             break;
         case TokenType::Error:
-            std::cout << "Type: Error";
+            out << "Type: Error";
             break;
     }
     
-    std::cout << " | Line: " << token.loc.line << ", Column: " << token.loc.column << std::endl;
+    out << " | Line: " << token.loc.line << ", Column: " << token.loc.column << std::endl;
 }
 
 // Simple function to create a test source file
@@ -82,13 +106,27 @@ void createTestFile(const std::string& filename) {
 }
 
 void printUsage(const char* programName) {
-    std::cout << "Usage: " << programName << " [options] [input_file]\n"
+    std::cout << "Usage: " << programName << " [options] [input_file...]\n"
               << "Options:\n"
               << "  --show-tokens       Display lexical tokens\n"
               << "  --show-parse-table  Display the LL(1) parse table\n"
               << "  --show-parse-steps  Show detailed parsing steps\n"
               << "  --show-symbol-table Show symbol table contents after parsing\n"
-              << "  --verbose           Enable verbose output for all stages\n" 
+              << "  --show-ast          Show the syntax tree after parsing\n"
+              << "  --verbose           Enable verbose output for all stages\n"
+              << "  --diagnostics-format=text|jsonl|sarif\n"
+              << "                      Format of diagnostics written to stderr\n"
+              << "  --parser=ll1|rd|lalr\n"
+              << "                      Table-driven LL(1) parser (default), recursive descent,\n"
+              << "                      or the LALR(1) shift-reduce parser\n"
+              << "  --grammar=FILE      Parse with the LL(1) grammar in FILE (see src/grammar.txt)\n"
+              << "  --pratt-expressions Parse expressions by operator precedence, accepting\n"
+              << "                      every C operator (LL(1) parser only)\n"
+              << "  --parallel-functions\n"
+              << "                      Parse each function on its own thread (LL(1) parser\n"
+              << "                      with the built-in grammar only)\n"
+              << "  --trace-file=FILE   Record the LL(1) parser's steps in FILE, in binary;\n"
+              << "                      decode it with minicompiler_tracedump\n"
               << "  --help              Display this help message\n"
               << std::endl;
 }
@@ -107,14 +145,50 @@ Options parseCommandLine(int argc, char* argv[]) {
             options.show_parse_steps = true;
         } else if (arg == "--show-symbol-table") {
             options.show_symbol_table = true;
+        } else if (arg == "--show-ast") {
+            options.show_ast = true;
         } else if (arg == "--verbose") {
             options.verbose = true;
+        } else if (arg.rfind("--diagnostics-format=", 0) == 0) {
+            std::string format = arg.substr(arg.find('=') + 1);
+            if (format == "text") {
+                options.diagnostics_format = DiagnosticFormat::Text;
+            } else if (format == "jsonl") {
+                options.diagnostics_format = DiagnosticFormat::JsonLines;
+            } else if (format == "sarif") {
+                options.diagnostics_format = DiagnosticFormat::Sarif;
+            } else {
+                std::cerr << "Unknown diagnostics format: " << format << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
+        } else if (arg.rfind("--parser=", 0) == 0) {
+            std::string parser = arg.substr(arg.find('=') + 1);
+            if (parser == "ll1") {
+                options.parser = ParserChoice::LL1;
+            } else if (parser == "rd") {
+                options.parser = ParserChoice::RecursiveDescent;
+            } else if (parser == "lalr") {
+                options.parser = ParserChoice::Lalr;
+            } else {
+                std::cerr << "Unknown parser: " << parser << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
+        } else if (arg.rfind("--grammar=", 0) == 0) {
+            options.grammar_file = arg.substr(arg.find('=') + 1);
+        } else if (arg == "--pratt-expressions") {
+            options.pratt_expressions = true;
+        } else if (arg == "--parallel-functions") {
+            options.parallel_functions = true;
+        } else if (arg.rfind("--trace-file=", 0) == 0) {
+            options.trace_file = arg.substr(arg.find('=') + 1);
         } else if (arg == "--help") {
             printUsage(argv[0]);
             exit(0);
         } else if (arg[0] != '-') {
-            // Assume it's the input file
-            options.input_file = arg;
+            // Assume it's an input file
+            options.input_files.push_back(arg);
         } else {
             std::cerr << "Unknown option: " << arg << std::endl;
             printUsage(argv[0]);
@@ -122,54 +196,54 @@ Options parseCommandLine(int argc, char* argv[]) {
         }
     }
     
-    return options;
-}
-
-int main(int argc, char* argv[]) {
-    // Parse command line arguments
-    Options options = parseCommandLine(argc, argv);
-    
-    // If verbose is set, enable all other options
-    if (options.verbose) {
-        options.show_tokens = true;
-        options.show_parse_table = true;
-        options.show_parse_steps = true;
-        options.show_symbol_table = true;
+    // The recursive-descent and LALR parsers are written for the built-in grammar
+    if (options.parser != ParserChoice::LL1 && !options.grammar_file.empty()) {
+        std::cerr << "--grammar requires --parser=ll1" << std::endl;
+        exit(1);
     }
-    
-    std::string filename;
-    
-    if (!options.input_file.empty()) {
-        filename = options.input_file;
-        std::cout << "Using file: " << filename << std::endl;
-    } else {
-        filename = "test_program.c";
-        createTestFile(filename);
+    if (options.parser != ParserChoice::LL1 && options.pratt_expressions) {
+        std::cerr << "--pratt-expressions requires --parser=ll1" << std::endl;
+        exit(1);
+    }
+    if (options.parallel_functions &&
+        (options.parser != ParserChoice::LL1 || !options.grammar_file.empty() || !options.trace_file.empty())) {
+        std::cerr << "--parallel-functions requires --parser=ll1 with the built-in grammar and no trace file"
+                  << std::endl;
+        exit(1);
     }
     
-    errorReporter.init(filename);
+    return options;
+}
+
+// Run the front end over one file inside its own compilation context.
+// Progress messages go to out so concurrent compilations can be kept apart.
+bool compileFile(const Options& options, const LL1Grammar& grammar, CompilationContext& context,
+                 std::ostream& out) {
+    const std::string& filename = context.getFilename();
+    ErrorReporter& reporter = context.getReporter();
+    SymbolTable& symbolTable = context.getSymbolTable();
     
-    // Initialize symbol table
-    SymbolTable symbolTable;
+    reporter.setFormat(options.diagnostics_format);
+    reporter.init(filename);
     
     // Lexical analysis
     if (options.show_tokens || options.verbose) {
-        std::cout << "\n=== LEXICAL ANALYSIS ===\n" << std::endl;
+        out << "\n=== LEXICAL ANALYSIS ===\n" << std::endl;
     }
     
-    Lexer lexer(filename);
+    Lexer lexer(filename, context);
     TokenStream tokenStream = lexer.tokenize();
     
     // Store a copy of the token stream for the parser
     TokenStream parserTokens = tokenStream;
     
     if (options.show_tokens) {
-        std::cout << "Tokens in " << filename << ":" << std::endl;
-        std::cout << "----------------------------------------" << std::endl;
+        out << "Tokens in " << filename << ":" << std::endl;
+        out << "----------------------------------------" << std::endl;
         
         while (!tokenStream.isAtEnd()) {
             Token& token = tokenStream.peek();
-            printToken(token);
+            printToken(token, out);
             tokenStream.advance();
         }
         
@@ -187,56 +261,209 @@ int main(int argc, char* argv[]) {
             }
         }
         
-        std::cout << "----------------------------------------" << std::endl;
-        std::cout << "Statistics:" << std::endl;
-        std::cout << "Identifiers: " << identifiers << std::endl;
-        std::cout << "Keywords: " << keywords << std::endl;
-        std::cout << "Errors: " << errorReporter.getErrorCount() << std::endl;
+        out << "----------------------------------------" << std::endl;
+        out << "Statistics:" << std::endl;
+        out << "Identifiers: " << identifiers << std::endl;
+        out << "Keywords: " << keywords << std::endl;
+        out << "Errors: " << reporter.getErrorCount() << std::endl;
     }
     
+    bool success = false;
+    ParallelParser parallel;
+    
     // Only proceed to parsing if there are no lexical errors
-    if (errorReporter.getErrorCount() == 0) {
-        std::cout << "\n=== SYNTAX ANALYSIS ===\n" << std::endl;
-        
-        // Create the parser with the symbol table
-        Parser parser(parserTokens, errorReporter, symbolTable);
+    if (reporter.getErrorCount() == 0) {
+        out << "\n=== SYNTAX ANALYSIS ===\n" << std::endl;
         
-        // Enable verbose mode for detailed output if specified
-        parser.setVerbose(options.show_parse_steps);
-        
-        // Display FIRST and FOLLOW sets if verbose
-        if (options.verbose) {
-            std::cout << "Computing FIRST and FOLLOW sets..." << std::endl;
-            const FirstFollowSets& sets = parser.getFirstFollowSets();
-            sets.printSets();
+        if (options.parser == ParserChoice::RecursiveDescent) {
+            out << "\nStarting recursive-descent parsing..." << std::endl;
+            RecursiveDescentParser parser(parserTokens, context);
+            success = parser.parse();
+        } else if (options.parser == ParserChoice::Lalr) {
+            out << "\nStarting LALR(1) parsing..." << std::endl;
+            LalrParser parser(parserTokens, context);
+            success = parser.parse();
+        } else if (options.parallel_functions) {
+            out << "\nStarting LL(1) parsing per function on " << parallel.getThreadCount() << " threads..."
+                << std::endl;
+            parallel.setPrattExpressions(options.pratt_expressions);
+            success = parallel.parse(parserTokens, reporter, symbolTable);
+        } else {
+            // Create the parser with the context's reporter and symbol table
+            Parser parser(parserTokens, context, grammar);
+            
+            // Enable verbose mode for detailed output if specified
+            parser.setVerbose(options.show_parse_steps);
+            parser.setPrattExpressions(options.pratt_expressions);
+            
+            // Display FIRST and FOLLOW sets if verbose
+            if (options.verbose) {
+                out << "Computing FIRST and FOLLOW sets..." << std::endl;
+                const FirstFollowSets& sets = parser.getFirstFollowSets();
+                sets.printSets();
+            }
+            
+            // Display parsing table if requested
+            if (options.show_parse_table) {
+                out << "\nLL(1) Parsing Table:" << std::endl;
+                parser.printParseTable();
+            }
+            
+            // Start parsing
+            out << "\nStarting LL(1) Parsing..." << std::endl;
+            if (options.trace_file.empty()) {
+                success = parser.parse();
+            } else {
+                // Several inputs each get their own trace, numbered by input
+                std::string path = options.trace_file;
+                if (options.input_files.size() > 1) {
+                    path += "." + std::to_string(context.getUnitIndex());
+                }
+                RingTrace trace(TRACE_FILE_LOG2);
+                success = parser.parseTraced(trace);
+                if (!trace.save(path, &grammar == &LL1Grammar::builtin())) {
+                    out << "Could not write the parse trace to " << path << std::endl;
+                }
+            }
         }
-        
-        // Display parsing table if requested
-        if (options.show_parse_table) {
-            std::cout << "\nLL(1) Parsing Table:" << std::endl;
-            parser.printParseTable();
+        // Calls can only be checked once every function is known; the
+        // parallel parser has checked them itself
+        if (success && !options.parallel_functions) {
+            symbolTable.getFunctions().check(reporter);
         }
-        
-        // Start parsing
-        std::cout << "\nStarting LL(1) Parsing..." << std::endl;
-        bool parseSuccess = parser.parse();
+        reporter.flush();
         
         // Check result
-        if (parseSuccess) {
-            std::cout << "\nParsing completed successfully." << std::endl;
+        if (success) {
+            out << "\nParsing completed successfully." << std::endl;
             
             // Display symbol table if requested
             if (options.show_symbol_table) {
-                std::cout << "\n=== SYMBOL TABLE ===\n" << std::endl;
+                out << "\n=== SYMBOL TABLE ===\n" << std::endl;
                 symbolTable.printTable();
             }
+            
+            if (options.show_ast) {
+                out << "\n=== AST ===\n" << std::endl;
+                const Ast& ast = context.getAst();
+                if (options.parallel_functions) {
+                    out << parallel.dump();
+                } else if (ast.getRoot().isValid()) {
+                    out << ast.dump();
+                } else {
+                    out << "(only the LL(1) parser with the built-in grammar builds a tree)" << std::endl;
+                }
+            }
         } else {
-            std::cout << "\nParsing failed with " << errorReporter.getErrorCount() 
-                      << " syntax errors." << std::endl;
+            out << "\nParsing failed with " << reporter.getErrorCount() 
+                << " syntax errors." << std::endl;
         }
     } else {
-        std::cout << "\nSkipping parsing due to lexical errors." << std::endl;
+        reporter.flush();
+        out << "\nSkipping parsing due to lexical errors." << std::endl;
+    }
+    
+    reporter.finish();
+    return success;
+}
+
+int main(int argc, char* argv[]) {
+    // Parse command line arguments
+    Options options = parseCommandLine(argc, argv);
+    
+    // If verbose is set, enable all other options
+    if (options.verbose) {
+        options.show_tokens = true;
+        options.show_parse_table = true;
+        options.show_parse_steps = true;
+        options.show_symbol_table = true;
+        options.show_ast = true;
+    }
+    
+    // A grammar file is loaded once and shared by every compilation. Problems
+    // with it are setup errors, so they are always reported as text.
+    std::unique_ptr<LL1Grammar> loaded_grammar;
+    if (!options.grammar_file.empty()) {
+        ErrorReporter reporter;
+        reporter.init(options.grammar_file);
+        loaded_grammar = LL1Grammar::load(options.grammar_file, reporter);
+        reporter.flush();
+        if (!loaded_grammar) {
+            return 1;
+        }
+    }
+    const LL1Grammar& grammar = loaded_grammar ? *loaded_grammar : LL1Grammar::builtin();
+    
+    if (options.input_files.empty()) {
+        options.input_files.push_back("test_program.c");
+        createTestFile(options.input_files.back());
     }
     
+    // A single file reports straight to the terminal
+    if (options.input_files.size() == 1) {
+        const std::string& filename = options.input_files.front();
+        std::cout << "Using file: " << filename << std::endl;
+        
+        CompilationContext context(filename);
+        compileFile(options, grammar, context, std::cout);
+        return 0;
+    }
+    
+    // Several files each get their own context; their diagnostics are
+    // captured and merged in input order once every compilation is done
+    CompilationAggregator aggregator(options.diagnostics_format);
+    std::vector<std::ostringstream> logs(options.input_files.size());
+    
+    auto compileUnit = [&](uint32_t index) {
+        CompilationContext context(options.input_files[index], index);
+        context.captureDiagnostics();
+        logs[index] << "Using file: " << context.getFilename() << std::endl;
+        bool success = compileFile(options, grammar, context, logs[index]);
+        aggregator.add({index, context.getFilename(), context.getReporter().getErrorCount(),
+                        success, context.getDiagnosticOutput()});
+    };
+    
+    // The debug views print straight to stdout, so only run quiet builds concurrently
+    bool concurrent = !options.show_tokens && !options.show_parse_table &&
+                      !options.show_parse_steps && !options.show_symbol_table && !options.show_ast;
+    if (concurrent) {
+        // At most one worker per hardware thread, each taking the next file
+        // in input order until none are left
+        std::atomic<uint32_t> next{0};
+        auto work = [&]() {
+            for (uint32_t i = next++; i < options.input_files.size(); i = next++) {
+                compileUnit(i);
+            }
+        };
+        size_t worker_count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                               options.input_files.size());
+        std::vector<std::thread> workers;
+        for (size_t w = 1; w < worker_count; w++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    } else {
+        for (uint32_t i = 0; i < options.input_files.size(); i++) {
+            compileUnit(i);
+        }
+    }
+    
+    for (const auto& log : logs) {
+        std::cout << log.str();
+    }
+    aggregator.writeDiagnostics(stderr);
+    
+    int failed = 0;
+    for (const auto& result : aggregator.getResults()) {
+        if (!result.success) {
+            failed++;
+        }
+    }
+    std::cout << "\nCompiled " << options.input_files.size() << " files: "
+              << failed << " failed, " << aggregator.getTotalErrors() << " errors in total." << std::endl;
+    
     return 0;
-}
\ No newline at end of file
+}
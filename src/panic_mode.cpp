@@ -0,0 +1,43 @@
+#include "panic_mode.h"
+
+bool PanicMode::reportable() {
+    if (matched_since_recovery < RECOVERY_TOKENS) {
+        return false;
+    }
+    syntax_errors++;
+    return true;
+}
+
+bool PanicMode::dropsMissing(size_t position) {
+    if (position == resume_position || syntax_errors >= max_errors) {
+        return false;
+    }
+    matched_since_recovery = 0;
+    resume_position = position;
+    return true;
+}
+
+bool PanicMode::resynchronize(TokenStream& tokens, ErrorReporter& reporter, SemanticActions& actions) {
+    if (syntax_errors >= max_errors) {
+        reporter.report(diag::TooManyErrors{}, tokens.peek().loc, syntax_errors);
+        return false;
+    }
+    actions.abandonDeclaration();
+
+    // Always move on if the last recovery has not got past this token
+    if (tokens.position() == resume_position || !tokens.atSyncPoint()) {
+        tokens.synchronize(true);
+    }
+    if (tokens.peek().type == TokenType::Eof) {
+        return false;
+    }
+    // Just past a ';' the next statement starts cleanly; a keyword or '}'
+    // may still sit inside the broken construct
+    matched_since_recovery = 0;
+    if (tokens.peek().terminal == terminal::op(OperatorType::SEMICOLON)) {
+        tokens.advance();
+        matched_since_recovery = RECOVERY_TOKENS;
+    }
+    resume_position = tokens.position();
+    return true;
+}
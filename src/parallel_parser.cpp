@@ -0,0 +1,148 @@
+#include "parallel_parser.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+std::vector<ParallelParser::FunctionSpan> ParallelParser::findFunctions(const TokenStream& tokens) {
+    constexpr TerminalId LPAREN = terminal::punct(PunctuationType::LPAREN);
+    constexpr TerminalId LBRACE = terminal::punct(PunctuationType::LBRACE);
+    constexpr TerminalId RBRACE = terminal::punct(PunctuationType::RBRACE);
+    if (tokens.size() == 0 || tokens[tokens.size() - 1].terminal != terminal::END_OF_FILE) {
+        return {};
+    }
+
+    std::vector<FunctionSpan> spans;
+    size_t end = tokens.size() - 1;
+    size_t begin = 0;
+    while (begin < end) {
+        // TYPE IDENTIFIER ( ... ) then the body's '{', with no statement or
+        // block in between
+        TerminalId type = tokens[begin].terminal;
+        if ((type != terminal::keyword(KeywordType::Int) && type != terminal::keyword(KeywordType::Float)) ||
+            begin + 2 >= end || tokens[begin + 1].terminal != terminal::IDENTIFIER ||
+            tokens[begin + 2].terminal != LPAREN) {
+            return {};
+        }
+        size_t open = begin + 3;
+        while (open < end && tokens[open].terminal != LBRACE) {
+            if (tokens[open].terminal == RBRACE || tokens[open].terminal == terminal::op(OperatorType::SEMICOLON)) {
+                return {};
+            }
+            open++;
+        }
+        size_t close = open < end ? tokens.matchingBrace(open) : end;
+        if (close >= end) {
+            return {};
+        }
+        spans.push_back({static_cast<uint32_t>(begin), static_cast<uint32_t>(close + 1)});
+        begin = close + 1;
+    }
+    return spans;
+}
+
+ParallelParser::ParallelParser(unsigned threads)
+    : thread_count(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+bool ParallelParser::parse(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable) {
+    units.clear();
+    trees.clear();
+    stats = ParseStats();
+    std::vector<FunctionSpan> spans = reporter.getErrorCount() == 0 ? findFunctions(tokens)
+                                                                     : std::vector<FunctionSpan>();
+    split = !spans.empty();
+    if (!split) {
+        // One tree for everything, parsed as Parser::parse() would
+        units.push_back(std::make_unique<Unit>());
+        trees.push_back(std::make_unique<Ast>());
+        Unit& unit = *units.back();
+        unit.span = {0, static_cast<uint32_t>(tokens.size())};
+        unit.ast = trees.back().get();
+        Parser parser(std::move(tokens), reporter, symtable);
+        parser.setPrattExpressions(pratt_expressions);
+        AstBuilder builder(*unit.ast);
+        success = parser.parse(builder);
+        stats = parser.getStats();
+        if (success) {
+            builder.finish();
+            unit.root = unit.ast->getRoot();
+            symtable.getFunctions().check(reporter);
+        }
+        return success;
+    }
+
+    for (const FunctionSpan& span : spans) {
+        units.push_back(std::make_unique<Unit>());
+        units.back()->span = span;
+    }
+
+    // Workers take the next function in source order until none are left
+    std::atomic<size_t> next{0};
+    auto work = [&](Ast& ast) {
+        for (size_t u = next++; u < units.size(); u = next++) {
+            parseFunction(*units[u], tokens, ast);
+        }
+    };
+    size_t worker_count = std::min<size_t>(thread_count, units.size());
+    for (size_t w = 0; w < worker_count; w++) {
+        trees.push_back(std::make_unique<Ast>());
+    }
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < worker_count; w++) {
+        workers.emplace_back(work, std::ref(*trees[w]));
+    }
+    work(*trees[0]);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Merged in source order, so diagnostics come out in the order a
+    // sequential parse reports them
+    success = true;
+    for (const auto& unit : units) {
+        reporter.adopt(unit->reporter);
+        symtable.getFunctions().merge(std::move(unit->symbols.getFunctions()));
+        success &= unit->success;
+        stats.steps += unit->stats.steps;
+        stats.max_stack_depth = std::max(stats.max_stack_depth, unit->stats.max_stack_depth);
+    }
+    if (success) {
+        symtable.getFunctions().check(reporter);
+    }
+    return success;
+}
+
+void ParallelParser::parseFunction(Unit& unit, TokenStream& tokens, Ast& ast) const {
+    // The function alone, as a program ending where the whole one does.
+    // No other worker touches its tokens, and every worker only reads the
+    // end-of-file token.
+    TokenStream own;
+    for (uint32_t i = unit.span.begin; i < unit.span.end; i++) {
+        own.add(std::move(tokens[i]));
+    }
+    own.add(tokens[tokens.size() - 1]);
+
+    unit.reporter.setAutoFlush(false);
+    Parser parser(std::move(own), unit.reporter, unit.symbols);
+    parser.setPrattExpressions(pratt_expressions);
+    AstBuilder builder(ast);
+    unit.ast = &ast;
+    unit.success = parser.parse(builder);
+    unit.stats = parser.getStats();
+    if (unit.success) {
+        builder.finish();
+        unit.root = ast.getRoot();
+        ast.shiftTokens(unit.root, unit.span.begin);
+    }
+}
+
+std::string ParallelParser::dump() const {
+    if (!success) {
+        return "";
+    }
+    std::string out;
+    for (const auto& unit : units) {
+        out += unit->ast->dump(unit->root);
+    }
+    return out;
+}
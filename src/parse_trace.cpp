@@ -0,0 +1,164 @@
+#include "parse_trace.h"
+#include "parser.h"
+#include <cstring>
+#include <fstream>
+
+namespace {
+constexpr char TRACE_MAGIC[8] = {'M', 'C', 'T', 'R', 'A', 'C', 'E', '1'};
+
+// File layout: magic, flags, record count, dropped count, then the records
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t flags;  // Bit 0: built-in grammar
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t dropped;
+};
+
+const char* choiceText(TraceChoice choice) {
+    switch (choice) {
+        case TraceChoice::ListEndsAtBrace: return "} found, using epsilon for STATEMENT_LIST";
+        case TraceChoice::ListContinues: return "Statement found, using STATEMENT STATEMENT_LIST for STATEMENT_LIST";
+        case TraceChoice::ListEnds: return "No statement start found, using epsilon for STATEMENT_LIST";
+        case TraceChoice::Declaration: return "Type found, using DECLARATION for STATEMENT";
+        case TraceChoice::Assignment: return "Assignment found, using ASSIGNMENT for STATEMENT";
+        case TraceChoice::ExpressionStatement: return "Expression statement found, using EXPRESSION ; for STATEMENT";
+        case TraceChoice::Loop: return "While found, using LOOP for STATEMENT";
+        case TraceChoice::Return: return "Return found, using RETURN_STMT for STATEMENT";
+        case TraceChoice::NoStatement: return "No matching statement type, using epsilon for STATEMENT";
+    }
+    return "Unknown choice";
+}
+}
+
+std::vector<TraceRecord> RingTrace::snapshot() const {
+    std::vector<TraceRecord> out;
+    out.reserve(size());
+    for (uint64_t i = written - size(); i < written; i++) {
+        out.push_back(records[i & mask]);
+    }
+    return out;
+}
+
+bool RingTrace::save(const std::string& path, bool builtin_grammar) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    TraceFileHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.flags = builtin_grammar ? 1 : 0;
+    header.count = size();
+    header.dropped = dropped();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<TraceRecord> held = snapshot();
+    out.write(reinterpret_cast<const char*>(held.data()), held.size() * sizeof(TraceRecord));
+    return static_cast<bool>(out);
+}
+
+bool SavedTrace::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    TraceFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        return false;
+    }
+    builtin_grammar = (header.flags & 1) != 0;
+    dropped = header.dropped;
+    records.resize(header.count);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(records.data()), header.count * sizeof(TraceRecord)));
+}
+
+std::string TraceDecoder::lexeme(uint32_t token, TerminalId fallback) const {
+    if (tokens) {
+        return token < tokens->size() ? (*tokens)[token].lexeme : std::string();
+    }
+    return fallback < terminal::COUNT ? terminal::spelling(fallback) : "#" + std::to_string(token);
+}
+
+std::string TraceDecoder::nonTerminalName(uint16_t nonterm) const {
+    return sets ? sets->nameOf(static_cast<NonTerminal>(nonterm)) : "#" + std::to_string(nonterm);
+}
+
+std::string TraceDecoder::decode(const TraceRecord& record) const {
+    std::string out;
+    switch (record.event) {
+        case TraceEvent::Start: {
+            bool at_end = tokens ? record.token >= tokens->size() : record.value != 0;
+            std::string type = "?";  // Unknown without the tokens
+            if (tokens) {
+                type = std::to_string(static_cast<int>(at_end ? TokenType::Eof : (*tokens)[record.token].type));
+            }
+            out += "Token stream status: ";
+            out += at_end ? "empty" : "has tokens";
+            out += "\nCurrent token: " + lexeme(record.token, terminal::COUNT) + " (type: " + type + ")\n";
+            break;
+        }
+        case TraceEvent::Expand:
+            out += "Processing non-terminal: " + nonTerminalName(record.value) + "\n";
+            break;
+        case TraceEvent::Choice:
+            out += choiceText(static_cast<TraceChoice>(record.value));
+            out += '\n';
+            break;
+        case TraceEvent::Production: {
+            if (!sets || record.value >= sets->grammar.size()) {
+                out += "Using production: #" + std::to_string(record.value) + "\n";
+                break;
+            }
+            const Production& production = sets->grammar[record.value];
+            out += "Using production: " + sets->nameOf(production.lhs) + " →";
+            for (const auto& symbol : production.rhs) {
+                if (std::holds_alternative<std::string>(symbol)) {
+                    out += " " + std::get<std::string>(symbol);
+                } else if (std::holds_alternative<TokenType>(symbol)) {
+                    out += " [TokenType:" + std::to_string(static_cast<int>(std::get<TokenType>(symbol))) + "]";
+                } else {
+                    out += " " + sets->nameOf(std::get<NonTerminal>(symbol));
+                }
+            }
+            out += '\n';
+            break;
+        }
+        case TraceEvent::Match: {
+            TerminalId matched = record.value;
+            if (matched == terminal::punct(PunctuationType::LBRACE)) {
+                out += "Entering new scope at {\n";
+            } else if (matched == terminal::punct(PunctuationType::RBRACE)) {
+                out += "Exiting scope at }\n";
+            } else if (matched == terminal::keyword(KeywordType::Int) ||
+                       matched == terminal::keyword(KeywordType::Float)) {
+                out += "Type declaration: " + std::string(terminal::spelling(matched)) + "\n";
+            } else if (matched == terminal::op(OperatorType::SEMICOLON)) {
+                // Statement ends are implied by what follows
+            } else if (terminal::isTokenClass(matched)) {
+                int type = static_cast<int>(TokenType::Identifier) + (matched - terminal::IDENTIFIER);
+                out += "Matched token type: " + std::to_string(type) + "\n";
+            } else {
+                out += "Matched token: " + lexeme(record.token, matched) + "\n";
+            }
+            break;
+        }
+        case TraceEvent::Capture:
+            out += "Captured identifier for declaration: " + lexeme(record.token, terminal::COUNT) + "\n";
+            break;
+        case TraceEvent::Declare:
+            out += "Adding symbol to table: " + lexeme(record.token, terminal::COUNT) + " of type " +
+                   (static_cast<SymbolType>(record.value) == SymbolType::INT ? "int" : "float") + "\n";
+            break;
+        case TraceEvent::Recover:
+            out += "Recovered at " + lexeme(record.token, terminal::COUNT) + "\n";
+            break;
+    }
+    return out;
+}
+
+void TraceDecoder::print(const std::vector<TraceRecord>& records, uint64_t dropped, std::ostream& out) const {
+    if (dropped > 0) {
+        out << "(" << dropped << " earlier parse steps not recorded)" << std::endl;
+    }
+    for (const TraceRecord& record : records) {
+        out << decode(record);
+    }
+    out.flush();
+}
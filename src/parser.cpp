@@ -37,319 +37,250 @@ std::string getTokenSymbol(const Token& token) {
 
 // FirstFollowSets implementation
 FirstFollowSets::FirstFollowSets() {
-    // Initialize grammar and compute sets
     initializeGrammar();
+    
+    // The sets themselves were computed at compile time
+    assignSets(NONTERMINAL_COUNT, GRAMMAR_TABLES.nullable, GRAMMAR_TABLES.first, GRAMMAR_TABLES.follow);
+}
+
+FirstFollowSets::FirstFollowSets(std::vector<Production> productions)
+    : grammar(std::move(productions)) {
     computeFirstSets();
     computeFollowSets();
 }
 
+FirstFollowSets::FirstFollowSets(std::vector<Production> productions, std::vector<std::string> names,
+                                 const bool* nullable, const TerminalSet* first, const TerminalSet* follow)
+    : grammar(std::move(productions)), nonterminal_names(std::move(names)) {
+    assignSets(nonterminal_names.size(), nullable, first, follow);
+}
+
+const FirstFollowSets& FirstFollowSets::builtin() {
+    return LL1Grammar::builtin().getSets();
+}
+
+void FirstFollowSets::assignSets(size_t count, const bool* nullable, const TerminalSet* first,
+                                 const TerminalSet* follow) {
+    first_sets.clear();
+    follow_sets.clear();
+    for (size_t nt = 0; nt < count; nt++) {
+        std::set<std::string>& first_view = first_sets[static_cast<NonTerminal>(nt)];
+        std::set<std::string>& follow_view = follow_sets[static_cast<NonTerminal>(nt)];
+        for (TerminalId t = 0; t < terminal::COUNT; t++) {
+            if (first[nt].contains(t)) {
+                first_view.insert(terminal::spelling(t));
+            }
+            if (follow[nt].contains(t)) {
+                follow_view.insert(terminal::spelling(t));
+            }
+        }
+        if (nullable[nt]) {
+            first_view.insert(EPSILON);
+        }
+    }
+}
+
 void FirstFollowSets::addProduction(const Production& prod) {
     grammar.push_back(prod);
 }
 
+Production FirstFollowSets::toProduction(NonTerminal lhs, const Symbol* rhs, size_t length) {
+    // Token classes become TokenType, other terminals their spelling
+    std::vector<std::variant<NonTerminal, std::string, TokenType>> symbols;
+    for (size_t i = 0; i < length; i++) {
+        Symbol sym = rhs[i];
+        if (symbol::isNonTerminal(sym)) {
+            symbols.push_back(static_cast<NonTerminal>(symbol::nonTerminalIndex(sym)));
+        } else if (sym == terminal::IDENTIFIER) {
+            symbols.push_back(TokenType::Identifier);
+        } else if (sym == terminal::INTEGER_LITERAL) {
+            symbols.push_back(TokenType::IntegerLiteral);
+        } else if (sym == terminal::FLOAT_LITERAL) {
+            symbols.push_back(TokenType::FloatLiteral);
+        } else if (sym == terminal::STRING_LITERAL) {
+            symbols.push_back(TokenType::StringLiteral);
+        } else {
+            symbols.push_back(std::string(terminal::spelling(sym)));
+        }
+    }
+    if (symbols.empty()) {
+        symbols.push_back(EPSILON);
+    }
+    return Production(lhs, symbols);
+}
+
+std::vector<Symbol> FirstFollowSets::toSymbols(const Production& production) {
+    // Token classes are spelled "$<TokenType>" like in the FIRST/FOLLOW views
+    std::vector<Symbol> symbols;
+    for (const auto& sym : production.rhs) {
+        if (std::holds_alternative<NonTerminal>(sym)) {
+            symbols.push_back(symbol::nt(std::get<NonTerminal>(sym)));
+        } else if (std::holds_alternative<TokenType>(sym)) {
+            int type = static_cast<int>(std::get<TokenType>(sym));
+            symbols.push_back(terminal::fromSpelling("$" + std::to_string(type)));
+        } else if (std::get<std::string>(sym) != EPSILON) {
+            symbols.push_back(terminal::fromSpelling(std::get<std::string>(sym)));
+        }
+    }
+    return symbols;
+}
+
 void FirstFollowSets::initializeGrammar() {
-    // Initialize our mini-C grammar with production rules based on grammar.txt
-    
-    // PROGRAM → MAIN_FUNCTION
-    addProduction(Production(
-        NonTerminal::PROGRAM,
-        {NonTerminal::MAIN_FUNCTION}
-    ));
-    
-    // MAIN_FUNCTION → int main ( ) { STATEMENT_LIST }
-    addProduction(Production(
-        NonTerminal::MAIN_FUNCTION,
-        {"int", "main", "(", ")", "{", NonTerminal::STATEMENT_LIST, "}"}
-    ));
-    
-    // STATEMENT_LIST → STATEMENT STATEMENT_LIST | ε
-    addProduction(Production(
-        NonTerminal::STATEMENT_LIST,
-        {NonTerminal::STATEMENT, NonTerminal::STATEMENT_LIST}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::STATEMENT_LIST,
-        {EPSILON} // Empty production (epsilon)
-    ));
-    
-    // STATEMENT → DECLARATION | ASSIGNMENT | LOOP | RETURN_STMT | EXPRESSION ; | ε
-    addProduction(Production(
-        NonTerminal::STATEMENT,
-        {NonTerminal::DECLARATION}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::STATEMENT,
-        {NonTerminal::ASSIGNMENT}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::STATEMENT,
-        {NonTerminal::LOOP}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::STATEMENT,
-        {NonTerminal::RETURN_STMT}
-    ));
-    
-    // Add support for expression statements (like i++;)
-    addProduction(Production(
-        NonTerminal::STATEMENT,
-        {NonTerminal::EXPRESSION, ";"}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::STATEMENT,
-        {EPSILON}
-    ));
-    
-    // DECLARATION → TYPE IDENTIFIER DECLARATION_TAIL
-    addProduction(Production(
-        NonTerminal::DECLARATION,
-        {NonTerminal::TYPE, TokenType::Identifier, NonTerminal::DECLARATION_TAIL}
-    ));
-    
-    // DECLARATION_TAIL → = EXPRESSION ; | ;
-    addProduction(Production(
-        NonTerminal::DECLARATION_TAIL,
-        {"=", NonTerminal::EXPRESSION, ";"}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::DECLARATION_TAIL,
-        {";"}
-    ));
-    
-    // TYPE → int | float
-    addProduction(Production(
-        NonTerminal::TYPE,
-        {"int"}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::TYPE,
-        {"float"}
-    ));
-    
-    // ASSIGNMENT → IDENTIFIER = EXPRESSION ;
-    addProduction(Production(
-        NonTerminal::ASSIGNMENT,
-        {TokenType::Identifier, "=", NonTerminal::EXPRESSION, ";"}
-    ));
-    
-    // LOOP → while ( CONDITION ) { STATEMENT_LIST }
-    addProduction(Production(
-        NonTerminal::LOOP,
-        {"while", "(", NonTerminal::CONDITION, ")", "{", NonTerminal::STATEMENT_LIST, "}"}
-    ));
-    
-    // CONDITION → EXPRESSION RELATIONAL_OP EXPRESSION
-    addProduction(Production(
-        NonTerminal::CONDITION,
-        {NonTerminal::EXPRESSION, NonTerminal::RELATIONAL_OP, NonTerminal::EXPRESSION}
-    ));
-    
-    // RELATIONAL_OP → < | > | <= | >= | == | !=
-    addProduction(Production(
-        NonTerminal::RELATIONAL_OP,
-        {"<"}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::RELATIONAL_OP,
-        {">"}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::RELATIONAL_OP,
-        {"<="}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::RELATIONAL_OP,
-        {">="}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::RELATIONAL_OP,
-        {"=="}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::RELATIONAL_OP,
-        {"!="}
-    ));
-    
-    // RETURN_STMT → return EXPRESSION ;
-    addProduction(Production(
-        NonTerminal::RETURN_STMT,
-        {"return", NonTerminal::EXPRESSION, ";"}
-    ));
-    
-    // EXPRESSION → TERM EXPRESSION_TAIL
-    addProduction(Production(
-        NonTerminal::EXPRESSION,
-        {NonTerminal::TERM, NonTerminal::EXPRESSION_TAIL}
-    ));
-    
-    // EXPRESSION_TAIL → + TERM EXPRESSION_TAIL | - TERM EXPRESSION_TAIL | ε
-    addProduction(Production(
-        NonTerminal::EXPRESSION_TAIL,
-        {"+", NonTerminal::TERM, NonTerminal::EXPRESSION_TAIL}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::EXPRESSION_TAIL,
-        {"-", NonTerminal::TERM, NonTerminal::EXPRESSION_TAIL}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::EXPRESSION_TAIL,
-        {EPSILON}
-    ));
-    
-    // TERM → FACTOR TERM_TAIL
-    addProduction(Production(
-        NonTerminal::TERM,
-        {NonTerminal::FACTOR, NonTerminal::TERM_TAIL}
-    ));
-    
-    // TERM_TAIL → * FACTOR TERM_TAIL | / FACTOR TERM_TAIL | ε
-    addProduction(Production(
-        NonTerminal::TERM_TAIL,
-        {"*", NonTerminal::FACTOR, NonTerminal::TERM_TAIL}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::TERM_TAIL,
-        {"/", NonTerminal::FACTOR, NonTerminal::TERM_TAIL}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::TERM_TAIL,
-        {EPSILON}
-    ));
-    
-    // FACTOR → IDENTIFIER FACTOR_TAIL | INTEGER_LITERAL | FLOAT_LITERAL | ( EXPRESSION )
-    addProduction(Production(
-        NonTerminal::FACTOR,
-        {TokenType::Identifier, NonTerminal::FACTOR_TAIL}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::FACTOR,
-        {TokenType::IntegerLiteral}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::FACTOR,
-        {TokenType::FloatLiteral}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::FACTOR,
-        {"(", NonTerminal::EXPRESSION, ")"}
-    ));
-    
-    // FACTOR_TAIL → ++ | -- | ε
-    addProduction(Production(
-        NonTerminal::FACTOR_TAIL,
-        {"++"}
-    ));
-    
-    addProduction(Production(
-        NonTerminal::FACTOR_TAIL,
-        {"--"}
-    ));
+    // Mirror the constexpr rules in grammar.h
+    for (const GrammarRule& rule : minic_grammar::RULES) {
+        addProduction(toProduction(rule.lhs, rule.rhs, rule.length));
+    }
+}
+
+std::string FirstFollowSets::nameOf(NonTerminal nt) const {
+    size_t index = static_cast<size_t>(nt);
+    if (index < nonterminal_names.size()) {
+        return nonterminal_names[index];
+    }
+    return nonTerminalToString(nt);
+}
+
+uint32_t FirstFollowSets::internTerminal(const std::string& spelling) {
+    auto it = terminal_bits.find(spelling);
+    if (it != terminal_bits.end()) {
+        return it->second;
+    }
+    uint32_t bit = static_cast<uint32_t>(terminal_names.size());
+    terminal_names.push_back(spelling);
+    terminal_bits.emplace(spelling, bit);
+    return bit;
+}
+
+void FirstFollowSets::encodeGrammar() {
+    terminal_names.clear();
+    terminal_bits.clear();
+    encoded_offsets.assign(1, 0);
+    encoded_symbols.clear();
+    nonterminal_count = NONTERMINAL_COUNT;
+    internTerminal("$");  // End of input, needed by FOLLOW even if no rule names it
+    
+    // Terminals become bit positions, non-terminals are flagged indices;
+    // epsilon is just an empty right-hand side
+    for (const Production& prod : grammar) {
+        nonterminal_count = std::max(nonterminal_count, static_cast<size_t>(prod.lhs) + 1);
+        for (const auto& sym : prod.rhs) {
+            if (std::holds_alternative<NonTerminal>(sym)) {
+                size_t index = static_cast<size_t>(std::get<NonTerminal>(sym));
+                nonterminal_count = std::max(nonterminal_count, index + 1);
+                encoded_symbols.push_back(static_cast<uint32_t>(index) | NONTERMINAL_BIT);
+            } else if (std::holds_alternative<TokenType>(sym)) {
+                int type = static_cast<int>(std::get<TokenType>(sym));
+                encoded_symbols.push_back(internTerminal("$" + std::to_string(type)));
+            } else if (std::get<std::string>(sym) != EPSILON) {
+                encoded_symbols.push_back(internTerminal(std::get<std::string>(sym)));
+            }
+        }
+        encoded_offsets.push_back(static_cast<uint32_t>(encoded_symbols.size()));
+    }
+    set_words = (terminal_names.size() + 63) / 64;
+}
+
+// OR row src into row dst of a set table; true if dst grew
+static bool mergeRow(uint64_t* dst, const uint64_t* src, size_t words) {
+    uint64_t grew = 0;
+    for (size_t i = 0; i < words; i++) {
+        grew |= src[i] & ~dst[i];
+        dst[i] |= src[i];
+    }
+    return grew != 0;
+}
+
+// Propagate sets along edges (from -> to means set[from] is a subset of set[to])
+// until nothing changes; only rows that grew are revisited
+static void propagate(std::vector<uint64_t>& sets, size_t words,
+                      const std::vector<std::vector<uint32_t>>& edges) {
+    std::vector<uint32_t> worklist;
+    std::vector<bool> queued(edges.size(), true);
+    for (size_t nt = 0; nt < edges.size(); nt++) {
+        worklist.push_back(static_cast<uint32_t>(nt));
+    }
     
-    addProduction(Production(
-        NonTerminal::FACTOR_TAIL,
-        {EPSILON}
-    ));
+    while (!worklist.empty()) {
+        uint32_t from = worklist.back();
+        worklist.pop_back();
+        queued[from] = false;
+        for (uint32_t to : edges[from]) {
+            if (mergeRow(&sets[to * words], &sets[from * words], words) && !queued[to]) {
+                queued[to] = true;
+                worklist.push_back(to);
+            }
+        }
+    }
 }
 
 void FirstFollowSets::computeFirstSets() {
-    bool changed = true;
-    
-    // Initialize FIRST sets for all non-terminals
-    for (int i = 0; i <= static_cast<int>(NonTerminal::FACTOR_TAIL); i++) {
-        NonTerminal nt = static_cast<NonTerminal>(i);
-        first_sets[nt] = std::set<std::string>();
+    encodeGrammar();
+    size_t productions = grammar.size();
+    
+    // Nullability: a production becomes nullable once every symbol in it is;
+    // count down the symbols still unproven and follow occurrence lists
+    nullable.assign(nonterminal_count, false);
+    std::vector<uint32_t> unproven(productions);
+    std::vector<std::vector<uint32_t>> occurrences(nonterminal_count);
+    std::vector<uint32_t> worklist;
+    for (size_t p = 0; p < productions; p++) {
+        unproven[p] = encoded_offsets[p + 1] - encoded_offsets[p];
+        for (uint32_t i = encoded_offsets[p]; i < encoded_offsets[p + 1]; i++) {
+            if (encoded_symbols[i] & NONTERMINAL_BIT) {
+                occurrences[encoded_symbols[i] & ~NONTERMINAL_BIT].push_back(static_cast<uint32_t>(p));
+            }
+        }
+        size_t lhs = static_cast<size_t>(grammar[p].lhs);
+        if (unproven[p] == 0 && !nullable[lhs]) {
+            nullable[lhs] = true;
+            worklist.push_back(static_cast<uint32_t>(lhs));
+        }
     }
-    
-    // Add epsilon to FIRST of any non-terminal that can derive epsilon
-    for (const auto& production : grammar) {
-        if (production.rhs.size() == 1 && 
-            std::holds_alternative<std::string>(production.rhs[0]) && 
-            std::get<std::string>(production.rhs[0]) == EPSILON) {
-            first_sets[production.lhs].insert(EPSILON);
+    while (!worklist.empty()) {
+        uint32_t nt = worklist.back();
+        worklist.pop_back();
+        for (uint32_t p : occurrences[nt]) {
+            size_t lhs = static_cast<size_t>(grammar[p].lhs);
+            if (--unproven[p] == 0 && !nullable[lhs]) {
+                nullable[lhs] = true;
+                worklist.push_back(static_cast<uint32_t>(lhs));
+            }
         }
     }
     
-    // Compute FIRST sets until no more changes
-    while (changed) {
-        changed = false;
-        
-        for (const auto& production : grammar) {
-            const NonTerminal& lhs = production.lhs;
-            size_t oldSize = first_sets[lhs].size();
-            
-            // If rhs begins with a terminal, add it to FIRST
-            if (!production.rhs.empty()) {
-                if (std::holds_alternative<std::string>(production.rhs[0])) {
-                    std::string terminal = std::get<std::string>(production.rhs[0]);
-                    if (terminal != EPSILON) {
-                        first_sets[lhs].insert(terminal);
-                    }
-                } else if (std::holds_alternative<TokenType>(production.rhs[0])) {
-                    TokenType tokenType = std::get<TokenType>(production.rhs[0]);
-                    // Add a placeholder for the token type
-                    std::string tokenTypeStr = "$" + std::to_string(static_cast<int>(tokenType));
-                    first_sets[lhs].insert(tokenTypeStr);
-                } else {
-                    // If rhs begins with a non-terminal, add its FIRST set (except epsilon)
-                    NonTerminal firstNT = std::get<NonTerminal>(production.rhs[0]); 
-                    for (const std::string& t : first_sets[firstNT]) {
-                        if (t != EPSILON) {
-                            first_sets[lhs].insert(t);
-                        }
-                    }
-                    
-                    // If all symbols in rhs can derive epsilon, add epsilon to FIRST
-                    bool allCanDeriveEpsilon = true;
-                    for (const auto& symbol : production.rhs) {
-                        if (std::holds_alternative<std::string>(symbol)) {
-                            if (std::get<std::string>(symbol) != EPSILON) {
-                                allCanDeriveEpsilon = false;
-                                break;
-                            }
-                        } else if (std::holds_alternative<TokenType>(symbol)) {
-                            // TokenType cannot derive epsilon
-                            allCanDeriveEpsilon = false;
-                            break;
-                        } else {
-                            NonTerminal nt = std::get<NonTerminal>(symbol);
-                            if (first_sets[nt].find(EPSILON) == first_sets[nt].end()) {
-                                allCanDeriveEpsilon = false;
-                                break;
-                            }
-                        }
-                    }
-                    
-                    if (allCanDeriveEpsilon) {
-                        first_sets[lhs].insert(EPSILON);
-                    }
-                }
+    // FIRST: terminals seen through a nullable prefix seed the sets, and
+    // non-terminals seen that way feed their FIRST set to the left-hand side
+    first_bits.assign(nonterminal_count * set_words, 0);
+    std::vector<std::vector<uint32_t>> edges(nonterminal_count);
+    for (size_t p = 0; p < productions; p++) {
+        size_t lhs = static_cast<size_t>(grammar[p].lhs);
+        for (uint32_t i = encoded_offsets[p]; i < encoded_offsets[p + 1]; i++) {
+            uint32_t sym = encoded_symbols[i];
+            if (!(sym & NONTERMINAL_BIT)) {
+                first_bits[lhs * set_words + sym / 64] |= uint64_t(1) << (sym % 64);
+                break;
             }
-            
-            // If the set changed, we need another iteration
-            if (first_sets[lhs].size() > oldSize) {
-                changed = true;
+            edges[sym & ~NONTERMINAL_BIT].push_back(static_cast<uint32_t>(lhs));
+            if (!nullable[sym & ~NONTERMINAL_BIT]) {
+                break;
             }
         }
     }
+    propagate(first_bits, set_words, edges);
+    
+    // String view
+    first_sets.clear();
+    for (size_t nt = 0; nt < nonterminal_count; nt++) {
+        std::set<std::string>& view = first_sets[static_cast<NonTerminal>(nt)];
+        for (size_t bit = 0; bit < terminal_names.size(); bit++) {
+            if (first_bits[nt * set_words + bit / 64] & (uint64_t(1) << (bit % 64))) {
+                view.insert(terminal_names[bit]);
+            }
+        }
+        if (nullable[nt]) {
+            view.insert(EPSILON);
+        }
+    }
 }
 
 std::set<std::string> FirstFollowSets::calculateFirst(const std::variant<NonTerminal, std::string, TokenType>& symbol) {
@@ -411,61 +342,55 @@ bool FirstFollowSets::hasEpsilon(const std::set<std::string>& set) const {
 }
 
 void FirstFollowSets::computeFollowSets() {
-    // Initialize FOLLOW sets for all non-terminals
-    for (int i = 0; i <= static_cast<int>(NonTerminal::FACTOR_TAIL); i++) {
-        NonTerminal nt = static_cast<NonTerminal>(i);
-        follow_sets[nt] = std::set<std::string>();
-    }
-    
-    // Add $ to FOLLOW of start symbol (PROGRAM)
-    follow_sets[NonTerminal::PROGRAM].insert("$"); 
-    
-    bool changed = true;
-    while (changed) {
-        changed = false;
+    // Relies on the encoding and FIRST sets from computeFirstSets()
+    follow_bits.assign(nonterminal_count * set_words, 0);
+    std::vector<std::vector<uint32_t>> edges(nonterminal_count);
+    
+    // End of input follows the start symbol (PROGRAM)
+    uint32_t eof_bit = terminal_bits.at("$");
+    size_t start = static_cast<size_t>(NonTerminal::PROGRAM);
+    follow_bits[start * set_words + eof_bit / 64] |= uint64_t(1) << (eof_bit % 64);
+    
+    // Walk each right-hand side backwards, carrying FIRST of the suffix so
+    // no beta sequence is ever copied
+    std::vector<uint64_t> suffix_first(set_words);
+    for (size_t p = 0; p < grammar.size(); p++) {
+        size_t lhs = static_cast<size_t>(grammar[p].lhs);
+        std::fill(suffix_first.begin(), suffix_first.end(), 0);
+        bool suffix_nullable = true;
         
-        for (const auto& production : grammar) {
-            const NonTerminal& lhs = production.lhs;
+        for (uint32_t i = encoded_offsets[p + 1]; i > encoded_offsets[p]; i--) {
+            uint32_t sym = encoded_symbols[i - 1];
+            if (!(sym & NONTERMINAL_BIT)) {
+                std::fill(suffix_first.begin(), suffix_first.end(), 0);
+                suffix_first[sym / 64] |= uint64_t(1) << (sym % 64);
+                suffix_nullable = false;
+                continue;
+            }
             
-            for (size_t i = 0; i < production.rhs.size(); i++) {
-                // Only interested in non-terminals in RHS
-                if (!std::holds_alternative<NonTerminal>(production.rhs[i])) {
-                    continue;
-                }
-                
-                NonTerminal B = std::get<NonTerminal>(production.rhs[i]);
-                size_t oldSize = follow_sets[B].size();
-                
-                // If B is the last symbol, add FOLLOW(A) to FOLLOW(B)
-                if (i == production.rhs.size() - 1) {
-                    for (const std::string& t : follow_sets[lhs]) {
-                        follow_sets[B].insert(t);
-                    }
-                } else {
-                    // Get FIRST of the sequence after B
-                    std::vector<std::variant<NonTerminal, std::string, TokenType>> beta(
-                        production.rhs.begin() + i + 1, production.rhs.end());
-                    std::set<std::string> firstBeta = getFirstOfSequence(beta);
-                    
-                    // Add FIRST(beta) - {epsilon} to FOLLOW(B)
-                    for (const std::string& t : firstBeta) {
-                        if (t != EPSILON) {
-                            follow_sets[B].insert(t);
-                        }
-                    }
-                    
-                    // If epsilon is in FIRST(beta), add FOLLOW(A) to FOLLOW(B)
-                    if (firstBeta.find(EPSILON) != firstBeta.end()) {
-                        for (const std::string& t : follow_sets[lhs]) {
-                            follow_sets[B].insert(t);
-                        }
-                    }
-                }
-                
-                // If FOLLOW(B) changed, we need another iteration
-                if (follow_sets[B].size() > oldSize) {
-                    changed = true;
-                }
+            uint32_t b = sym & ~NONTERMINAL_BIT;
+            mergeRow(&follow_bits[b * set_words], suffix_first.data(), set_words);
+            if (suffix_nullable) {
+                edges[lhs].push_back(b);
+            }
+            
+            // Extend the suffix with B itself
+            if (!nullable[b]) {
+                std::fill(suffix_first.begin(), suffix_first.end(), 0);
+                suffix_nullable = false;
+            }
+            mergeRow(suffix_first.data(), &first_bits[b * set_words], set_words);
+        }
+    }
+    propagate(follow_bits, set_words, edges);
+    
+    // String view
+    follow_sets.clear();
+    for (size_t nt = 0; nt < nonterminal_count; nt++) {
+        std::set<std::string>& view = follow_sets[static_cast<NonTerminal>(nt)];
+        for (size_t bit = 0; bit < terminal_names.size(); bit++) {
+            if (follow_bits[nt * set_words + bit / 64] & (uint64_t(1) << (bit % 64))) {
+                view.insert(terminal_names[bit]);
             }
         }
     }
@@ -473,12 +398,11 @@ void FirstFollowSets::computeFollowSets() {
 
 void FirstFollowSets::printSets() const {
     std::cout << "\n==== FIRST SETS ====\n";
-    for (int i = 0; i <= static_cast<int>(NonTerminal::FACTOR_TAIL); i++) {
-        NonTerminal nt = static_cast<NonTerminal>(i);
-        std::cout << "FIRST(" << nonTerminalToString(nt) << ") = { ";
+    for (const auto& entry : first_sets) {
+        std::cout << "FIRST(" << nameOf(entry.first) << ") = { ";
         
-        for (auto it = first_sets.at(nt).begin(); it != first_sets.at(nt).end(); ++it) {
-            if (it != first_sets.at(nt).begin()) {
+        for (auto it = entry.second.begin(); it != entry.second.end(); ++it) {
+            if (it != entry.second.begin()) {
                 std::cout << ", ";
             }
             std::cout << *it;
@@ -487,12 +411,11 @@ void FirstFollowSets::printSets() const {
     }
     
     std::cout << "\n==== FOLLOW SETS ====\n";
-    for (int i = 0; i <= static_cast<int>(NonTerminal::FACTOR_TAIL); i++) {
-        NonTerminal nt = static_cast<NonTerminal>(i);
-        std::cout << "FOLLOW(" << nonTerminalToString(nt) << ") = { ";
+    for (const auto& entry : follow_sets) {
+        std::cout << "FOLLOW(" << nameOf(entry.first) << ") = { ";
         
-        for (auto it = follow_sets.at(nt).begin(); it != follow_sets.at(nt).end(); ++it) {
-            if (it != follow_sets.at(nt).begin()) {
+        for (auto it = entry.second.begin(); it != entry.second.end(); ++it) {
+            if (it != entry.second.begin()) {
                 std::cout << ", ";
             }
             std::cout << *it;
@@ -501,538 +424,219 @@ void FirstFollowSets::printSets() const {
     }
 }
 
-// Parser implementation
-Parser::Parser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable) 
-    : tokens(std::move(tokens)), error_reporter(reporter), symbol_table(symtable), first_follow(), parse_table(), current_token(nullptr), verbose(false) {
-    this->tokens.reset();  // Reset the token stream to ensure we're at the beginning
-    current_token = &this->tokens.peek();
-    buildParseTable();
+// LL1Grammar implementation
+LL1Grammar::LL1Grammar(FirstFollowSets grammar_sets, const int16_t* rows, const TerminalSet* follow,
+                       size_t count)
+    : sets(std::move(grammar_sets)), nonterminal_count(count), predict_rows(rows), follow_rows(follow) {
+    buildParseTableView();
+    resolveProductions();
 }
 
-void Parser::buildParseTable() {
-    // Initialize parse table with error entries
-    for (int nt = 0; nt <= static_cast<int>(NonTerminal::FACTOR_TAIL); nt++) {
-        for (const auto& terminals_entry : first_follow.first_sets) {
-            for (const auto& terminal : terminals_entry.second) {
-                if (terminal != EPSILON) {
-                    parse_table[static_cast<NonTerminal>(nt)][terminal] = {NO_PRODUCTION, nullptr};
-                }
-            }
-        }
-        
-        for (const auto& terminal : first_follow.follow_sets[static_cast<NonTerminal>(nt)]) {
-            if (terminal != EPSILON) {
-                parse_table[static_cast<NonTerminal>(nt)][terminal] = {NO_PRODUCTION, nullptr};
+LL1Grammar::LL1Grammar(FirstFollowSets grammar_sets, std::vector<int16_t> rows, std::vector<TerminalSet> follow,
+                       size_t count)
+    : sets(std::move(grammar_sets)), nonterminal_count(count), owned_predict(std::move(rows)),
+      owned_follow(std::move(follow)) {
+    predict_rows = owned_predict.data();
+    follow_rows = owned_follow.data();
+    buildParseTableView();
+    resolveProductions();
+}
+
+const LL1Grammar& LL1Grammar::builtin() {
+    static const LL1Grammar grammar(FirstFollowSets(), &GRAMMAR_TABLES.predict[0][0], GRAMMAR_TABLES.follow,
+                                    NONTERMINAL_COUNT);
+    return grammar;
+}
+
+void LL1Grammar::buildParseTableView() {
+    parse_table.clear();
+    for (size_t nt = 0; nt < nonterminal_count; nt++) {
+        auto& row = parse_table[static_cast<NonTerminal>(nt)];
+        for (TerminalId t = 0; t < terminal::COUNT; t++) {
+            int production = predict(static_cast<NonTerminal>(nt), t);
+            if (production != NO_PRODUCTION) {
+                row[terminal::spelling(t)] = {production, &sets.grammar[production]};
             }
         }
     }
+}
+
+void LL1Grammar::resolveProductions() {
+    rhs_symbols.clear();
+    rhs_offsets.assign(1, 0);
+    for (const Production& production : sets.grammar) {
+        std::vector<Symbol> symbols = FirstFollowSets::toSymbols(production);
+        rhs_symbols.insert(rhs_symbols.end(), symbols.begin(), symbols.end());
+        rhs_offsets.push_back(static_cast<uint32_t>(rhs_symbols.size()));
+    }
     
-    // Helper to check if a conflict is expected and should be suppressed
-    auto isExpectedConflict = [](NonTerminal nonterm, const std::string& terminal) -> bool {
-        // STATEMENT_LIST can have epsilon or contain statements, so } can cause conflicts
-        if (nonterm == NonTerminal::STATEMENT_LIST && terminal == "}") 
-            return true;
-            
-        // STATEMENT can be multiple things, so possible conflicts with these terminals
-        if (nonterm == NonTerminal::STATEMENT) {
-            if (terminal == "$1" ||  // Identifier
-                terminal == "$2" ||  // IntegerLiteral
-                terminal == "$3" ||  // FloatLiteral
-                terminal == "(" ||   // Open parenthesis
-                terminal == "int" || 
-                terminal == "float" || 
-                terminal == "return" || 
-                terminal == "while")
-                return true;
-        }
+    pushes = PushTable();
+    pushes.offsets.assign(1, 0);
+    for (size_t p = 0; p < sets.grammar.size(); p++) {
+        pushes.symbols.insert(pushes.symbols.end(), std::make_reverse_iterator(rhs(p) + rhsLength(p)),
+                              std::make_reverse_iterator(rhs(p)));
+        pushes.offsets.push_back(static_cast<uint32_t>(pushes.symbols.size()));
+    }
+    pushes.event_offsets.assign(sets.grammar.size() + 1, 0);
+}
+
+// Parser implementation
+
+// Grammar tables are built before any Parser exists, so construction does no work
+Parser::Parser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable, Ast* ast,
+               const LL1Grammar& grammar)
+    : tokens(std::move(tokens)), error_reporter(reporter), symbol_table(symtable),
+      grammar(grammar), first_follow(grammar.getSets()), current_token(nullptr), verbose(false),
+      max_errors(DEFAULT_MAX_ERRORS), owned_ast(ast ? nullptr : std::make_unique<Ast>()), ast(ast ? ast : owned_ast.get()),
+      parse_table(grammar.getParseTable()) {
+    this->tokens.reset();  // Reset the token stream to ensure we're at the beginning
+    current_token = &this->tokens.peek();
+}
+
+Parser::Parser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable,
+               const LL1Grammar& grammar)
+    : Parser(std::move(tokens), reporter, symtable, nullptr, grammar) {}
+
+Parser::Parser(TokenStream tokens, CompilationContext& context, const LL1Grammar& grammar)
+    : Parser(std::move(tokens), context.getReporter(), context.getSymbolTable(), &context.getAst(), grammar) {}
+
+template <typename Trace>
+bool Parser::buildAst(Trace& trace) {
+    ast->clear();
+    AstBuilder builder(*ast);
+    if (!parse(builder, trace)) {
         return false;
-    };
-    
-    // Populate parse table based on grammar productions
-    for (size_t i = 0; i < first_follow.grammar.size(); i++) {
-        const Production& prod = first_follow.grammar[i];
-        NonTerminal nonterm = prod.lhs;
-        
-        // If the production has epsilon (ε) on RHS, add to FOLLOW(nonterm)
-        if (prod.rhs.size() == 1 && 
-            std::holds_alternative<std::string>(prod.rhs[0]) && 
-            std::get<std::string>(prod.rhs[0]) == EPSILON) {
-            
-            for (const auto& terminal : first_follow.follow_sets[nonterm]) {
-                auto& table_entry = parse_table[nonterm][terminal];
-                
-                // Check for conflicts, but suppress expected conflicts
-                if (table_entry.production_index != NO_PRODUCTION && !isExpectedConflict(nonterm, terminal)) {
-                    SourceLocation loc = current_token->loc;
-                    error_reporter.error(loc, "Parser conflict: Multiple productions for %s with terminal %s", 
-                                        nonTerminalToString(nonterm).c_str(), terminal.c_str());
-                } else {
-                    table_entry = {static_cast<int>(i), &prod};
-                }
-            }
-        } else {
-            // For non-epsilon productions, add to FIRST(RHS)
-            std::set<std::string> first_rhs = first_follow.getFirstOfSequence(prod.rhs);
-            
-            for (const std::string& terminal : first_rhs) {
-                if (terminal != EPSILON) {
-                    auto& table_entry = parse_table[nonterm][terminal];
-                    
-                    // Check for conflicts, but suppress expected conflicts
-                    if (table_entry.production_index != NO_PRODUCTION && !isExpectedConflict(nonterm, terminal)) {
-                        SourceLocation loc = current_token->loc;
-                        error_reporter.error(loc, "Parser conflict: Multiple productions for %s with terminal %s", 
-                                            nonTerminalToString(nonterm).c_str(), terminal.c_str());
-                    } else {
-                        table_entry = {static_cast<int>(i), &prod};
-                    }
-                }
-            }
-            
-            // If FIRST(RHS) contains epsilon, add production to FOLLOW(nonterm)
-            if (first_follow.hasEpsilon(first_rhs)) {
-                for (const auto& terminal : first_follow.follow_sets[nonterm]) {
-                    auto& table_entry = parse_table[nonterm][terminal];
-                    
-                    // Check for conflicts, but suppress expected conflicts
-                    if (table_entry.production_index != NO_PRODUCTION && !isExpectedConflict(nonterm, terminal)) {
-                        SourceLocation loc = current_token->loc;
-                        error_reporter.error(loc, "Parser conflict: Multiple productions for %s with terminal %s",
-                                            nonTerminalToString(nonterm).c_str(), terminal.c_str());
-                    } else {
-                        table_entry = {static_cast<int>(i), &prod};
-                    }
-                }
-            }
-        }
     }
+    builder.finish();
+    return true;
 }
 
 bool Parser::parse() {
-    // Debug output - print the first few tokens
-    std::cout << "Token stream status: " << (tokens.isAtEnd() ? "empty" : "has tokens") << std::endl;
-    std::cout << "Current token: " << current_token->lexeme << " (type: " << static_cast<int>(current_token->type) << ")" << std::endl;
-    
-    // Safety check - if we already have errors or no tokens, return false
-    if (tokens.isAtEnd() || error_reporter.getErrorCount() > 0) {
-        if (tokens.isAtEnd()) {
-            std::cout << "Error: Token stream is empty" << std::endl;
-        }
-        return false;
+    if (!verbose) {
+        NoTrace untraced;
+        return buildAst(untraced);
     }
     
-    // Initialize parse stack with EOF marker and start symbol
-    std::vector<std::variant<NonTerminal, std::string, TokenType>> parse_stack;
-    parse_stack.push_back("$"); // EOF marker at bottom of stack
-    parse_stack.push_back(NonTerminal::PROGRAM); // Start symbol
-    
-    // For symbol table processing
-    SymbolType current_type = SymbolType::UNKNOWN;
-    std::string current_identifier = "";
-    bool processing_declaration = false;
-    
-    // Create the global scope
-    symbol_table.enterScope(); // Start with scope level 0
-    
-    // To prevent infinite loops, set a maximum iteration count
-    int max_iterations = 1000;
-    int iterations = 0;
-    
-    while (!parse_stack.empty() && iterations < max_iterations) {
-        iterations++;
-        
-        // Check what's on top of the stack
-        std::variant<NonTerminal, std::string, TokenType> top = parse_stack.back();
-        parse_stack.pop_back();
-        
-        if (std::holds_alternative<std::string>(top)) {
-            // If we expect a terminal on the stack
-            std::string expected = std::get<std::string>(top);
-            
-            if (expected == "$") {
-                // If we reached the EOF marker, check if input is also at EOF
-                if (current_token->type == TokenType::Eof) {
-                    return true; // Successful parse
-                } else {
-                    syntaxError("Expected end of file, got " + current_token->lexeme);
-                    return false;
-                }
-            } else if (expected == EPSILON) {
-                // Epsilon production, do nothing
-                continue;
-            } else if (expected == "{") {
-                // Opening a new block scope
-                if (current_token->lexeme == expected) {
-                    if (verbose) {
-                        std::cout << "Entering new scope at {" << std::endl;
-                    }
-                    symbol_table.enterScope();
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                } else {
-                    syntaxError("Expected '{', got '" + current_token->lexeme + "'");
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                    return false;
-                }
-            } else if (expected == "}") {
-                // Closing a block scope
-                if (current_token->lexeme == expected) {
-                    if (verbose) {
-                        std::cout << "Exiting scope at }" << std::endl;
-                    }
-                    symbol_table.exitScope();
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                } else {
-                    syntaxError("Expected '}', got '" + current_token->lexeme + "'");
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                    return false;
-                }
-            } else if (expected == "int" || expected == "float") {
-                // Capture the type for declarations
-                if (current_token->lexeme == expected) {
-                    if (verbose) {
-                        std::cout << "Type declaration: " << expected << std::endl;
-                    }
-                    current_type = (expected == "int") ? SymbolType::INT : SymbolType::FLOAT;
-                    processing_declaration = true;
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                } else {
-                    syntaxError("Expected '" + expected + "', got '" + current_token->lexeme + "'");
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                    return false;
-                }
-            } else if (expected == ";") {
-                // End of declaration or statement
-                if (current_token->lexeme == expected) {
-                    if (processing_declaration && !current_identifier.empty()) {
-                        // Finalize the declaration
-                        if (verbose) {
-                            std::cout << "Adding symbol to table: " << current_identifier << " of type " 
-                                     << (current_type == SymbolType::INT ? "int" : "float") << std::endl;
-                        }
-                        
-                        if (!symbol_table.insert(current_identifier, current_type)) {
-                            // Report redeclaration error
-                            error_reporter.error(current_token->loc, "Redeclaration of variable '%s'", 
-                                               current_identifier.c_str());
-                        }
-                        
-                        // Reset declaration tracking
-                        current_identifier = "";
-                        processing_declaration = false;
-                    }
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                } else {
-                    syntaxError("Expected ';', got '" + current_token->lexeme + "'");
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                    return false;
-                }
-            } else {
-                // Match terminal with current input token
-                if (current_token->lexeme == expected) {
-                    if (verbose) {
-                        std::cout << "Matched token: " << current_token->lexeme << std::endl;
-                    }
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                } else {
-                    syntaxError("Expected '" + expected + "', got '" + current_token->lexeme + "'");
-                    // Skip the current token and try to recover
-                    tokens.advance();
-                    current_token = &tokens.peek();
-                    return false;
-                }
+    RingTrace trace(VERBOSE_TRACE_LOG2);
+    bool result = buildAst(trace);
+    TraceDecoder(&first_follow, &tokens).print(trace.snapshot(), trace.dropped(), std::cout);
+    return result;
+}
+
+bool Parser::parseTraced(RingTrace& trace) {
+    return buildAst(trace);
+}
+
+size_t Parser::builtinEvents(NonTerminal nonterm, TerminalId lookahead, EventSlot* slots) {
+    size_t count = 0;
+    auto add = [&](uint8_t after, ParseEventKind kind, uint32_t token_offset = 0) {
+        slots[count++] = {after, kind, token_offset};
+    };
+    switch (nonterm) {
+        case NonTerminal::FUNCTION:
+            // TYPE IDENTIFIER ( PARAMETER_LIST ) { STATEMENT_LIST }, named by the identifier
+            add(2, ParseEventKind::FunctionBegin, 1);
+            add(EventSlot::END, ParseEventKind::FunctionEnd, 1);
+            break;
+        case NonTerminal::PARAMETER:
+            add(EventSlot::END, ParseEventKind::Parameter);
+            break;
+        case NonTerminal::DECLARATION:
+            add(EventSlot::END, ParseEventKind::Declaration);
+            break;
+        case NonTerminal::ASSIGNMENT:
+            add(EventSlot::END, ParseEventKind::Assignment);
+            break;
+        case NonTerminal::LOOP:
+            add(1, ParseEventKind::LoopBegin);
+            add(EventSlot::END, ParseEventKind::LoopEnd);
+            break;
+        case NonTerminal::CONDITION:
+            add(EventSlot::END, ParseEventKind::RelationalOperator);
+            break;
+        case NonTerminal::RETURN_STMT:
+            add(EventSlot::END, ParseEventKind::Return);
+            break;
+        case NonTerminal::EXPRESSION_TAIL:
+        case NonTerminal::TERM_TAIL:
+            // op operand TAIL: the operator completes before the rest of the chain
+            add(2, ParseEventKind::Operator);
+            break;
+        case NonTerminal::FACTOR:
+            if (lookahead == terminal::IDENTIFIER) {
+                add(1, ParseEventKind::Identifier);
+            } else if (lookahead == terminal::INTEGER_LITERAL) {
+                add(1, ParseEventKind::IntegerLiteral);
+            } else if (lookahead == terminal::FLOAT_LITERAL) {
+                add(1, ParseEventKind::FloatLiteral);
             }
-        } else if (std::holds_alternative<TokenType>(top)) {
-            // If we expect a token type on the stack
-            TokenType expected = std::get<TokenType>(top);
-            
-            if (current_token->type == expected) {
-                if (verbose) {
-                    std::cout << "Matched token type: " << static_cast<int>(current_token->type) << std::endl;
-                }
-                
-                // Capture identifiers for declarations and references
-                if (expected == TokenType::Identifier) {
-                    if (processing_declaration) {
-                        // Store the identifier name for the declaration
-                        current_identifier = current_token->lexeme;
-                        if (verbose) {
-                            std::cout << "Captured identifier for declaration: " << current_identifier << std::endl;
-                        }
-                    } else {
-                        // For variable references, check if the variable is declared
-                        SymbolInfo* info = symbol_table.lookup(current_token->lexeme);
-                        if (!info) {
-                            error_reporter.error(current_token->loc, "Use of undeclared variable '%s'", 
-                                               current_token->lexeme.c_str());
-                        }
-                    }
-                }
-                
-                tokens.advance();
-                current_token = &tokens.peek();
+            break;
+        case NonTerminal::FACTOR_TAIL:
+            if (lookahead == terminal::punct(PunctuationType::LPAREN)) {
+                add(1, ParseEventKind::CallBegin);
+                add(EventSlot::END, ParseEventKind::Call);
             } else {
-                std::string expectedStr;
-                switch (expected) {
-                    case TokenType::Identifier: expectedStr = "identifier"; break;
-                    case TokenType::IntegerLiteral: expectedStr = "integer literal"; break;
-                    case TokenType::FloatLiteral: expectedStr = "float literal"; break;
-                    default: expectedStr = "unknown token type";
-                }
-                
-                syntaxError("Expected " + expectedStr + ", got '" + current_token->lexeme + "'");
-                // Skip the current token and try to recover
-                tokens.advance();
-                current_token = &tokens.peek();
-                return false;
-            }
-        } else {
-            // Non-terminal on top of stack, look up in parse table
-            NonTerminal nonterm = std::get<NonTerminal>(top);
-            
-            // For verbose mode, print what we're processing
-            if (verbose) {
-                std::cout << "Processing non-terminal: " << nonTerminalToString(nonterm) << std::endl;
-            }
-            
-            // Special case for DECLARATION - prepare to process a new declaration
-            if (nonterm == NonTerminal::DECLARATION) {
-                processing_declaration = true;
-                current_type = SymbolType::UNKNOWN;
-                current_identifier = "";
-            }
-            
-            // Special case for STATEMENT_LIST to avoid infinite loops with epsilon productions
-            if (nonterm == NonTerminal::STATEMENT_LIST) {
-                // If we see '}', we use the epsilon production
-                if (current_token->type == TokenType::Punctuation && current_token->lexeme == "}") {
-                    if (verbose) {
-                        std::cout << "} found, using epsilon for STATEMENT_LIST" << std::endl;
-                    }
-                    continue; // Skip to next iteration
-                }
-                
-                // Check if we are at the beginning of a statement
-                bool isStatementStart = false;
-                
-                // Check for statement start tokens
-                if (current_token->type == TokenType::Keyword) {
-                    // Keywords that can start a statement: int, float, while, return
-                    if (current_token->lexeme == "int" || current_token->lexeme == "float" || 
-                        current_token->lexeme == "while" || current_token->lexeme == "return") {
-                        isStatementStart = true;
-                    }
-                } else if (current_token->type == TokenType::Identifier) {
-                    // Statements can start with identifiers (assignments or expressions)
-                    isStatementStart = true;
-                } else if (current_token->type == TokenType::IntegerLiteral || 
-                          current_token->type == TokenType::FloatLiteral ||
-                          (current_token->type == TokenType::Punctuation && 
-                           (current_token->lexeme == "(" || current_token->lexeme == "++" || current_token->lexeme == "--"))) {
-                    // Expressions can also start with literals or certain punctuation
-                    isStatementStart = true;
-                }
-                
-                if (isStatementStart) {
-                    if (verbose) {
-                        std::cout << "Statement found, using STATEMENT STATEMENT_LIST for STATEMENT_LIST" << std::endl;
-                    }
-                    // Push STATEMENT_LIST first (top of stack gets processed first)
-                    parse_stack.push_back(NonTerminal::STATEMENT_LIST);
-                    parse_stack.push_back(NonTerminal::STATEMENT);
-                    continue; // Skip to next iteration
-                } else {
-                    // If not at start of statement, use epsilon production
-                    if (verbose) {
-                        std::cout << "No statement start found, using epsilon for STATEMENT_LIST" << std::endl;
-                    }
-                    continue; // Skip to next iteration
-                }
-            }
-            
-            // Special case for STATEMENT to help with decision making
-            if (nonterm == NonTerminal::STATEMENT) {
-                // Declarations start with type keywords
-                if (current_token->type == TokenType::Keyword && 
-                    (current_token->lexeme == "int" || current_token->lexeme == "float")) {
-                    if (verbose) {
-                        std::cout << "Type found, using DECLARATION for STATEMENT" << std::endl;
-                    }
-                    parse_stack.push_back(NonTerminal::DECLARATION);
-                    continue;
-                }
-                
-                // Assignments start with identifiers
-                else if (current_token->type == TokenType::Identifier) {
-                    // Look ahead to check if this is an assignment or just an expression
-                    // We need to check if the next token is '='
-                    Token* next_token = nullptr;
-                    if (!tokens.isAtEnd()) {
-                        tokens.advance();
-                        next_token = &tokens.peek();
-                        tokens.rewind(); // Go back to current token
-                    }
-                    
-                    if (next_token && next_token->type == TokenType::Operator && 
-                        next_token->lexeme == "=") {
-                        if (verbose) {
-                            std::cout << "Assignment found, using ASSIGNMENT for STATEMENT" << std::endl;
-                        }
-                        parse_stack.push_back(NonTerminal::ASSIGNMENT);
-                    } else {
-                        // This is an expression statement
-                        if (verbose) {
-                            std::cout << "Expression statement found, using EXPRESSION ; for STATEMENT" << std::endl;
-                        }
-                        parse_stack.push_back(";");
-                        parse_stack.push_back(NonTerminal::EXPRESSION);
-                    }
-                    continue;
-                }
-                
-                // Loops start with 'while'
-                else if (current_token->type == TokenType::Keyword && current_token->lexeme == "while") {
-                    if (verbose) {
-                        std::cout << "While found, using LOOP for STATEMENT" << std::endl;
-                    }
-                    parse_stack.push_back(NonTerminal::LOOP);
-                    continue;
-                }
-                
-                // Return statements start with 'return'
-                else if (current_token->type == TokenType::Keyword && current_token->lexeme == "return") {
-                    if (verbose) {
-                        std::cout << "Return found, using RETURN_STMT for STATEMENT" << std::endl;
-                    }
-                    parse_stack.push_back(NonTerminal::RETURN_STMT);
-                    continue;
-                }
-                
-                // Expression statements
-                else if (current_token->type == TokenType::IntegerLiteral || 
-                        current_token->type == TokenType::FloatLiteral ||
-                        (current_token->type == TokenType::Punctuation && 
-                        (current_token->lexeme == "(" || current_token->lexeme == "++" || current_token->lexeme == "--"))) {
-                    if (verbose) {
-                        std::cout << "Expression statement found, using EXPRESSION ; for STATEMENT" << std::endl;
-                    }
-                    parse_stack.push_back(";");
-                    parse_stack.push_back(NonTerminal::EXPRESSION);
-                    continue;
-                }
-                
-                // If nothing matches, use epsilon
-                else {
-                    if (verbose) {
-                        std::cout << "No matching statement type, using epsilon for STATEMENT" << std::endl;
-                    }
-                    continue;
-                }
-            }
-            
-            // Use current token to determine the input symbol for parse table lookup
-            std::string input_symbol = current_token->lexeme;
-            
-            // Convert token type to string placeholder for lookup if needed
-            if (current_token->type == TokenType::Identifier ||
-                current_token->type == TokenType::IntegerLiteral ||
-                current_token->type == TokenType::FloatLiteral) {
-                std::string tokenTypeStr = "$" + std::to_string(static_cast<int>(current_token->type));
-                input_symbol = tokenTypeStr;
+                add(1, ParseEventKind::Increment);
             }
+            break;
+        default:
+            break;
+    }
+    return count;
+}
+
+const PushTable& Parser::builtinEventPushes() {
+    static const PushTable pushes = [] {
+        const LL1Grammar& grammar = LL1Grammar::builtin();
+        const std::vector<Production>& productions = grammar.getSets().grammar;
+        PushTable table;
+        table.offsets.assign(1, 0);
+        table.event_offsets.assign(1, 0);
+        for (size_t p = 0; p < productions.size(); p++) {
+            const Symbol* rhs = grammar.rhs(static_cast<int>(p));
+            size_t length = grammar.rhsLength(static_cast<int>(p));
             
-            // Look up production in parse table
-            auto it = parse_table[nonterm].find(input_symbol);
+            // FACTOR's and FACTOR_TAIL's events depend on the lookahead,
+            // which is the first symbol of the production it predicts
+            EventSlot slots[EventSlot::MAX_PER_PRODUCTION];
+            TerminalId lookahead = length > 0 && !symbol::isNonTerminal(rhs[0]) ? rhs[0] : terminal::END_OF_FILE;
+            size_t slot_count = length > 0 ? builtinEvents(productions[p].lhs, lookahead, slots) : 0;
             
-            if (it != parse_table[nonterm].end() && it->second.production_index != NO_PRODUCTION) {
-                // Valid production, push RHS onto stack in reverse order
-                const Production* prod = it->second.production;
-                
-                if (verbose) {
-                    std::cout << "Using production: " << nonTerminalToString(prod->lhs) << " →";
-                    for (const auto& symbol : prod->rhs) {
-                        if (std::holds_alternative<std::string>(symbol)) {
-                            std::cout << " " << std::get<std::string>(symbol);
-                        } else if (std::holds_alternative<TokenType>(symbol)) {
-                            TokenType tokenType = std::get<TokenType>(symbol);
-                            std::cout << " [TokenType:" << static_cast<int>(tokenType) << "]";
-                        } else {
-                            std::cout << " " << nonTerminalToString(std::get<NonTerminal>(symbol));
-                        }
-                    }
-                    std::cout << std::endl;
-                }
-                
-                // Skip epsilon - it doesn't need to be pushed onto the stack
-                if (!(prod->rhs.size() == 1 && 
-                    std::holds_alternative<std::string>(prod->rhs[0]) && 
-                    std::get<std::string>(prod->rhs[0]) == EPSILON)) {
-                    
-                    // Push symbols in reverse order
-                    for (auto it = prod->rhs.rbegin(); it != prod->rhs.rend(); ++it) {
-                        parse_stack.push_back(*it);
+            // Events go in below the symbols they follow
+            for (size_t i = length; i-- > 0;) {
+                for (size_t e = 0; e < slot_count; e++) {
+                    size_t after = slots[e].after == EventSlot::END ? length : slots[e].after;
+                    if (after == i + 1) {
+                        table.symbols.push_back(symbol::event(static_cast<uint8_t>(slots[e].kind)));
+                        table.token_offsets.push_back(static_cast<uint8_t>(slots[e].token_offset));
                     }
                 }
-            } else {
-                // Error: No valid production for the current input
-                reportParseError(nonterm);
-                
-                // Skip current token as a basic error recovery strategy
-                tokens.advance();
-                current_token = &tokens.peek();
-                return false;
+                table.symbols.push_back(rhs[i]);
             }
+            table.offsets.push_back(static_cast<uint32_t>(table.symbols.size()));
+            table.event_offsets.push_back(static_cast<uint32_t>(table.token_offsets.size()));
         }
-    }
-    
-    // Check if we hit the iteration limit
-    if (iterations >= max_iterations) {
-        error_reporter.error(current_token->loc, "Parsing aborted due to too many iterations (possible infinite loop)");
-        return false;
-    }
-    
-    // If we exhausted the parse stack but not the input, we have an error
-    if (current_token->type != TokenType::Eof) {
-        syntaxError("Unexpected token: " + current_token->lexeme);
-        return false;
-    }
-    
-    return true;
+        return table;
+    }();
+    return pushes;
 }
 
 void Parser::reportParseError(NonTerminal nonterm) {
-    std::stringstream error_msg;
-    error_msg << "Unexpected token '" << current_token->lexeme << "' of type '" 
-              << tokenTypeToString(current_token->type) << "' for non-terminal '" 
-              << nonTerminalToString(nonterm) << "'";
-    
-    error_msg << "\nExpected one of: ";
-    bool first = true;
-    
     // List expected tokens based on the parse table
-    for (const auto& entry : parse_table[nonterm]) {
+    std::string expected;
+    for (const auto& entry : parse_table.at(nonterm)) {
         if (entry.second.production_index != NO_PRODUCTION) {
-            if (!first) {
-                error_msg << ", ";
+            if (!expected.empty()) {
+                expected += ", ";
             }
-            error_msg << "'" << entry.first << "'";
-            first = false;
+            expected += '\'';
+            expected += entry.first;
+            expected += '\'';
         }
     }
     
-    error_reporter.error(current_token->loc, "%s", error_msg.str().c_str());
-}
-
-void Parser::syntaxError(const std::string& message) {
-    error_reporter.error(current_token->loc, "%s", message.c_str());
+    error_reporter.report(diag::NoProduction{}, current_token->loc, current_token->lexeme,
+                          tokenTypeToString(current_token->type), first_follow.nameOf(nonterm), expected);
 }
 
 // Add the missing Parser methods
@@ -1043,9 +647,8 @@ const FirstFollowSets& Parser::getFirstFollowSets() const {
 void Parser::printParseTable() const {
     // Collect all terminals used in the parse table for columns
     std::set<std::string> all_terminals;
-    for (int i = 0; i <= static_cast<int>(NonTerminal::FACTOR_TAIL); i++) {
-        NonTerminal nt = static_cast<NonTerminal>(i);
-        for (const auto& entry : parse_table.at(nt)) {
+    for (const auto& row : parse_table) {
+        for (const auto& entry : row.second) {
             if (entry.second.production_index != NO_PRODUCTION) {
                 all_terminals.insert(entry.first);
             }
@@ -1062,9 +665,9 @@ void Parser::printParseTable() const {
     std::cout << "\n------------------------------------------------------\n";
     
     // Print each row (non-terminal)
-    for (int i = 0; i <= static_cast<int>(NonTerminal::FACTOR_TAIL); i++) {
-        NonTerminal nt = static_cast<NonTerminal>(i);
-        std::cout << std::left << std::setw(13) << nonTerminalToString(nt) << "| ";
+    for (const auto& row : parse_table) {
+        NonTerminal nt = row.first;
+        std::cout << std::left << std::setw(13) << first_follow.nameOf(nt) << "| ";
         
         // For each terminal, print the corresponding production
         for (const auto& terminal : all_terminals) {
@@ -1084,7 +687,7 @@ void Parser::printParseTable() const {
     std::cout << "\nProduction Legend:\n";
     for (size_t i = 0; i < first_follow.grammar.size(); i++) {
         const Production& prod = first_follow.grammar[i];
-        std::cout << i << ": " << nonTerminalToString(prod.lhs) << " → ";
+        std::cout << i << ": " << first_follow.nameOf(prod.lhs) << " → ";
         
         for (const auto& symbol : prod.rhs) {
             if (std::holds_alternative<std::string>(symbol)) {
@@ -1105,7 +708,7 @@ void Parser::printParseTable() const {
                         std::cout << "TOKEN_TYPE(" << static_cast<int>(tokenType) << ") ";
                 }
             } else {
-                std::cout << nonTerminalToString(std::get<NonTerminal>(symbol)) << " ";
+                std::cout << first_follow.nameOf(std::get<NonTerminal>(symbol)) << " ";
             }
         }
         std::cout << std::endl;
@@ -1143,76 +746,16 @@ std::string FirstFollowSets::getTokenTypeString(TokenType type) const {
 }
 
 // Implement additional Parser methods
-std::string Parser::getTokenKey(const Token& token) {
-    if (token.type == TokenType::Identifier ||
-        token.type == TokenType::IntegerLiteral ||
-        token.type == TokenType::FloatLiteral) {
-        return "$" + std::to_string(static_cast<int>(token.type));
-    }
-    return token.lexeme;
-}
-
-bool Parser::matchToken(const std::variant<std::string, TokenType>& expected) {
-    if (std::holds_alternative<std::string>(expected)) {
-        std::string lexeme = std::get<std::string>(expected);
-        if (current_token->lexeme == lexeme) {
-            tokens.advance();
-            current_token = &tokens.peek();
-            return true;
-        }
-        return false;
-    } else if (std::holds_alternative<TokenType>(expected)) {
-        TokenType type = std::get<TokenType>(expected);
-        if (current_token->type == type) {
-            tokens.advance();
-            current_token = &tokens.peek();
-            return true;
-        }
-        return false;
+void reportExpectedTerminal(ErrorReporter& reporter, const Token& token, TerminalId expected) {
+    if (expected == terminal::IDENTIFIER) {
+        reporter.report(diag::ExpectedTokenKind{}, token.loc, "identifier", token.lexeme);
+    } else if (expected == terminal::INTEGER_LITERAL) {
+        reporter.report(diag::ExpectedTokenKind{}, token.loc, "integer literal", token.lexeme);
+    } else if (expected == terminal::FLOAT_LITERAL) {
+        reporter.report(diag::ExpectedTokenKind{}, token.loc, "float literal", token.lexeme);
+    } else if (expected == terminal::STRING_LITERAL) {
+        reporter.report(diag::ExpectedTokenKind{}, token.loc, "unknown token type", token.lexeme);
+    } else {
+        reporter.report(diag::ExpectedToken{}, token.loc, terminal::spelling(expected), token.lexeme);
     }
-    return false;
-}
-
-void Parser::initGrammar() {
-    // Initialize grammar productions
-    productions.clear();
-    
-    // Program structure
-    productions.emplace_back(NonTerminal::PROGRAM, std::vector<std::variant<NonTerminal, std::string, TokenType>>{NonTerminal::MAIN_FUNCTION});
-    
-    // Main function
-    productions.emplace_back(NonTerminal::MAIN_FUNCTION, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        "int", "main", "(", ")", "{", NonTerminal::STATEMENT_LIST, "}"
-    });
-    
-    // Statement list
-    productions.emplace_back(NonTerminal::STATEMENT_LIST, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        NonTerminal::STATEMENT, NonTerminal::STATEMENT_LIST
-    });
-    productions.emplace_back(NonTerminal::STATEMENT_LIST, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        EPSILON // Empty statement list
-    });
-    
-    // Statement types
-    productions.emplace_back(NonTerminal::STATEMENT, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        NonTerminal::DECLARATION // Variable declaration
-    });
-    productions.emplace_back(NonTerminal::STATEMENT, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        NonTerminal::ASSIGNMENT // Assignment statement
-    });
-    productions.emplace_back(NonTerminal::STATEMENT, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        NonTerminal::LOOP // Loop statement
-    });
-    productions.emplace_back(NonTerminal::STATEMENT, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        NonTerminal::RETURN_STMT // Return statement
-    });
-    productions.emplace_back(NonTerminal::STATEMENT, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        NonTerminal::EXPRESSION, ";" // Expression statement (e.g., i++;)
-    });
-    productions.emplace_back(NonTerminal::STATEMENT, std::vector<std::variant<NonTerminal, std::string, TokenType>>{
-        EPSILON // Empty statement
-    });
-    
-    // Declaration
-    // ... existing code ...
 }
@@ -0,0 +1,301 @@
+#include "recursive_descent_parser.h"
+
+namespace {
+constexpr TerminalId INT = terminal::keyword(KeywordType::Int);
+constexpr TerminalId FLOAT = terminal::keyword(KeywordType::Float);
+constexpr TerminalId WHILE = terminal::keyword(KeywordType::While);
+constexpr TerminalId RETURN = terminal::keyword(KeywordType::Return);
+constexpr TerminalId LPAREN = terminal::punct(PunctuationType::LPAREN);
+constexpr TerminalId RPAREN = terminal::punct(PunctuationType::RPAREN);
+constexpr TerminalId LBRACE = terminal::punct(PunctuationType::LBRACE);
+constexpr TerminalId RBRACE = terminal::punct(PunctuationType::RBRACE);
+constexpr TerminalId SEMICOLON = terminal::op(OperatorType::SEMICOLON);
+constexpr TerminalId COMMA = terminal::op(OperatorType::COMMA);
+constexpr TerminalId EQUAL = terminal::op(OperatorType::EQUAL);
+
+// One more level of nesting for as long as it is in scope
+struct NestingLevel {
+    size_t& nesting;
+    explicit NestingLevel(size_t& count) : nesting(++count) {}
+    ~NestingLevel() { nesting--; }
+};
+}
+
+bool RecursiveDescentParser::parse() {
+    if (!begin()) {
+        return false;
+    }
+    
+    // PROGRAM → FUNCTION FUNCTION_LIST, with FUNCTION_LIST as a loop
+    bool parsed = hasProduction(NonTerminal::PROGRAM) ? parseFunction() && parseFunctionList()
+                                                      : noProduction(NonTerminal::PROGRAM);
+    if (!parsed) {
+        // Outside any block there is no statement list to resume in; the
+        // input is still skipped, for the error limit's sake
+        if (!stopped) {
+            resynchronize();
+        }
+        return false;
+    }
+    return finish();
+}
+
+bool RecursiveDescentParser::hasProduction(NonTerminal nonterm) const {
+    return GRAMMAR_TABLES.predict[static_cast<size_t>(nonterm)][lookahead()] != GrammarTables::NO_PRODUCTION;
+}
+
+bool RecursiveDescentParser::expectProduction(NonTerminal nonterm) {
+    return hasProduction(nonterm) || noProduction(nonterm);
+}
+
+bool RecursiveDescentParser::recover() {
+    stopped = stopped || !resynchronize();
+    return !stopped;
+}
+
+bool RecursiveDescentParser::nestingTooDeep() {
+    error_reporter.report(diag::NestingTooDeep{}, current_token->loc, MAX_NESTING);
+    stopped = true;
+    return false;
+}
+
+// FUNCTION_LIST → FUNCTION FUNCTION_LIST | ε, as a loop
+bool RecursiveDescentParser::parseFunctionList() {
+    while (lookahead() == INT || lookahead() == FLOAT) {
+        if (!parseFunction()) {
+            return false;
+        }
+    }
+    return expectProduction(NonTerminal::FUNCTION_LIST);
+}
+
+// FUNCTION → TYPE IDENTIFIER ( PARAMETER_LIST ) { STATEMENT_LIST }
+bool RecursiveDescentParser::parseFunction() {
+    if (!expectProduction(NonTerminal::FUNCTION) || !match(lookahead()) || !match(terminal::IDENTIFIER)) {  // TYPE
+        return false;
+    }
+    return match(LPAREN) && parseParameterList() && match(RPAREN) && parseBlock();
+}
+
+// PARAMETER_LIST → PARAMETER { , PARAMETER } | ε
+bool RecursiveDescentParser::parseParameterList() {
+    if (!expectProduction(NonTerminal::PARAMETER_LIST)) {
+        return false;
+    }
+    if (lookahead() == RPAREN) {
+        return true;
+    }
+    if (!parseParameter()) {
+        return false;
+    }
+    while (lookahead() == COMMA) {
+        if (!match(COMMA) || !parseParameter()) {
+            return false;
+        }
+    }
+    return expectProduction(NonTerminal::PARAMETER_TAIL);
+}
+
+// PARAMETER → TYPE IDENTIFIER
+bool RecursiveDescentParser::parseParameter() {
+    if (!hasProduction(NonTerminal::PARAMETER)) {
+        return noProduction(NonTerminal::PARAMETER);
+    }
+    return match(lookahead()) && match(terminal::IDENTIFIER);
+}
+
+bool RecursiveDescentParser::atStatementStart() const {
+    switch (lookahead()) {
+        case INT:
+        case FLOAT:
+        case WHILE:
+        case RETURN:
+        case terminal::IDENTIFIER:
+        case terminal::INTEGER_LITERAL:
+        case terminal::FLOAT_LITERAL:
+        case LPAREN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// { STATEMENT_LIST }. Once the '{' is matched the block is open, and a
+// syntax error in its statements, or a '}' missing after them, resumes in
+// its list.
+bool RecursiveDescentParser::parseBlock() {
+    if (!match(LBRACE)) {
+        return false;
+    }
+    while (parseStatementList()) {
+        if (match(RBRACE)) {
+            return true;
+        }
+        if (!recover()) {
+            break;
+        }
+    }
+    return false;
+}
+
+// STATEMENT_LIST → STATEMENT STATEMENT_LIST | ε, as a loop that stops at the
+// first token that cannot start a statement
+bool RecursiveDescentParser::parseStatementList() {
+    while (atStatementStart()) {
+        if (!parseStatement() && !recover()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecursiveDescentParser::parseStatement() {
+    switch (lookahead()) {
+        case INT:
+        case FLOAT:
+            return parseDeclaration();
+        case WHILE:
+            return parseLoop();
+        case RETURN:
+            return parseReturn();
+        case terminal::IDENTIFIER:
+            // An identifier followed by '=' is an assignment, anything else an expression
+            if (peekNext() == EQUAL) {
+                return parseAssignment();
+            }
+            return parseExpression() && match(SEMICOLON);
+        case terminal::INTEGER_LITERAL:
+        case terminal::FLOAT_LITERAL:
+        case LPAREN:
+            return parseExpression() && match(SEMICOLON);
+        default:
+            return true;  // ε
+    }
+}
+
+// DECLARATION → TYPE IDENTIFIER DECLARATION_TAIL
+// DECLARATION_TAIL → = EXPRESSION ; | ;
+bool RecursiveDescentParser::parseDeclaration() {
+    onNonTerminal(NonTerminal::DECLARATION);
+    if (!match(lookahead()) || !match(terminal::IDENTIFIER)) {  // TYPE
+        return false;
+    }
+    if (!hasProduction(NonTerminal::DECLARATION_TAIL)) {
+        return noProduction(NonTerminal::DECLARATION_TAIL);
+    }
+    if (lookahead() == EQUAL) {
+        return match(EQUAL) && parseExpression() && match(SEMICOLON);
+    }
+    return match(SEMICOLON);
+}
+
+// ASSIGNMENT → IDENTIFIER = EXPRESSION ;
+bool RecursiveDescentParser::parseAssignment() {
+    return match(terminal::IDENTIFIER) && match(EQUAL) && parseExpression() && match(SEMICOLON);
+}
+
+// LOOP → while ( CONDITION ) { STATEMENT_LIST }
+bool RecursiveDescentParser::parseLoop() {
+    NestingLevel level(nesting);
+    if (nesting > MAX_NESTING) {
+        return nestingTooDeep();
+    }
+    return match(WHILE) && match(LPAREN) && parseCondition() && match(RPAREN) && parseBlock();
+}
+
+// CONDITION → EXPRESSION RELATIONAL_OP EXPRESSION
+bool RecursiveDescentParser::parseCondition() {
+    if (!hasProduction(NonTerminal::CONDITION)) {
+        return noProduction(NonTerminal::CONDITION);
+    }
+    if (!parseExpression()) {
+        return false;
+    }
+    bool relational = hasProduction(NonTerminal::RELATIONAL_OP) ? match(lookahead())
+                                                                : noProduction(NonTerminal::RELATIONAL_OP);
+    return relational && parseExpression();
+}
+
+// RETURN_STMT → return EXPRESSION ;
+bool RecursiveDescentParser::parseReturn() {
+    return match(RETURN) && parseExpression() && match(SEMICOLON);
+}
+
+// EXPRESSION → TERM { (+|-) TERM }
+bool RecursiveDescentParser::parseExpression() {
+    NestingLevel level(nesting);
+    if (nesting > MAX_NESTING) {
+        return nestingTooDeep();
+    }
+    if (!hasProduction(NonTerminal::EXPRESSION)) {
+        return noProduction(NonTerminal::EXPRESSION);
+    }
+    if (!parseTerm()) {
+        return false;
+    }
+    while (lookahead() == terminal::op(OperatorType::PLUS) || lookahead() == terminal::op(OperatorType::MINUS)) {
+        if (!match(lookahead()) || !parseTerm()) {
+            return false;
+        }
+    }
+    return expectProduction(NonTerminal::EXPRESSION_TAIL);
+}
+
+// TERM → FACTOR { (*|/) FACTOR }
+bool RecursiveDescentParser::parseTerm() {
+    if (!hasProduction(NonTerminal::TERM)) {
+        return noProduction(NonTerminal::TERM);
+    }
+    if (!parseFactor()) {
+        return false;
+    }
+    while (lookahead() == terminal::op(OperatorType::STAR) || lookahead() == terminal::op(OperatorType::SLASH)) {
+        if (!match(lookahead()) || !parseFactor()) {
+            return false;
+        }
+    }
+    return expectProduction(NonTerminal::TERM_TAIL);
+}
+
+// FACTOR → IDENTIFIER [++|--|( ARGUMENT_LIST )] | INTEGER_LITERAL | FLOAT_LITERAL | ( EXPRESSION )
+bool RecursiveDescentParser::parseFactor() {
+    if (!hasProduction(NonTerminal::FACTOR)) {
+        return noProduction(NonTerminal::FACTOR);
+    }
+    switch (lookahead()) {
+        case terminal::IDENTIFIER:
+            if (!match(terminal::IDENTIFIER) || !expectProduction(NonTerminal::FACTOR_TAIL)) {
+                return false;
+            }
+            if (lookahead() == terminal::op(OperatorType::INC) || lookahead() == terminal::op(OperatorType::DEC)) {
+                return match(lookahead());
+            }
+            if (lookahead() == LPAREN) {
+                return match(LPAREN) && parseArgumentList() && match(RPAREN);
+            }
+            return true;
+        case LPAREN:
+            return match(LPAREN) && parseExpression() && match(RPAREN);
+        default:
+            return match(lookahead());  // Literal
+    }
+}
+
+// ARGUMENT_LIST → EXPRESSION { , EXPRESSION } | ε
+bool RecursiveDescentParser::parseArgumentList() {
+    if (!expectProduction(NonTerminal::ARGUMENT_LIST)) {
+        return false;
+    }
+    if (lookahead() == RPAREN) {
+        return true;
+    }
+    if (!parseExpression()) {
+        return false;
+    }
+    while (lookahead() == COMMA) {
+        if (!match(COMMA) || !parseExpression()) {
+            return false;
+        }
+    }
+    return expectProduction(NonTerminal::ARGUMENT_TAIL);
+}
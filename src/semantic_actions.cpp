@@ -0,0 +1,147 @@
+#include "semantic_actions.h"
+
+namespace {
+
+// Whether the identifier at index is the name a declaration or parameter
+// introduces, right after its type. Any other identifier read while a
+// declaration is parsed, such as one in its initializer, is a use.
+bool declaresName(const TokenStream& tokens, size_t index) {
+    TerminalId before = index > 0 ? tokens[index - 1].terminal : terminal::END_OF_FILE;
+    return before == terminal::keyword(KeywordType::Int) || before == terminal::keyword(KeywordType::Float);
+}
+
+// Declare function's parameters in the scope just opened for its body
+void declareParameters(SymbolTable& symtable, ErrorReporter& reporter, const FunctionInfo& function) {
+    for (const ParameterInfo& parameter : function.parameters) {
+        if (!symtable.insert(parameter.name, parameter.type)) {
+            reporter.report(diag::Redeclaration{}, parameter.loc, parameter.name);
+        }
+    }
+}
+
+}
+
+bool SemanticActions::begin(const TokenStream& tokens) {
+    if (tokens.isAtEnd()) {
+        error_reporter.report(diag::EmptyTokenStream{}, tokens.size() > 0 ? tokens[tokens.position()].loc : SourceLocation());
+        return false;
+    }
+    if (error_reporter.getErrorCount() > 0) {
+        return false;
+    }
+    symbol_table.enterScope();  // Global scope
+    global_scope = symbol_table.getCurrentScope();
+    return true;
+}
+
+void SemanticActions::declarationBegins() {
+    processing_declaration = true;
+    current_type = SymbolType::UNKNOWN;
+    declared_name.clear();
+}
+
+void SemanticActions::terminalMatched(TerminalId matched, const TokenStream& tokens, size_t index) {
+    const Token& token = tokens[index];
+    if (!parentheses.empty()) {
+        argumentMatched(matched);
+    }
+    if (matched == terminal::punct(PunctuationType::LPAREN)) {
+        parentheses.push_back({callee, false});
+        callee = NOT_A_CALL;
+    } else if (matched == terminal::punct(PunctuationType::RPAREN) && !parentheses.empty()) {
+        parentheses.pop_back();
+    }
+
+    if (matched == terminal::punct(PunctuationType::LBRACE)) {
+        // Opening a new block scope
+        symbol_table.enterScope();
+        if (parameters_pending) {
+            declareParameters(symbol_table, error_reporter, symbol_table.getFunctions().getFunctions().back());
+            parameters_pending = false;
+        }
+    } else if (matched == terminal::punct(PunctuationType::RBRACE)) {
+        symbol_table.exitScope();
+    } else if (matched == terminal::keyword(KeywordType::Int) || matched == terminal::keyword(KeywordType::Float)) {
+        // Capture the type for declarations
+        current_type = matched == terminal::keyword(KeywordType::Int) ? SymbolType::INT : SymbolType::FLOAT;
+        processing_declaration = true;
+    } else if (matched == terminal::op(OperatorType::SEMICOLON)) {
+        // End of declaration or statement
+        if (hasDeclaredName()) {
+            if (!symbol_table.insert(declared_name, current_type)) {
+                error_reporter.report(diag::Redeclaration{}, token.loc, declared_name);
+            }
+            declared_name.clear();
+            processing_declaration = false;
+        }
+    } else if (matched == terminal::IDENTIFIER) {
+        identifierMatched(tokens, index);
+    } else if (in_parameters && matched == terminal::op(OperatorType::COMMA)) {
+        parameterMatched(tokens, index);
+    } else if (in_parameters && matched == terminal::punct(PunctuationType::RPAREN)) {
+        parameterMatched(tokens, index);
+        in_parameters = false;
+        parameters_pending = true;
+    }
+}
+
+void SemanticActions::identifierMatched(const TokenStream& tokens, size_t index) {
+    const Token& token = tokens[index];
+    FunctionTable& functions = symbol_table.getFunctions();
+    size_t next = index + 1;
+    if (next < tokens.size() && tokens[next].terminal == terminal::punct(PunctuationType::LPAREN)) {
+        if (symbol_table.getCurrentScope() == global_scope) {
+            // A function's name; its parameters follow
+            functions.define(token.lexeme, current_type, token.loc);
+            processing_declaration = false;
+            declared_name.clear();
+            in_parameters = true;
+        } else {
+            // A callee, checked once every function is known; its '(' comes next
+            callee = functions.addCall(token.lexeme, token.loc);
+        }
+    } else if (processing_declaration && declaresName(tokens, index)) {
+        // The name being declared; identifiers in its initializer are uses
+        declared_name = token.lexeme;
+        declared_index = static_cast<uint32_t>(index);
+    } else if (!symbol_table.lookup(token.lexeme)) {
+        error_reporter.report(diag::UndeclaredVariable{}, token.loc, token.lexeme);
+    }
+}
+
+void SemanticActions::argumentMatched(TerminalId matched) {
+    Parenthesis& innermost = parentheses.back();
+    if (innermost.call == NOT_A_CALL) {
+        return;
+    }
+    FunctionTable& functions = symbol_table.getFunctions();
+    if (!innermost.started) {
+        // The first token after the '(' starts an argument unless it is the ')'
+        innermost.started = true;
+        if (matched != terminal::punct(PunctuationType::RPAREN)) {
+            functions.addArgument(innermost.call);
+        }
+    } else if (matched == terminal::op(OperatorType::COMMA)) {
+        functions.addArgument(innermost.call);
+    }
+}
+
+void SemanticActions::parameterMatched(const TokenStream& tokens, size_t index) {
+    if (hasDeclaredName()) {
+        symbol_table.getFunctions().addParameter(declared_name, current_type, tokens[index - 1].loc);
+    }
+    processing_declaration = false;
+    declared_name.clear();
+}
+
+void SemanticActions::abandonDeclaration() {
+    if (hasDeclaredName()) {
+        symbol_table.insert(declared_name, current_type);
+    }
+    processing_declaration = false;
+    declared_name.clear();
+    in_parameters = false;
+    // Parsing resumes between statements, outside any parentheses
+    parentheses.clear();
+    callee = NOT_A_CALL;
+}
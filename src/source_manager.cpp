@@ -0,0 +1,52 @@
+#include "source_manager.h"
+#include <cstdio>
+
+const SourceFile* SourceManager::load(const std::string& path) {
+    for (const auto& file : files) {
+        if (file->path == path) {
+            return file.get();
+        }
+    }
+    
+    std::shared_ptr<const std::string> text = readFile(path);
+    if (!text) {
+        return nullptr;
+    }
+    
+    auto file = std::make_unique<SourceFile>();
+    file->id = static_cast<uint32_t>(files.size());
+    file->path = path;
+    file->text = std::move(text);
+    files.push_back(std::move(file));
+    return files.back().get();
+}
+
+const SourceFile* SourceManager::getFile(uint32_t id) const {
+    return id < files.size() ? files[id].get() : nullptr;
+}
+
+std::shared_ptr<const std::string> SourceManager::readFile(const std::string& path) {
+    FILE* source = fopen(path.c_str(), "rb");
+    if (!source) {
+        return nullptr;
+    }
+    
+    auto text = std::make_shared<std::string>();
+    if (fseek(source, 0, SEEK_END) == 0) {
+        long size = ftell(source);
+        if (size > 0) {
+            text->reserve(static_cast<size_t>(size));
+        }
+        fseek(source, 0, SEEK_SET);
+    }
+    
+    // Read until EOF rather than trusting the size, which may be short for pipes
+    char chunk[64 * 1024];
+    size_t bytes_read;
+    while ((bytes_read = fread(chunk, 1, sizeof(chunk), source)) > 0) {
+        text->append(chunk, bytes_read);
+    }
+    
+    fclose(source);
+    return text;
+}
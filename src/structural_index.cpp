@@ -0,0 +1,257 @@
+#include "structural_index.h"
+#include <algorithm>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t BLOCK = 64;
+
+// One bit per byte of a block, bit i for byte i
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t slash;
+    uint64_t star;
+    uint64_t newline;
+    uint64_t structural;
+};
+
+#if defined(__SSE2__)
+// Bits of one 16-byte chunk, placed at its offset in the block
+inline uint64_t bitsOf(__m128i matches, int chunk) {
+    return uint64_t(static_cast<uint32_t>(_mm_movemask_epi8(matches))) << (16 * chunk);
+}
+
+inline __m128i structuralBytes(__m128i chunk) {
+    // '(' and ')' are 0x28 and 0x29, '{' and '}' 0x7b and 0x7d
+    __m128i parens = _mm_cmpeq_epi8(_mm_or_si128(chunk, _mm_set1_epi8(1)), _mm_set1_epi8(')'));
+    __m128i braces = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}')));
+    return _mm_or_si128(_mm_or_si128(parens, braces), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(';')));
+}
+
+uint64_t classifyStructural(const char* block, uint64_t& special) {
+    uint64_t structural = 0;
+    special = 0;
+    for (int k = 0; k < 4; k++) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * k));
+        __m128i quotes = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                                      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+        __m128i comments = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('/')),
+                                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('*')));
+        special |= bitsOf(_mm_or_si128(quotes, comments), k);
+        structural |= bitsOf(structuralBytes(chunk), k);
+    }
+    return structural;
+}
+
+BlockMasks classify(const char* block) {
+    BlockMasks masks = {};
+    for (int k = 0; k < 4; k++) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * k));
+        masks.quote |= bitsOf(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), k);
+        masks.backslash |= bitsOf(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')), k);
+        masks.slash |= bitsOf(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('/')), k);
+        masks.star |= bitsOf(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('*')), k);
+        masks.newline |= bitsOf(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), k);
+        masks.structural |= bitsOf(structuralBytes(chunk), k);
+    }
+    return masks;
+}
+#else
+BlockMasks classify(const char* block) {
+    BlockMasks masks = {};
+    for (size_t i = 0; i < BLOCK; i++) {
+        uint64_t bit = uint64_t(1) << i;
+        switch (block[i]) {
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '/': masks.slash |= bit; break;
+            case '*': masks.star |= bit; break;
+            case '\n': masks.newline |= bit; break;
+            case '{': case '}': case '(': case ')': case ';': masks.structural |= bit; break;
+            default: break;
+        }
+    }
+    return masks;
+}
+
+uint64_t classifyStructural(const char* block, uint64_t& special) {
+    BlockMasks masks = classify(block);
+    special = masks.quote | masks.backslash | masks.slash | masks.star;
+    return masks.structural;
+}
+#endif
+
+// Bit i set where an odd number of bits at or below i are: the bytes from
+// an opening quote up to, not including, its closing one
+inline uint64_t prefixXor(uint64_t bits) {
+#if defined(__PCLMUL__)
+    __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(bits)), _mm_set1_epi8(-1), 0);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+#else
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+#endif
+}
+
+// Bits at position from and above; none once from is past the block
+inline uint64_t from(uint32_t position) { return position < BLOCK ? ~uint64_t(0) << position : 0; }
+
+inline uint32_t lowest(uint64_t bits) { return static_cast<uint32_t>(__builtin_ctzll(bits)); }
+
+// What the byte at the start of a block is part of
+enum class Mode : uint8_t {
+    Code,
+    String,
+    LineComment,
+    BlockComment
+};
+
+}
+
+void StructuralIndex::flatten(size_t base, uint64_t structural, const char* text, size_t& count) {
+    // Room for a whole block at a time, trimmed to count once every block is done
+    if (offsets.size() < count + BLOCK) {
+        offsets.resize(std::max(2 * offsets.size(), count + BLOCK));
+        characters.resize(offsets.size());
+    }
+    for (; structural != 0; structural &= structural - 1, count++) {
+        uint32_t at = static_cast<uint32_t>(base) + lowest(structural);
+        offsets[count] = at;
+        characters[count] = text[at];
+    }
+}
+
+void StructuralIndex::build(const char* text, size_t size) {
+    offsets.clear();
+    characters.clear();
+    matches.clear();
+    const void* nul = std::memchr(text, '\0', size);
+    if (nul) {
+        size = static_cast<const char*>(nul) - text;
+    }
+
+    size_t count = 0;  // Characters found so far
+    Mode mode = Mode::Code;
+    uint32_t carry = 0;  // Bytes at the start of the block consumed by the previous one
+    char tail[BLOCK];
+    for (size_t base = 0; base < size; base += BLOCK) {
+        // The last, partial block is padded with spaces, which are nothing
+        const char* block = text + base;
+        if (size - base < BLOCK) {
+            std::memset(tail, ' ', BLOCK);
+            std::memcpy(tail, block, size - base);
+            block = tail;
+        }
+
+        // Most blocks of code hold no quote, backslash or comment
+        // delimiter, and need only their structural characters
+        uint64_t special;
+        uint64_t structural = classifyStructural(block, special);
+        if (special == 0 && carry == 0 && (mode == Mode::Code || mode == Mode::String)) {
+            if (mode == Mode::Code && structural != 0) {
+                flatten(base, structural, text, count);
+            }
+            continue;
+        }
+        BlockMasks masks = classify(block);
+
+        // Two-byte delimiters, marked at their first byte; the second may
+        // be the first byte of the next block
+        uint64_t next_slash = masks.slash >> 1;
+        uint64_t next_star = masks.star >> 1;
+        if (base + BLOCK < size) {
+            next_slash |= uint64_t(text[base + BLOCK] == '/') << 63;
+            next_star |= uint64_t(text[base + BLOCK] == '*') << 63;
+        }
+        uint64_t line_comment = masks.slash & next_slash;
+        uint64_t block_comment = masks.slash & next_star;
+        uint64_t comment_end = masks.star & next_slash;
+
+        structural = 0;
+        uint64_t in_string = prefixXor(masks.quote) ^ (mode == Mode::String ? ~uint64_t(0) : 0);
+        if (carry == 0 && (mode == Mode::Code || mode == Mode::String) &&
+            ((line_comment | block_comment) & ~in_string) == 0 && (masks.backslash & in_string) == 0) {
+            // Quotes alone decide what is inside a string
+            structural = masks.structural & ~in_string;
+            mode = in_string >> 63 ? Mode::String : Mode::Code;
+        } else {
+            uint32_t position = carry;
+            while (position < BLOCK) {
+                uint64_t ahead = from(position);
+                if (mode == Mode::Code) {
+                    uint64_t starts = (masks.quote | line_comment | block_comment) & ahead;
+                    if (starts == 0) {
+                        structural |= masks.structural & ahead;
+                        position = BLOCK;
+                        break;
+                    }
+                    uint32_t start = lowest(starts);
+                    structural |= masks.structural & ahead & ~from(start);
+                    if (masks.quote >> start & 1) {
+                        mode = Mode::String;
+                        position = start + 1;
+                    } else {
+                        mode = line_comment >> start & 1 ? Mode::LineComment : Mode::BlockComment;
+                        position = start + 2;
+                    }
+                } else if (mode == Mode::String) {
+                    // A backslash escapes whatever follows it
+                    uint64_t stops = (masks.quote | masks.backslash) & ahead;
+                    if (stops == 0) {
+                        position = BLOCK;
+                        break;
+                    }
+                    uint32_t stop = lowest(stops);
+                    if (masks.backslash >> stop & 1) {
+                        position = stop + 2;
+                    } else {
+                        mode = Mode::Code;
+                        position = stop + 1;
+                    }
+                } else {
+                    uint64_t ends = (mode == Mode::LineComment ? masks.newline : comment_end) & ahead;
+                    if (ends == 0) {
+                        position = BLOCK;
+                        break;
+                    }
+                    uint32_t end = lowest(ends);
+                    position = end + (mode == Mode::LineComment ? 1 : 2);
+                    mode = Mode::Code;
+                }
+            }
+            carry = position - BLOCK;
+        }
+
+        flatten(base, structural, text, count);
+    }
+    offsets.resize(count);
+    characters.resize(count);
+
+    // Stage 2: match the brackets, braces and parentheses on stacks of their own
+    matches.assign(count, NO_MATCH);
+    std::vector<uint32_t> open_braces;
+    std::vector<uint32_t> open_parens;
+    for (uint32_t i = 0; i < count; i++) {
+        char c = characters[i];
+        std::vector<uint32_t>& open = c == '{' || c == '}' ? open_braces : open_parens;
+        if (c == '{' || c == '(') {
+            open.push_back(i);
+        } else if ((c == '}' || c == ')') && !open.empty()) {
+            matches[i] = open.back();
+            matches[open.back()] = i;
+            open.pop_back();
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include "symbol_table.h"
 #include <iostream>
+#include <unordered_map>
 
 SymbolTable::SymbolTable() : current_scope(0) {
     // Initialize with global scope
@@ -11,6 +12,9 @@ void SymbolTable::enterScope() {
     current_scope++;
     if (current_scope >= scopes.size()) {
         scopes.push_back(std::unordered_map<std::string, SymbolInfo>());
+    } else {
+        // Left over from the last block at this depth, which has closed
+        scopes[current_scope].clear();
     }
 }
 
@@ -151,3 +155,59 @@ std::vector<SymbolInfo> SymbolTable::getAllSymbols() const {
     
     return result;
 }
+
+// FunctionTable
+
+void FunctionTable::define(const std::string& name, SymbolType return_type, const SourceLocation& loc) {
+    functions.push_back({name, return_type, loc, {}});
+}
+
+void FunctionTable::addParameter(const std::string& name, SymbolType type, const SourceLocation& loc) {
+    functions.back().parameters.push_back({name, type, loc});
+}
+
+size_t FunctionTable::addCall(const std::string& name, const SourceLocation& loc) {
+    calls.push_back({name, 0, loc});
+    return calls.size() - 1;
+}
+
+void FunctionTable::merge(FunctionTable&& other) {
+    functions.insert(functions.end(), std::make_move_iterator(other.functions.begin()),
+                     std::make_move_iterator(other.functions.end()));
+    calls.insert(calls.end(), std::make_move_iterator(other.calls.begin()),
+                 std::make_move_iterator(other.calls.end()));
+    other.functions.clear();
+    other.calls.clear();
+}
+
+size_t FunctionTable::check(ErrorReporter& reporter) const {
+    size_t errors = 0;
+    std::unordered_map<std::string, const FunctionInfo*> defined;
+    for (const FunctionInfo& function : functions) {
+        if (!defined.emplace(function.name, &function).second) {
+            reporter.report(diag::FunctionRedefinition{}, function.loc, function.name);
+            errors++;
+        }
+    }
+    for (const CallSite& call : calls) {
+        auto it = defined.find(call.name);
+        if (it == defined.end()) {
+            reporter.report(diag::UndefinedFunction{}, call.loc, call.name);
+            errors++;
+        } else if (it->second->parameters.size() != call.argument_count) {
+            reporter.report(diag::ArgumentCountMismatch{}, call.loc, call.name, it->second->parameters.size(),
+                            call.argument_count);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+const FunctionInfo* FunctionTable::find(const std::string& name) const {
+    for (const FunctionInfo& function : functions) {
+        if (function.name == name) {
+            return &function;
+        }
+    }
+    return nullptr;
+}
@@ -1,56 +1,248 @@
 #include "token.h"
+#include <algorithm>
+#include <new>
+#include <utility>
+
+namespace {
+// Spellings in KeywordType, OperatorType and PunctuationType order
+const char* const KEYWORD_SPELLINGS[terminal::KEYWORD_COUNT] = {
+    "auto", "const", "double", "float", "int", "struct", "break", "continue", "else", "if", "for",
+    "short", "unsigned", "long", "signed", "switch", "case", "default", "void", "enum", "goto",
+    "register", "sizeof", "typedef", "volatile", "char", "do", "extern", "static", "union", "while", "return"
+};
+
+const char* const OPERATOR_SPELLINGS[terminal::OPERATOR_COUNT] = {
+    "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||", "*=", "/=", "%=", "+=", "-=",
+    "<<=", ">>=", "&=", "^=", "|=", "+", "-", "*", "/", "%", "<", ">", "=", ".", ",", ";", ":",
+    "!", "?", "~", "&", "|", "^"
+};
+
+const char* const PUNCTUATION_SPELLINGS[terminal::PUNCTUATION_COUNT] = {
+    "(", ")", "{", "}", "[", "]", "<", ">"
+};
+
+// Token classes use the "$<TokenType>" placeholders of the grammar
+const char* const CLASS_SPELLINGS[terminal::COUNT - terminal::IDENTIFIER] = {
+    "$1", "$2", "$3", "$4", "main", "$", "<error>"
+};
+}
+
+const char* terminal::spelling(TerminalId id) {
+    if (id < OPERATOR_BASE) {
+        return KEYWORD_SPELLINGS[id - KEYWORD_BASE];
+    }
+    if (id < PUNCTUATION_BASE) {
+        return OPERATOR_SPELLINGS[id - OPERATOR_BASE];
+    }
+    if (id < IDENTIFIER) {
+        return PUNCTUATION_SPELLINGS[id - PUNCTUATION_BASE];
+    }
+    if (id < COUNT) {
+        return CLASS_SPELLINGS[id - IDENTIFIER];
+    }
+    return "<unknown>";
+}
+
+TerminalId terminal::fromSpelling(const std::string& text) {
+    // Operators come before punctuation so "<" and ">" resolve to what the lexer emits
+    for (TerminalId id = 0; id < COUNT; id++) {
+        if (text == spelling(id)) {
+            return id;
+        }
+    }
+    return COUNT;
+}
+
+TerminalId classifyTerminal(const Token& token) {
+    switch (token.type) {
+        case TokenType::Keyword: return terminal::keyword(token.subtype.keyword);
+        case TokenType::Operator: return terminal::op(token.subtype.op);
+        case TokenType::Punctuation: return terminal::punct(token.subtype.punct);
+        case TokenType::Identifier: return terminal::IDENTIFIER;
+        case TokenType::IntegerLiteral: return terminal::INTEGER_LITERAL;
+        case TokenType::FloatLiteral: return terminal::FLOAT_LITERAL;
+        case TokenType::StringLiteral: return terminal::STRING_LITERAL;
+        case TokenType::Eof: return terminal::END_OF_FILE;
+        default: return terminal::ERROR;
+    }
+}
 
 // TokenStream implementation
+TokenStream::TokenStream(const std::vector<Token>& tokens) : count(0), current(0), sync_cursor(0) {
+    for (const Token& token : tokens) {
+        add(token);
+    }
+}
+
+TokenStream::TokenStream(const TokenStream& other) : count(0), current(other.current), sync_cursor(0) {
+    for (size_t i = 0; i < other.count; i++) {
+        add(other.at(i));
+    }
+}
+
+TokenStream::TokenStream(TokenStream&& other) noexcept
+    : blocks(std::move(other.blocks)), count(other.count), current(other.current),
+      sync_points(std::move(other.sync_points)), brace_pairs(std::move(other.brace_pairs)),
+      open_braces(std::move(other.open_braces)), sync_cursor(other.sync_cursor) {
+    other.blocks.clear();
+    other.count = 0;
+    other.current = 0;
+}
+
+TokenStream& TokenStream::operator=(TokenStream other) noexcept {
+    std::swap(blocks, other.blocks);
+    std::swap(count, other.count);
+    std::swap(current, other.current);
+    std::swap(sync_points, other.sync_points);
+    std::swap(brace_pairs, other.brace_pairs);
+    std::swap(open_braces, other.open_braces);
+    std::swap(sync_cursor, other.sync_cursor);
+    return *this;
+}
+
+TokenStream::~TokenStream() {
+    clear();
+}
+
+void TokenStream::clear() {
+    for (size_t i = 0; i < count; i++) {
+        at(i).~Token();
+    }
+    for (Token* block : blocks) {
+        ::operator delete(block);
+    }
+    blocks.clear();
+    count = 0;
+    current = 0;
+    sync_points.clear();
+    brace_pairs.clear();
+    open_braces.clear();
+    sync_cursor = 0;
+}
+
+void TokenStream::indexToken(const Token& token, size_t index) {
+    uint32_t position = static_cast<uint32_t>(index);
+    uint32_t depth = static_cast<uint32_t>(open_braces.size());
+    
+    if (token.type == TokenType::Operator && token.subtype.op == OperatorType::SEMICOLON) {
+        sync_points.push_back({position, depth, SyncKind::Terminator});
+    } else if (token.type == TokenType::Keyword) {
+        KeywordType kw = token.subtype.keyword;
+        if (kw == KeywordType::Int || kw == KeywordType::Float ||
+            kw == KeywordType::While || kw == KeywordType::If ||
+            kw == KeywordType::Return) {
+            sync_points.push_back({position, depth, SyncKind::StatementStart});
+        }
+    } else if (token.type == TokenType::Punctuation) {
+        if (token.subtype.punct == PunctuationType::LBRACE) {
+            open_braces.push_back(static_cast<uint32_t>(brace_pairs.size()));
+            brace_pairs.push_back({position, NO_MATCH});
+        } else if (token.subtype.punct == PunctuationType::RBRACE) {
+            sync_points.push_back({position, depth, SyncKind::BlockEnd});
+            if (!open_braces.empty()) {
+                brace_pairs[open_braces.back()].second = position;
+                open_braces.pop_back();
+            }
+        }
+    }
+}
+
+size_t TokenStream::nextSyncPoint(size_t from) {
+    // Resume from the cursor when moving forward, otherwise binary search
+    if (sync_cursor > 0 && sync_cursor <= sync_points.size() &&
+        sync_points[sync_cursor - 1].token_index >= from) {
+        auto it = std::lower_bound(sync_points.begin(), sync_points.end(), from,
+            [](const SyncPoint& point, size_t index) { return point.token_index < index; });
+        sync_cursor = static_cast<size_t>(it - sync_points.begin());
+    }
+    while (sync_cursor < sync_points.size() && sync_points[sync_cursor].token_index < from) {
+        sync_cursor++;
+    }
+    return sync_cursor < sync_points.size() ? sync_points[sync_cursor].token_index : count;
+}
+
 Token& TokenStream::peek() {
     if (isAtEnd()) {
-        static Token eofToken;
-        eofToken.type = TokenType::Eof;
+        // Initialised once so concurrent streams never write to it
+        static Token eofToken = [] {
+            Token token;
+            token.type = TokenType::Eof;
+            token.terminal = terminal::END_OF_FILE;
+            return token;
+        }();
         return eofToken;
     }
-    return tokens[current];
+    return at(current);
 }
 
 void TokenStream::add(Token token) {
-    tokens.push_back(token);
+    // Only the directory may grow; token storage is never relocated
+    if ((count >> BLOCK_SHIFT) == blocks.size()) {
+        blocks.push_back(static_cast<Token*>(::operator new(sizeof(Token) * BLOCK_SIZE)));
+    }
+    new (&at(count)) Token(std::move(token));
+    indexToken(at(count), count);
+    count++;
 }
 
 Token& TokenStream::advance() {
     if (!isAtEnd()) {
-        Token& currentToken = tokens[current];
+        Token& currentToken = at(current);
         current++;
         return currentToken;
     }
-    return tokens[current];
+    return peek();
 }
 
 bool TokenStream::isAtEnd() const {
-    return current >= tokens.size();
+    return current >= count;
 }
 
 void TokenStream::reset() {
     current = 0;
 }
 
-void TokenStream::synchronize() {
+void TokenStream::synchronize(bool skip_blocks) {
     advance();
+    if (isAtEnd()) {
+        return;
+    }
     
-    while (!isAtEnd()) {
-        if (peek().type == TokenType::Operator && 
-            peek().subtype.op == OperatorType::SEMICOLON) {
-            return;
+    // Jump straight to the next ';', '}' or statement keyword recorded by the index
+    size_t next = nextSyncPoint(current);
+    if (skip_blocks) {
+        auto open = std::lower_bound(brace_pairs.begin(), brace_pairs.end(), current,
+            [](const std::pair<uint32_t, uint32_t>& pair, size_t index) { return pair.first < index; });
+        if (open != brace_pairs.end() && open->first < next) {
+            // A block ends a statement, so just past it is a fine place to stop
+            next = open->second == NO_MATCH ? count : open->second + 1;
         }
-        
-        if (peek().type == TokenType::Keyword) {
-            KeywordType kw = peek().subtype.keyword;
-            if (kw == KeywordType::Int || kw == KeywordType::Float ||
-                kw == KeywordType::While || kw == KeywordType::If ||
-                kw == KeywordType::Return) {
-                return;
-            }
-        }
-        
-        advance();
     }
+    current = next;
+}
+
+bool TokenStream::atSyncPoint() {
+    return isAtEnd() || nextSyncPoint(current) == current;
+}
+
+bool TokenStream::skipBlock() {
+    if (isAtEnd() || peek().type != TokenType::Punctuation ||
+        peek().subtype.punct != PunctuationType::LBRACE) {
+        return false;
+    }
+    
+    size_t close = matchingBrace(current);
+    current = close < count ? close + 1 : count;
+    return close < count;
+}
+
+size_t TokenStream::matchingBrace(size_t open_index) const {
+    auto it = std::lower_bound(brace_pairs.begin(), brace_pairs.end(), open_index,
+        [](const std::pair<uint32_t, uint32_t>& pair, size_t index) { return pair.first < index; });
+    if (it == brace_pairs.end() || it->first != open_index || it->second == NO_MATCH) {
+        return count;
+    }
+    return it->second;
 }
 
 void TokenStream::rewind() {
@@ -7,6 +7,8 @@
 #include "lexer.h"
 #include "token.h"
 #include "error.h"
+#include "structural_index.h"
+#include <random>
 
 // We don't need to declare errorReporter here since it's already defined in error.cpp
 // and declared as extern in error.h
@@ -502,6 +504,258 @@ void testSampleProgram() {
     std::cout << "Sample program test passed!\n";
 }
 
+// Test that TokenStream keeps token addresses stable while it grows
+void testTokenStreamStableAddresses() {
+    TokenStream tokenStream;
+    
+    Token first;
+    first.type = TokenType::Identifier;
+    first.lexeme = "first";
+    tokenStream.add(first);
+    
+    // Hold on to the first token the way the parser holds current_token
+    Token* firstPtr = &tokenStream.peek();
+    
+    // Grow well past several storage blocks
+    for (int i = 1; i < 5000; i++) {
+        Token token;
+        token.type = TokenType::IntegerLiteral;
+        token.value.int_value = i;
+        token.lexeme = std::to_string(i);
+        tokenStream.add(token);
+    }
+    
+    assert(tokenStream.size() == 5000);
+    assert(firstPtr == &tokenStream[0]);
+    assert(firstPtr->lexeme == "first");
+    assert(tokenStream[4999].value.int_value == 4999);
+    
+    // Copies are deep and independent of the original
+    TokenStream copy = tokenStream;
+    copy[0].lexeme = "changed";
+    assert(tokenStream[0].lexeme == "first");
+    assert(copy.size() == tokenStream.size());
+    
+    // Walking the stream visits every token in order
+    int visited = 0;
+    while (!copy.isAtEnd()) {
+        copy.advance();
+        visited++;
+    }
+    assert(visited == 5000);
+    
+    std::cout << "TokenStream stable address test passed!\n";
+}
+
+// Test the synchronization-point index recorded during tokenization
+void testSyncPointIndex() {
+    std::string source =
+        "int main() {\n"
+        "    x = = 3;\n"
+        "    while (x < 3) { y = ; { z; } }\n"
+        "    return 0;\n"
+        "}\n";
+    std::string filename = createTempFile(source);
+    
+    errorReporter.init(filename);
+    Lexer lexer(filename);
+    TokenStream tokenStream = lexer.tokenize();
+    
+    // Every recorded point is a ';', a '}' or a statement keyword, in token order
+    const std::vector<SyncPoint>& points = tokenStream.getSyncPoints();
+    assert(!points.empty());
+    for (size_t i = 0; i < points.size(); i++) {
+        const Token& token = tokenStream[points[i].token_index];
+        if (points[i].kind == SyncKind::Terminator) {
+            assert(token.lexeme == ";");
+        } else if (points[i].kind == SyncKind::BlockEnd) {
+            assert(token.lexeme == "}");
+        } else {
+            assert(token.type == TokenType::Keyword);
+        }
+        assert(i == 0 || points[i - 1].token_index < points[i].token_index);
+    }
+    assert(points.front().brace_depth == 0);  // The leading 'int'
+    
+    // Recovery from inside the broken assignment lands on its ';'
+    while (tokenStream.peek().lexeme != "x") {
+        tokenStream.advance();
+    }
+    tokenStream.synchronize();
+    assert(tokenStream.peek().lexeme == ";");
+    assert(tokenStream.peek().loc.line == 2);
+    
+    // The next recovery lands on 'while'
+    tokenStream.synchronize();
+    assert(tokenStream.peek().lexeme == "while");
+    
+    // Skipping the loop body jumps over the nested block in one step
+    while (tokenStream.peek().lexeme != "{") {
+        tokenStream.advance();
+    }
+    assert(tokenStream.skipBlock());
+    assert(tokenStream.peek().lexeme == "return");
+    assert(tokenStream.peek().loc.line == 4);
+    
+    // Rewinding still finds the right sync point
+    tokenStream.reset();
+    tokenStream.synchronize();
+    assert(tokenStream.peek().lexeme == ";");
+    
+    // Without entering blocks: past the loop's condition, the body is
+    // skipped whole, and the nested block's '}' is never a landing point
+    while (tokenStream.peek().lexeme != "<") {
+        tokenStream.advance();
+    }
+    tokenStream.synchronize(true);
+    assert(tokenStream.peek().lexeme == "return");
+    assert(tokenStream.atSyncPoint());
+    tokenStream.reset();
+    while (tokenStream.peek().lexeme != "z") {
+        tokenStream.advance();
+    }
+    tokenStream.synchronize();
+    assert(tokenStream.peek().lexeme == ";");
+    tokenStream.synchronize();
+    assert(tokenStream.peek().lexeme == "}");
+    assert(tokenStream.peek().loc.line == 3);
+    
+    std::cout << "Sync point index test passed!\n";
+}
+
+// Test the terminal ids the lexer assigns for parse-table lookups
+void testTerminalIds() {
+    std::string source = "int main() { x = 42 + 1.5; return x <= y; }";
+    std::string filename = createTempFile(source);
+    
+    errorReporter.init(filename);
+    Lexer lexer(filename);
+    TokenStream tokenStream = lexer.tokenize();
+    
+    // Every token's id spells its lexeme, or its class placeholder
+    for (size_t i = 0; i < tokenStream.size(); i++) {
+        const Token& token = tokenStream[i];
+        assert(token.terminal < terminal::COUNT);
+        if (token.type == TokenType::Keyword || token.type == TokenType::Operator ||
+            token.type == TokenType::Punctuation) {
+            assert(token.lexeme == terminal::spelling(token.terminal));
+        }
+    }
+    
+    assert(tokenStream[0].terminal == terminal::keyword(KeywordType::Int));
+    assert(tokenStream[1].terminal == terminal::IDENTIFIER);  // "main" is only contextual
+    assert(tokenStream[2].terminal == terminal::punct(PunctuationType::LPAREN));
+    assert(tokenStream[7].terminal == terminal::INTEGER_LITERAL);
+    assert(tokenStream[9].terminal == terminal::FLOAT_LITERAL);
+    assert(tokenStream[13].terminal == terminal::op(OperatorType::LE));
+    assert(tokenStream[tokenStream.size() - 1].terminal == terminal::END_OF_FILE);
+    
+    // Grammar spellings map back to the ids the lexer produces
+    assert(terminal::fromSpelling("<") == terminal::op(OperatorType::LESS));
+    assert(terminal::fromSpelling("$1") == terminal::IDENTIFIER);
+    assert(terminal::fromSpelling("$") == terminal::END_OF_FILE);
+    assert(terminal::fromSpelling("while") == terminal::keyword(KeywordType::While));
+    assert(terminal::fromSpelling("nonsense") == terminal::COUNT);
+    
+    std::cout << "Terminal id test passed!\n";
+}
+
+// Test the structural index against the lexer's tokens
+static void checkStructuralIndex(const std::string& source) {
+    std::string filename = createTempFile(source);
+    ErrorReporter reporter;
+    std::string diagnostics;
+    reporter.setOutput(&diagnostics);
+    Lexer lexer(filename, reporter);
+    TokenStream tokenStream = lexer.tokenize();
+    
+    // The lexer's '{', '}', '(', ')' and ';' tokens
+    std::vector<size_t> tokens;
+    for (size_t i = 0; i < tokenStream.size(); i++) {
+        const std::string& lexeme = tokenStream[i].lexeme;
+        if ((tokenStream[i].type == TokenType::Punctuation || tokenStream[i].type == TokenType::Operator) &&
+            lexeme.size() == 1 && std::string("{}();").find(lexeme[0]) != std::string::npos) {
+            tokens.push_back(i);
+        }
+    }
+    
+    StructuralIndex index;
+    index.build(source);
+    assert(index.size() == tokens.size());
+    
+    // Same characters at the same places, found in one pass over the offsets
+    size_t line = 1, column = 1, at = 0;
+    for (size_t i = 0; i < index.size(); i++) {
+        for (; at < index.offset(i); at++) {
+            if (source[at] == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+        }
+        const Token& token = tokenStream[tokens[i]];
+        assert(index.character(i) == token.lexeme[0]);
+        assert(token.loc.line == line && token.loc.column == column);
+        
+        // Braces match as the token stream matches them
+        if (index.character(i) == '{') {
+            size_t close = tokenStream.matchingBrace(tokens[i]);
+            uint32_t match = index.match(i);
+            assert(match == StructuralIndex::NO_MATCH ? close == tokenStream.size() : tokens[match] == close);
+            assert(match == StructuralIndex::NO_MATCH || index.match(match) == i);
+        }
+    }
+}
+
+void testStructuralIndex() {
+    // Comments and strings hide what is inside them, each from the other
+    checkStructuralIndex("int main() { // f(x);\n"
+                         "    s = \"a { b\"; /* } \" ( */ t = \"// not a comment\"; /*/ ; */\n"
+                         "    u = \"escaped \\\" quote; \\\\\"; v = \"x\\\\\"; /** ; **/ w(1);\n"
+                         "}\n");
+    
+    // Delimiters split across 64-byte blocks, and strings spanning several
+    std::string source;
+    for (size_t pad = 0; pad < 70; pad++) {
+        source = std::string(pad, ' ') + "/* a */ f(); // ; {\n g(\"" + std::string(pad * 3, ';') +
+                 "\\\"\"); { /* } */ }";
+        checkStructuralIndex(source);
+    }
+    
+    // Unterminated comments and strings run to the end of the file
+    checkStructuralIndex("f(); /* g(); { ");
+    checkStructuralIndex("f(); \"g(); { \n h(); ");
+    checkStructuralIndex("f(); \"\\");
+    
+    // Brackets: nested, unmatched either way, and interleaved
+    StructuralIndex index;
+    index.build("{ ( { ) } } ) { (");
+    assert(index.size() == 9);
+    assert(index.match(0) == 5 && index.match(5) == 0);
+    assert(index.match(1) == 3 && index.match(3) == 1);
+    assert(index.match(2) == 4 && index.match(4) == 2);
+    assert(index.match(6) == StructuralIndex::NO_MATCH);
+    assert(index.match(7) == StructuralIndex::NO_MATCH && index.match(8) == StructuralIndex::NO_MATCH);
+    
+    // The text ends at a NUL, as it does for the lexer
+    index.build(std::string("f();\0g();", 9));
+    assert(index.size() == 3);
+    
+    // Random text made mostly of the characters that matter
+    std::mt19937 random(49);
+    const char alphabet[] = "{}();\"\\/*\n a";
+    for (int round = 0; round < 300; round++) {
+        std::string text(random() % 400, ' ');
+        for (char& c : text) {
+            c = alphabet[random() % (sizeof(alphabet) - 1)];
+        }
+        checkStructuralIndex(text);
+    }
+    
+    std::cout << "Structural index test passed!\n";
+}
+
 // Main test runner function (not the actual main)
 void testLexer() {
     // Run all the tests
@@ -513,6 +767,10 @@ void testLexer() {
     testCompleteFunction();
     testTokenLocation();
     testSampleProgram();
+    testTokenStreamStableAddresses();
+    testSyncPointIndex();
+    testTerminalIds();
+    testStructuralIndex();
     
     std::cout << "All lexer tests passed!\n";
 }
\ No newline at end of file
@@ -13,6 +13,7 @@ const bool SYMBOL_TABLE_IMPLEMENTED = true;  // Set to true since symbol table i
 void testLexer(); // Lexer test function
 int run_parser_tests(); // Parser test function (renamed from main)
 int run_symbol_table_tests(); // Symbol table test function (renamed from main)
+int run_parser_stress_tests(); // Huge-program parser tests, run only on request
 
 int main(int argc, char* argv[]) {
     // If a specific test suite is requested, run only that
@@ -49,8 +50,18 @@ int main(int argc, char* argv[]) {
             return 0;
         }
         
+        if (testSuite == "parser_stress") {
+            if (PARSER_IMPLEMENTED) {
+                std::cout << "Running parser stress tests...\n";
+                return run_parser_stress_tests();
+            } else {
+                std::cout << "Parser not implemented yet.\n";
+            }
+            return 0;
+        }
+        
         std::cout << "Unknown test suite: " << testSuite << std::endl;
-        std::cout << "Available test suites: lexer, parser, symbol_table" << std::endl;
+        std::cout << "Available test suites: lexer, parser, symbol_table, parser_stress" << std::endl;
         return 1;
     }
     
@@ -6,12 +6,58 @@
 #include "lexer.h"
 #include "error.h"
 #include "symbol_table.h"
+#include "compilation_context.h"
+#include "generated_parser.h"
+#include "recursive_descent_parser.h"
+#include "lalr_parser.h"
+#include "incremental_parser.h"
+#include "parallel_parser.h"
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
 
 // This file will contain parser tests
 
 // We don't need to declare errorReporter here since it's already defined in error.cpp
 // and declared as extern in error.h
 
+// Which parser the shared parsing tests run against
+enum class ParserUnderTest {
+    LL1,
+    RecursiveDescent
+};
+static ParserUnderTest parserUnderTest = ParserUnderTest::LL1;
+
+// Stands in for Parser in the shared tests and runs whichever parser is
+// selected, so the recursive-descent parser gets the same coverage
+class TestParser {
+public:
+    TestParser(TokenStream tokens, ErrorReporter& reporter, SymbolTable& symtable) {
+        if (parserUnderTest == ParserUnderTest::RecursiveDescent) {
+            rd = std::make_unique<RecursiveDescentParser>(std::move(tokens), reporter, symtable);
+        } else {
+            ll1 = std::make_unique<Parser>(std::move(tokens), reporter, symtable);
+        }
+    }
+    
+    TestParser(TokenStream tokens, CompilationContext& context)
+        : TestParser(std::move(tokens), context.getReporter(), context.getSymbolTable()) {}
+    
+    bool parse() { return rd ? rd->parse() : ll1->parse(); }
+    
+    // Only the LL(1) parser traces its steps
+    void setVerbose(bool enable) {
+        if (ll1) {
+            ll1->setVerbose(enable);
+        }
+    }
+    
+private:
+    std::unique_ptr<Parser> ll1;
+    std::unique_ptr<RecursiveDescentParser> rd;
+};
+
 // Helper function to create a temporary file with the given source code - make it static
 static std::string createTempFile(const std::string& source) {
     std::string tempFileName = "temp_test_file.c";
@@ -167,7 +213,7 @@ void testParseSimpleProgram() {
     SymbolTable symbolTable;
     
     // Create parser and parse the tokens
-    Parser parser(tokens, errorReporter, symbolTable);
+    TestParser parser(tokens, errorReporter, symbolTable);
     parser.setVerbose(true); // Enable verbose mode for debugging
     
     bool success = parser.parse();
@@ -212,7 +258,7 @@ void testParseWhileLoop() {
     SymbolTable symbolTable;
     
     // Create parser
-    Parser parser(tokens, errorReporter, symbolTable);
+    TestParser parser(tokens, errorReporter, symbolTable);
     
     // Parse the program
     bool success = parser.parse();
@@ -254,7 +300,7 @@ void testParseArithmeticOperators() {
     SymbolTable symbolTable;
     
     // Create parser and parse the tokens
-    Parser parser(tokens, errorReporter, symbolTable);
+    TestParser parser(tokens, errorReporter, symbolTable);
     
     // Parse the program
     bool success = parser.parse();
@@ -287,7 +333,7 @@ void testParseErrors() {
     SymbolTable symbolTable;
     
     // Create parser and parse the tokens
-    Parser parser1(tokens1, errorReporter, symbolTable);
+    TestParser parser1(tokens1, errorReporter, symbolTable);
     
     bool success1 = parser1.parse();
     assert(!success1 || errorReporter.getErrorCount() > 0);
@@ -315,7 +361,7 @@ void testParseErrors() {
     SymbolTable symbolTable2;
     
     // Create parser and parse the tokens
-    Parser parser2(tokens2, errorReporter, symbolTable2);
+    TestParser parser2(tokens2, errorReporter, symbolTable2);
     
     bool success2 = parser2.parse();
     assert(!success2 || errorReporter.getErrorCount() > 0);
@@ -323,6 +369,43 @@ void testParseErrors() {
     std::cout << "Error handling test passed!" << std::endl;
 }
 
+// Test parentheses nested past RecursiveDescentParser::MAX_NESTING: the
+// LL(1) parser keeps them on its own stack and accepts them, the
+// recursive-descent parser reports the depth and stops cleanly
+void testParseDeepNesting() {
+    std::cout << "Testing deeply nested parentheses..." << std::endl;
+    
+    // Written directly: createTempFile() would echo all of it
+    const size_t depth = 100000;
+    std::string filename = "temp_test_file.c";
+    {
+        std::ofstream file(filename);
+        file << "int main() {\n    int x = " << std::string(depth, '(') << "1" << std::string(depth, ')')
+             << ";\n    return x;\n}\n";
+    }
+    
+    std::string output;
+    ErrorReporter reporter;
+    reporter.setOutput(&output);
+    Lexer lexer(filename, reporter);
+    TokenStream tokens = lexer.tokenize();
+    SymbolTable symbolTable;
+    TestParser parser(std::move(tokens), reporter, symbolTable);
+    bool success = parser.parse();
+    reporter.flush();
+    
+    if (parserUnderTest == ParserUnderTest::RecursiveDescent) {
+        assert(!success);
+        assert(reporter.getErrorCount() == 1);
+        assert(output.find("Nesting deeper than 4096 levels") != std::string::npos);
+    } else {
+        assert(success);
+        assert(reporter.getErrorCount() == 0);
+    }
+    
+    std::cout << "Deep nesting test passed!" << std::endl;
+}
+
 // Test the panic mode error recovery
 void testErrorRecovery() {
     std::cout << "Testing panic mode error recovery..." << std::endl;
@@ -348,7 +431,7 @@ void testErrorRecovery() {
     SymbolTable symbolTable;
     
     // Create parser and parse the tokens
-    Parser parser(tokens, errorReporter, symbolTable);
+    TestParser parser(tokens, errorReporter, symbolTable);
     
     bool success = parser.parse();
     
@@ -389,7 +472,7 @@ void testParseRelationalOperators() {
     SymbolTable symbolTable;
     
     // Create parser and parse the tokens
-    Parser parser(tokens, errorReporter, symbolTable);
+    TestParser parser(tokens, errorReporter, symbolTable);
     
     bool success = parser.parse();
     assert(success);
@@ -426,7 +509,7 @@ void testParseNestedExpressions() {
     SymbolTable symbolTable;
     
     // Create parser and parse the tokens
-    Parser parser(tokens, errorReporter, symbolTable);
+    TestParser parser(tokens, errorReporter, symbolTable);
     
     bool success = parser.parse();
     assert(success);
@@ -550,7 +633,7 @@ void testBasicMainFunction() {
     SymbolTable symbolTable;
     
     // Create a parser with the token stream
-    Parser parser(tokens, reporter, symbolTable);
+    TestParser parser(tokens, reporter, symbolTable);
     parser.setVerbose(true); // Enable verbose mode for debugging
     
     // Test parsing
@@ -589,7 +672,7 @@ int main() {
     SymbolTable symbolTable;
     
     // Create a parser with the token stream
-    Parser parser(tokens, reporter, symbolTable);
+    TestParser parser(tokens, reporter, symbolTable);
     parser.setVerbose(true); // Enable verbose mode for debugging
     
     // Parse the program
@@ -630,7 +713,7 @@ int main() {
     SymbolTable symbolTable;
     
     // Create a parser with the token stream
-    Parser parser(tokens, reporter, symbolTable);
+    TestParser parser(tokens, reporter, symbolTable);
     parser.setVerbose(true); // Enable verbose mode for debugging
     
     // Parse the program
@@ -681,7 +764,7 @@ int main() {
     SymbolTable symbolTable;
     
     // Create parser
-    Parser parser(tokens, reporter, symbolTable);
+    TestParser parser(tokens, reporter, symbolTable);
     
     // Parse the program
     bool success = parser.parse();
@@ -707,7 +790,7 @@ void testSyntaxErrorDetection() {
         TokenStream tokens = lexer.tokenize();
         
         SymbolTable symbolTable;
-        Parser parser(tokens, reporter, symbolTable);
+        TestParser parser(tokens, reporter, symbolTable);
         bool result = parser.parse();
         
         assert(result == false);
@@ -726,7 +809,7 @@ void testSyntaxErrorDetection() {
         TokenStream tokens = lexer.tokenize();
         
         SymbolTable symbolTable;
-        Parser parser(tokens, reporter, symbolTable);
+        TestParser parser(tokens, reporter, symbolTable);
         bool result = parser.parse();
         
         assert(result == false);
@@ -745,7 +828,7 @@ void testSyntaxErrorDetection() {
         TokenStream tokens = lexer.tokenize();
         
         SymbolTable symbolTable;
-        Parser parser(tokens, reporter, symbolTable);
+        TestParser parser(tokens, reporter, symbolTable);
         bool result = parser.parse();
         
         assert(result == false);
@@ -757,6 +840,1375 @@ void testSyntaxErrorDetection() {
     std::cout << "Syntax error detection tests passed!" << std::endl;
 }
 
+// Test that compilations in separate contexts share no state
+void testIndependentCompilationContexts() {
+    std::cout << "Testing independent compilation contexts..." << std::endl;
+    
+    const std::string validFile = "temp_context_valid.c";
+    const std::string invalidFile = "temp_context_invalid.c";
+    {
+        std::ofstream valid(validFile);
+        valid << "int main() {\n    int x = 5;\n    x = x + 1;\n    return 0;\n}\n";
+        std::ofstream invalid(invalidFile);
+        invalid << "int main() {\n    int x = 5\n    return y;\n}\n";
+    }
+    
+    int globalErrorsBefore = errorReporter.getErrorCount();
+    
+    CompilationAggregator aggregator;
+    auto compile = [&aggregator](const std::string& filename, uint32_t index) {
+        CompilationContext context(filename, index);
+        context.captureDiagnostics();
+        context.getReporter().init(filename);
+        
+        Lexer lexer(filename, context);
+        TokenStream tokens = lexer.tokenize();
+        TestParser parser(tokens, context);
+        bool success = parser.parse();
+        context.getReporter().finish();
+        
+        aggregator.add({index, filename, context.getReporter().getErrorCount(),
+                        success, context.getDiagnosticOutput()});
+    };
+    
+    // Run both compilations at the same time
+    std::thread first(compile, validFile, 0);
+    std::thread second(compile, invalidFile, 1);
+    first.join();
+    second.join();
+    
+    std::vector<CompilationSummary> results = aggregator.getResults();
+    assert(results.size() == 2);
+    assert(results[0].filename == validFile);
+    assert(results[0].success);
+    assert(results[0].error_count == 0);
+    assert(results[0].diagnostics.empty());
+    assert(results[1].filename == invalidFile);
+    assert(!results[1].success);
+    assert(results[1].error_count > 0);
+    assert(results[1].diagnostics.find(invalidFile) != std::string::npos);
+    assert(aggregator.getTotalErrors() == results[1].error_count);
+    
+    // Nothing leaked into the process-wide reporter
+    assert(errorReporter.getErrorCount() == globalErrorsBefore);
+    
+    std::cout << "Independent compilation contexts test passed!" << std::endl;
+}
+
+// A grammar with a genuine conflict: both TYPE productions start with 'int'
+constexpr GrammarRule CONFLICTING_RULES[] = {
+    rule(NonTerminal::PROGRAM, {symbol::nt(NonTerminal::TYPE)}),
+    rule(NonTerminal::TYPE, {terminal::keyword(KeywordType::Int)}),
+    rule(NonTerminal::TYPE, {terminal::keyword(KeywordType::Int), terminal::keyword(KeywordType::Float)}),
+};
+constexpr GrammarTables CONFLICTING_TABLES = computeGrammarTables(CONFLICTING_RULES);
+static_assert(CONFLICTING_TABLES.conflict_count == 1, "conflict must be detected at compile time");
+static_assert(CONFLICTING_TABLES.conflict_nonterminal == NonTerminal::TYPE, "conflict is on TYPE");
+static_assert(CONFLICTING_TABLES.conflict_terminal == terminal::keyword(KeywordType::Int), "conflict is on 'int'");
+
+// Left recursion hidden behind a nullable TYPE loops on 'float'; the
+// built-in grammar's STATEMENT_LIST is only safe thanks to its table
+constexpr GrammarRule LEFT_RECURSIVE_RULES[] = {
+    rule(NonTerminal::PROGRAM, {symbol::nt(NonTerminal::TYPE), symbol::nt(NonTerminal::PROGRAM),
+                                terminal::keyword(KeywordType::Int)}),
+    rule(NonTerminal::PROGRAM, {terminal::keyword(KeywordType::Float)}),
+    rule(NonTerminal::TYPE, {}),
+};
+static_assert(findExpansionCycle(LEFT_RECURSIVE_RULES, computeGrammarTables(LEFT_RECURSIVE_RULES)) ==
+                  static_cast<size_t>(NonTerminal::PROGRAM),
+              "hidden left recursion must be detected at compile time");
+
+// Test that the compile-time tables agree with a run-time fixed point
+void testCompileTimeGrammarTables() {
+    std::cout << "Testing compile-time grammar tables..." << std::endl;
+    
+    const FirstFollowSets& builtin = FirstFollowSets::builtin();
+    FirstFollowSets computed = builtin;
+    computed.computeFirstSets();
+    computed.computeFollowSets();
+    assert(computed.first_sets == builtin.first_sets);
+    assert(computed.follow_sets == builtin.follow_sets);
+    
+    // Every cell holds a production for its own non-terminal
+    for (size_t nt = 0; nt < NONTERMINAL_COUNT; nt++) {
+        for (TerminalId t = 0; t < terminal::COUNT; t++) {
+            int production = GRAMMAR_TABLES.predict[nt][t];
+            if (production >= 0) {
+                assert(static_cast<size_t>(builtin.grammar[production].lhs) == nt);
+            }
+        }
+    }
+    static_assert(GRAMMAR_TABLES.predict[static_cast<size_t>(NonTerminal::TYPE)]
+                                        [terminal::keyword(KeywordType::Float)] == 21,
+                  "TYPE → float is production 21");
+    
+    // The parser's resolved right-hand sides are the constexpr rules again
+    const LL1Grammar& grammar = LL1Grammar::builtin();
+    for (size_t p = 0; p < minic_grammar::RULE_COUNT; p++) {
+        const GrammarRule& rule = minic_grammar::RULES[p];
+        assert(grammar.rhsLength(static_cast<int>(p)) == rule.length);
+        for (size_t i = 0; i < rule.length; i++) {
+            assert(grammar.rhs(static_cast<int>(p))[i] == rule.rhs[i]);
+        }
+        
+        // and are pushed as one reversed span
+        const PushTable& pushes = grammar.getPushTable();
+        int production = static_cast<int>(p);
+        assert(static_cast<size_t>(pushes.end(production) - pushes.begin(production)) == rule.length);
+        for (size_t i = 0; i < rule.length; i++) {
+            assert(pushes.begin(production)[i] == rule.rhs[rule.length - 1 - i]);
+        }
+        assert(pushes.event_offsets[p] == pushes.event_offsets[p + 1]);
+    }
+    
+    std::cout << "Compile-time grammar tables test passed!" << std::endl;
+}
+
+// Test FIRST/FOLLOW on a grammar larger than the built-in one
+void testLargeGrammarSets() {
+    std::cout << "Testing FIRST/FOLLOW on a large grammar..." << std::endl;
+    
+    // N0 -> N1 | t0, N1 -> N2 | t1, ..., and the last one -> tlast | epsilon.
+    // Non-terminals past the built-in ones are plain indices.
+    const int count = 300;
+    FirstFollowSets sets;
+    sets.grammar.clear();
+    for (int i = 0; i < count - 1; i++) {
+        NonTerminal lhs = static_cast<NonTerminal>(i);
+        sets.addProduction(Production(lhs, {static_cast<NonTerminal>(i + 1)}));
+        sets.addProduction(Production(lhs, {"t" + std::to_string(i)}));
+    }
+    sets.addProduction(Production(static_cast<NonTerminal>(count - 1), {std::string("tlast")}));
+    sets.addProduction(Production(static_cast<NonTerminal>(count - 1), {EPSILON}));
+    sets.computeFirstSets();
+    sets.computeFollowSets();
+    
+    // Everything reachable down the chain is in FIRST of the start symbol
+    const auto& firstStart = sets.first_sets.at(NonTerminal::PROGRAM);
+    assert(firstStart.size() == static_cast<size_t>(count + 1));  // t0..t298, tlast, epsilon
+    assert(firstStart.count("t0") && firstStart.count("t298") && firstStart.count("tlast"));
+    assert(firstStart.count(EPSILON));
+    
+    // Only the last non-terminal starts with its own terminals
+    const auto& firstMiddle = sets.first_sets.at(static_cast<NonTerminal>(150));
+    assert(!firstMiddle.count("t149") && firstMiddle.count("t150"));
+    
+    // End of input follows every non-terminal in the chain
+    for (int i = 0; i < count; i++) {
+        const auto& follow = sets.follow_sets.at(static_cast<NonTerminal>(i));
+        assert(follow.size() == 1 && follow.count("$"));
+    }
+    
+    std::cout << "Large grammar FIRST/FOLLOW test passed!" << std::endl;
+}
+
+// Test that diagnostics keep long arguments intact and expose their ids
+void testDiagnosticFormatting() {
+    std::cout << "Testing diagnostic formatting..." << std::endl;
+    
+    // Longer than the old fixed-size formatting buffer
+    std::string longName(3000, 'v');
+    SourceLocation loc("temp_diagnostics.c", 3, 7);
+    
+    std::string text;
+    {
+        ErrorReporter reporter;
+        reporter.setOutput(&text);
+        reporter.report(diag::UndeclaredVariable{}, loc, longName);
+        reporter.report(diag::ExpectedToken{}, SourceLocation("temp_diagnostics.c", 1, 2), ';', "}");
+        assert(reporter.getErrorCount() == 2);
+        
+        // Nothing is rendered before the batch is flushed
+        assert(text.empty());
+        reporter.flush();
+    }
+    assert(text.find("temp_diagnostics.c:3:7: error: Use of undeclared variable '" + longName + "'") !=
+           std::string::npos);
+    assert(text.find("temp_diagnostics.c:1:2: error: Expected ';', got '}'") < text.find(longName));
+    
+    std::string json;
+    {
+        ErrorReporter reporter;
+        reporter.setOutput(&json);
+        reporter.setFormat(DiagnosticFormat::JsonLines);
+        reporter.report(diag::UnexpectedCharacter{}, loc, '@');
+        reporter.finish();
+    }
+    assert(json.find("\"id\":\"E0005\"") != std::string::npos);
+    assert(json.find("\"message\":\"Unexpected character '@'\",\"args\":[\"@\"]") != std::string::npos);
+    
+    std::cout << "Diagnostic formatting test passed!" << std::endl;
+}
+
+// Test the source line and caret under a diagnostic, from a lent buffer:
+// on the first line, on a CRLF line, whose '\r' is not echoed and whose
+// tab is kept before the caret, and on a last line with no newline
+void testDiagnosticSourceLines() {
+    std::cout << "Testing diagnostic source lines..." << std::endl;
+    
+    const std::string filename = "temp_source_lines.c";
+    std::string text;
+    {
+        ErrorReporter reporter;
+        reporter.init(filename);
+        reporter.setSourceBuffer(std::make_shared<const std::string>("int x;\n\tx = 1;\r\nreturn x"));
+        reporter.setOutput(&text);
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation(filename, 1, 5), "x");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation(filename, 2, 4), "x");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation(filename, 3, 8), "x");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation(filename, 4, 1), "x");
+        reporter.flush();
+    }
+    
+    const std::string message = ": error: Use of undeclared variable 'x'\n";
+    assert(text == filename + ":1:5" + message + "int x;\n" + "    ^\n" +
+                   filename + ":2:4" + message + "\tx = 1;\n" + "\t  ^\n" +
+                   filename + ":3:8" + message + "return x\n" + "       ^\n" +
+                   filename + ":4:1" + message);
+
+    // Adopted diagnostics render the same, whichever file the adopting
+    // reporter is on: other's buffer comes along with them
+    std::string adopted;
+    {
+        ErrorReporter unit;
+        unit.init(filename);
+        unit.setSourceBuffer(std::make_shared<const std::string>("int x;\n\tx = 1;\r\nreturn x"));
+        unit.setAutoFlush(false);
+        unit.report(diag::UndeclaredVariable{}, SourceLocation(filename, 3, 8), "x");
+        unit.report(diag::UndeclaredVariable{}, SourceLocation(filename, 2, 4), "x");
+
+        ErrorReporter merged;
+        merged.init("temp_other_file.c");
+        merged.setOutput(&adopted);
+        merged.adopt(unit);
+        merged.flush();
+    }
+    assert(adopted == filename + ":2:4" + message + "\tx = 1;\n" + "\t  ^\n" +
+                      filename + ":3:8" + message + "return x\n" + "       ^\n");
+
+    std::cout << "Diagnostic source line test passed!" << std::endl;
+}
+
+// Test that a flushed batch comes out sorted by file, line and column,
+// with diagnostics at the same location kept in the order reported
+void testDiagnosticOrdering() {
+    std::cout << "Testing diagnostic ordering..." << std::endl;
+    
+    std::string text;
+    {
+        ErrorReporter reporter;
+        reporter.setOutput(&text);
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation("b.c", 1, 1), "b1");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation("a.c", 5, 2), "late");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation("a.c", 2, 9), "first");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation("a.c", 5, 1), "early");
+        reporter.report(diag::Redeclaration{}, SourceLocation("a.c", 2, 9), "second");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation("a.c", 2, 9), "third");
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation("a.c", 10, 1), "last");
+        reporter.flush();
+    }
+    
+    std::vector<std::string> order;
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);) {
+        size_t quote = line.find('\'');
+        if (line.find(": error: ") != std::string::npos && quote != std::string::npos) {
+            order.push_back(line.substr(quote + 1, line.find('\'', quote + 1) - quote - 1));
+        }
+    }
+    const std::vector<std::string> expected = {"first", "second", "third", "early", "late", "last", "b1"};
+    assert(order == expected);
+    
+    std::cout << "Diagnostic ordering test passed!" << std::endl;
+}
+
+// Whether text is one complete JSON value: every object and array closed,
+// outside string literals
+static bool isClosedJson(const std::string& text) {
+    int depth = 0;
+    bool in_string = false;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (in_string) {
+            if (c == '\\') {
+                i++;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if ((c == '}' || c == ']') && --depth < 0) {
+            return false;
+        }
+    }
+    return depth == 0 && !in_string;
+}
+
+// Test the JSON-lines and SARIF serializers: escaping, record shapes, URIs
+// and closing the SARIF log
+void testDiagnosticSerializers() {
+    std::cout << "Testing diagnostic serializers..." << std::endl;
+    
+    // Quotes, backslashes, newlines and other control bytes are escaped
+    const std::string name = std::string("a\"b\\c\nd\te") + '\x01' + "f";
+    const std::string escaped = "a\\\"b\\\\c\\nd\\te\\u0001f";
+    
+    std::string json;
+    {
+        ErrorReporter reporter;
+        reporter.setOutput(&json);
+        reporter.setFormat(DiagnosticFormat::JsonLines);
+        reporter.report(diag::UndeclaredVariable{}, SourceLocation("dir/a \"b\".c", 3, 7), name);
+        reporter.report(diag::TooManyErrors{}, SourceLocation("dir/a \"b\".c", 4, 1), size_t(50));
+        reporter.finish();
+    }
+    
+    // One file record, then one record per diagnostic, one per line
+    std::vector<std::string> lines;
+    std::istringstream records(json);
+    for (std::string line; std::getline(records, line);) {
+        assert(isClosedJson(line));
+        lines.push_back(line);
+    }
+    assert(lines.size() == 3 && json.back() == '\n');
+    assert(lines[0] == "{\"kind\":\"file\",\"id\":0,\"path\":\"dir/a \\\"b\\\".c\"}");
+    assert(lines[1] == "{\"kind\":\"diagnostic\",\"severity\":\"error\",\"id\":\"E0201\",\"file\":0,"
+                       "\"range\":{\"line\":3,\"column\":7},"
+                       "\"message\":\"Use of undeclared variable '" + escaped + "'\","
+                       "\"args\":[\"" + escaped + "\"]}");
+    assert(lines[2].find("\"id\":\"E0107\"") != std::string::npos);
+    assert(lines[2].find("\"args\":[50]}") != std::string::npos);
+    
+    // A whole SARIF log is closed by finish(), once, with the artifact as a
+    // URI reference: '#' and ' ' percent-encoded, absolute paths as file://
+    const std::string sarifFile = "temp_diagnostics.sarif";
+    for (const std::string& path : {std::string("dir/a#b c.c"), std::string("/src/a#b c.c")}) {
+        FILE* out = std::fopen(sarifFile.c_str(), "w");
+        assert(out);
+        {
+            DiagnosticSerializer serializer(DiagnosticFormat::Sarif, out);
+            serializer.addFile(0, path);
+            DiagnosticArg arg;
+            arg.kind = DiagnosticArg::Kind::String;
+            arg.string_offset = 0;
+            arg.string_length = static_cast<uint32_t>(name.size());
+            serializer.write(DiagnosticId::UndeclaredVariable, 0, 3, 7, "Use of undeclared variable", &arg, 1, name);
+            serializer.finish();
+            serializer.finish();
+        }
+        std::fclose(out);
+        
+        std::ifstream in(sarifFile);
+        std::string sarif((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        assert(sarif.compare(0, strlen(DiagnosticSerializer::SARIF_LOG_HEADER), DiagnosticSerializer::SARIF_LOG_HEADER) == 0);
+        assert(sarif.size() > 3 && sarif.compare(sarif.size() - 3, 3, "]}\n") == 0);
+        assert(isClosedJson(sarif));
+        assert(sarif.find("\"arguments\":[\"" + escaped + "\"]") != std::string::npos);
+        const char* uri = path[0] == '/' ? "\"uri\":\"file:///src/a%23b%20c.c\"" : "\"uri\":\"dir/a%23b%20c.c\"";
+        assert(sarif.find(uri) != std::string::npos);
+    }
+    std::remove(sarifFile.c_str());
+    
+    // A run without results still closes; with a sink it is the run object alone
+    std::string run;
+    {
+        ErrorReporter reporter;
+        reporter.setOutput(&run);
+        reporter.setFormat(DiagnosticFormat::Sarif);
+        reporter.finish();
+    }
+    assert(run == "{\"tool\":{\"driver\":{\"name\":\"minicompiler\"}},\"results\":[],\"artifacts\":[]}");
+    
+    std::cout << "Diagnostic serializer test passed!" << std::endl;
+}
+
+// Test a SARIF log merged from several compilations: each run lists only
+// its own file, at artifact index 0, while JSON lines keep the file ids
+// distinct across the compilations
+void testMultiFileSarif() {
+    std::cout << "Testing multi-file SARIF..." << std::endl;
+    
+    auto mergedOutput = [](DiagnosticFormat format) {
+        CompilationAggregator aggregator(format);
+        for (uint32_t index = 0; index < 3; index++) {
+            std::string filename = "unit" + std::to_string(index) + ".c";
+            CompilationContext context(filename, index);
+            context.captureDiagnostics();
+            context.getReporter().setFormat(format);
+            context.getReporter().report(diag::UndeclaredVariable{}, SourceLocation(filename, 2, 5), "x");
+            context.getReporter().finish();
+            aggregator.add({index, filename, context.getReporter().getErrorCount(), false,
+                            context.getDiagnosticOutput()});
+        }
+        const std::string mergedFile = "temp_merged_diagnostics";
+        FILE* out = std::fopen(mergedFile.c_str(), "w");
+        assert(out);
+        aggregator.writeDiagnostics(out);
+        std::fclose(out);
+        std::ifstream in(mergedFile);
+        std::string merged((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::remove(mergedFile.c_str());
+        return merged;
+    };
+    
+    std::string sarif = mergedOutput(DiagnosticFormat::Sarif);
+    assert(isClosedJson(sarif));
+    std::vector<std::string> artifacts;
+    const std::string key = "\"artifacts\":[";
+    for (size_t at = sarif.find(key); at != std::string::npos; at = sarif.find(key, at + 1)) {
+        size_t begin = at + key.size();
+        artifacts.push_back(sarif.substr(begin, sarif.find(']', begin) - begin));
+    }
+    assert(artifacts.size() == 3);
+    for (uint32_t index = 0; index < 3; index++) {
+        assert(artifacts[index] == "{\"location\":{\"uri\":\"unit" + std::to_string(index) + ".c\"}}");
+    }
+    assert(sarif.find("\"artifactLocation\":{\"index\":0}") != std::string::npos);
+    assert(sarif.find("\"artifactLocation\":{\"index\":1}") == std::string::npos);
+    assert(sarif.find("\"artifactLocation\":{\"index\":2}") == std::string::npos);
+    
+    std::string json = mergedOutput(DiagnosticFormat::JsonLines);
+    for (uint32_t index = 0; index < 3; index++) {
+        std::string id = std::to_string(index);
+        assert(json.find("{\"kind\":\"file\",\"id\":" + id + ",\"path\":\"unit" + id + ".c\"}") != std::string::npos);
+        assert(json.find("\"file\":" + id + ",") != std::string::npos);
+    }
+    
+    std::cout << "Multi-file SARIF test passed!" << std::endl;
+}
+
+// Test loading the grammar from grammar.txt, with and without the table cache
+void testGrammarFileLoading() {
+    std::cout << "Testing grammar file loading..." << std::endl;
+    
+    const std::string path = "test_files/grammar.txt";
+    std::remove((path + ".cache").c_str());
+    
+    for (int pass = 0; pass < 2; pass++) {
+        ErrorReporter reporter;
+        std::unique_ptr<LL1Grammar> grammar = LL1Grammar::load(path, reporter);
+        assert(grammar && reporter.getErrorCount() == 0);
+        
+        // The first load compiles and writes the cache, the second reads it
+        assert(grammar->loadedFromCache() == (pass == 1));
+        
+        // grammar.txt describes the built-in grammar exactly
+        assert(grammar->getNonTerminalCount() == NONTERMINAL_COUNT);
+        assert(grammar->getSets().grammar.size() == minic_grammar::RULE_COUNT);
+        for (size_t nt = 0; nt < NONTERMINAL_COUNT; nt++) {
+            for (TerminalId t = 0; t < terminal::COUNT; t++) {
+                assert(grammar->predict(static_cast<NonTerminal>(nt), t) == GRAMMAR_TABLES.predict[nt][t]);
+            }
+        }
+        assert(grammar->getSets().first_sets == FirstFollowSets::builtin().first_sets);
+        assert(grammar->getSets().follow_sets == FirstFollowSets::builtin().follow_sets);
+        
+        std::string source = "int main() { int x = 1; while (x < 3) { x = x + 1; } return x; }";
+        std::string filename = createTempFile(source);
+        CompilationContext context(filename);
+        Lexer lexer(filename, context);
+        Parser parser(lexer.tokenize(), context, *grammar);
+        assert(parser.parse());
+    }
+    
+    // A cache whose last predict cell names no production (-5) is stale or
+    // corrupt: it is rejected and the grammar compiled again
+    {
+        std::fstream cache(path + ".cache", std::ios::binary | std::ios::in | std::ios::out);
+        cache.seekp(-static_cast<std::streamoff>(sizeof(int16_t)), std::ios::end);
+        int16_t tampered = -5;
+        cache.write(reinterpret_cast<const char*>(&tampered), sizeof(tampered));
+    }
+    {
+        ErrorReporter reporter;
+        std::unique_ptr<LL1Grammar> grammar = LL1Grammar::load(path, reporter);
+        assert(grammar && reporter.getErrorCount() == 0);
+        assert(!grammar->loadedFromCache());
+        assert(grammar->predict(static_cast<NonTerminal>(NONTERMINAL_COUNT - 1), terminal::COUNT - 1) ==
+               GRAMMAR_TABLES.predict[NONTERMINAL_COUNT - 1][terminal::COUNT - 1]);
+    }
+    
+    // A grammar with names of its own, which the built-in one cannot express
+    std::string customPath = "temp_grammar.txt";
+    {
+        std::ofstream custom(customPath);
+        custom << "// Arithmetic only\n"
+               << "PROGRAM -> SUM\n"
+               << "SUM -> INTEGER_LITERAL SUM_TAIL\n"
+               << "SUM_TAIL -> + INTEGER_LITERAL SUM_TAIL\n"
+               << "         | ε\n";
+    }
+    {
+        ErrorReporter reporter;
+        std::unique_ptr<LL1Grammar> grammar = LL1Grammar::load(customPath, reporter, false);
+        assert(grammar && grammar->getNonTerminalCount() == NONTERMINAL_COUNT + 2);
+        NonTerminal sumTail = static_cast<NonTerminal>(NONTERMINAL_COUNT + 1);
+        assert(grammar->getSets().nameOf(sumTail) == "SUM_TAIL");
+        assert(grammar->predict(sumTail, terminal::op(OperatorType::PLUS)) == 2);
+        assert(grammar->predict(sumTail, terminal::END_OF_FILE) == 3);
+    }
+    
+    // Unknown symbols, malformed rules and conflicts are reported
+    auto loadErrors = [&](const std::string& text) {
+        {
+            std::ofstream custom(customPath);
+            custom << text;
+        }
+        std::string output;
+        ErrorReporter reporter;
+        reporter.setOutput(&output);
+        std::unique_ptr<LL1Grammar> grammar = LL1Grammar::load(customPath, reporter, false);
+        assert(!grammar);
+        reporter.flush();
+        return output;
+    };
+    assert(loadErrors("PROGRAM -> int @\n").find("Unknown grammar symbol '@'") != std::string::npos);
+    assert(loadErrors("PROGRAM int\n").find("Malformed grammar rule") != std::string::npos);
+    assert(loadErrors("SUM -> int\n").find("start symbol PROGRAM") != std::string::npos);
+    assert(loadErrors("PROGRAM -> A | B\nA -> int\nB -> int\n").find(
+               "Multiple productions for PROGRAM with terminal int") != std::string::npos);
+    assert(loadErrors("PROGRAM -> PROGRAM int | float\n").find(
+               "Grammar rule PROGRAM is left-recursive on lookahead float") != std::string::npos);
+    assert(loadErrors("PROGRAM -> A PROGRAM int | float\nA -> ε\n").find(
+               "Grammar rule PROGRAM is left-recursive on lookahead float") != std::string::npos);
+    std::remove(customPath.c_str());
+    
+    std::cout << "Grammar file loading test passed!" << std::endl;
+}
+
+// Test the tree built by the table-driven parser
+void testAstConstruction() {
+    std::cout << "Testing AST construction..." << std::endl;
+    
+    std::string source = "int main() { int a = 2; float f; a = (a + 3) * a - a / 4; 5; "
+                         "while (a >= 1) { a--; } return a; }";
+    std::string filename = createTempFile(source);
+    CompilationContext context(filename);
+    Lexer lexer(filename, context);
+    TokenStream tokens = lexer.tokenize();
+    Parser parser(tokens, context);
+    assert(parser.parse());
+    
+    // The tree lands in the context's arena
+    const Ast& ast = context.getAst();
+    assert(&parser.getAst() == &ast);
+    assert(ast.dump() ==
+           "(function main\n"
+           "  (declare int a 2)\n"
+           "  (declare float f)\n"
+           "  (assign a (- (* (+ a 3) a) (/ a 4)))\n"
+           "  (expr 5)\n"
+           "  (while (>= a 1)\n"
+           "    (expr (-- a)))\n"
+           "  (return a))\n");
+    
+    // One pool per kind; references carry the kind and a pool index
+    NodeRef root = ast.getRoot();
+    assert(root.kind() == NodeKind::Program && ast.get<ProgramNode>(root).functions.count == 1);
+    NodeRef main = ast.listAt(ast.get<ProgramNode>(root).functions, 0);
+    assert(main.kind() == NodeKind::Function && main.index() == 0);
+    const FunctionNode& function = ast.get<FunctionNode>(main);
+    assert(function.body.count == 6);
+    assert(ast.nodes<LoopNode>().size() == 1);
+    assert(ast.nodes<DeclarationNode>().size() == 2);
+    assert(ast.nodes<BinaryNode>().size() == 5);
+    NodeRef loop = ast.listAt(function.body, 4);
+    assert(loop.kind() == NodeKind::Loop);
+    assert(tokens[ast.get<LoopNode>(loop).token].lexeme == "while");
+    
+    // Identifiers share one interned name
+    const AssignmentNode& assignment = ast.get<AssignmentNode>(ast.listAt(function.body, 2));
+    assert(ast.name(assignment.name) == "a");
+    assert(assignment.name == ast.get<DeclarationNode>(ast.listAt(function.body, 0)).name);
+    
+    assert(ast.getNodeCount() == 26);
+    assert(ast.getBytesUsed() > 0);
+    
+    // Nodes are compact
+    static_assert(sizeof(NodeRef) == 4, "NodeRef is a 32-bit index");
+    static_assert(sizeof(BinaryNode) <= 16 && sizeof(IdentifierNode) == 8, "nodes stay small");
+    
+    // A failed parse leaves no tree, and clear() drops everything at once
+    Parser failing(Lexer(createTempFile("int main() { int x = ; }")).tokenize(), context);
+    assert(!failing.parse());
+    assert(!context.getAst().getRoot().isValid());
+    context.getAst().clear();
+    assert(context.getAst().getNodeCount() == 0);
+    assert(context.getArena().getBytesAllocated() == 0);
+    
+    std::cout << "AST construction test passed!" << std::endl;
+}
+
+// Handler that only wants declarations, loops and operators; everything
+// else falls through to ParseEvents' empty callbacks
+struct OutlineHandler : ParseEvents {
+    std::string outline;
+    int loopDepth = 0;
+    int maxLoopDepth = 0;
+    
+    void onDeclaration(SymbolType /*type*/, const Token& name, uint32_t /*index*/, bool has_initializer) {
+        outline += "decl:" + name.lexeme + (has_initializer ? "=" : "") + " ";
+    }
+    void onLoopBegin(const Token& /*keyword*/, uint32_t /*index*/) {
+        outline += "loop{ ";
+        maxLoopDepth = std::max(maxLoopDepth, ++loopDepth);
+    }
+    void onLoopEnd(const Token& /*keyword*/, uint32_t /*index*/) {
+        outline += "} ";
+        loopDepth--;
+    }
+    void onExpressionOperator(const Token& op, uint32_t /*index*/) {
+        outline += op.lexeme + " ";
+    }
+    void onIdentifier(const Token& name, uint32_t /*index*/) {
+        outline += name.lexeme + " ";
+    }
+    void onIntegerLiteral(const Token& literal, uint32_t /*index*/) {
+        outline += literal.lexeme + " ";
+    }
+};
+
+// Test the event interface: post-order callbacks, no tree
+void testParseEvents() {
+    std::cout << "Testing parse events..." << std::endl;
+    
+    std::string source = "int main() { int a = 1 + 2 * 3; int b; "
+                         "while (a < 10) { while (b > a - 1) { b = b - 1; } a++; } return a; }";
+    std::string filename = createTempFile(source);
+    Lexer lexer(filename);
+    TokenStream tokens = lexer.tokenize();
+    
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    Parser parser(tokens, reporter, symbolTable);
+    OutlineHandler handler;
+    assert(parser.parse(handler));
+    
+    // Expressions arrive in postfix order, each before the statement using it
+    assert(handler.outline ==
+           "1 2 3 * + decl:a= decl:b loop{ a 10 < loop{ b a 1 - > b 1 - } a } a ");
+    assert(handler.maxLoopDepth == 2 && handler.loopDepth == 0);
+    
+    // Parsing with a handler leaves the tree alone
+    assert(!parser.getAst().getRoot().isValid());
+    
+    // A handler that ignores everything just validates
+    ParseEvents ignore;
+    Parser validating(tokens, reporter, symbolTable);
+    assert(validating.parse(ignore));
+    
+    std::cout << "Parse events test passed!" << std::endl;
+}
+
+// Test that the generated and recursive-descent parsers agree with the
+// table-driven one, down to the diagnostics and the scopes left open. They
+// stop at the first syntax error where the table-driven parser recovers, so
+// on broken input only its first diagnostics have to match.
+template <typename ParserType>
+static bool runForComparison(const TokenStream& tokens, std::string& output, int& scope) {
+    ErrorReporter reporter;
+    reporter.setOutput(&output);
+    SymbolTable symbolTable;
+    ParserType parser(tokens, reporter, symbolTable);
+    bool result = parser.parse();
+    scope = symbolTable.getCurrentScope();
+    if (result) {
+        symbolTable.getFunctions().check(reporter);
+    }
+    reporter.flush();
+    return result;
+}
+
+void testParsersAgree() {
+    std::cout << "Testing that all parsers agree..." << std::endl;
+    
+    const std::vector<std::string> sources = {
+        "int main() { int x = 1; float y; y = 2.5; while (x < 10) { x = x + 1; x++; } return x; }",
+        "int main() { int a = 2; a = (a + 3) * a - a / 4; 5; (a); return a; }",
+        "int main() { x = 1; int y; y = x; return y; }",
+        "int main() { int x; int x; return y; }",
+        "int main() { int a = 1; int b = a + c; return b; }",
+        "int main() { ; }",
+        "int main() { ",
+        "int main() { int 123; }",
+        "int main() { int x = 10 }",
+        "int main() { int x = 1 +; }",
+        "int main() { int x = 1; x = x * ; }",
+        "int main() { int x = 1; while (x) { } }",
+        "int main() { int x = 1; while (x < ) { } }",
+        "int main() { int x = 1; x = x++ 2; }",
+        "int main() { return 0; } extra",
+        "int main( { }",
+        "main() { }",
+        "int main() { if (x) { } }",
+        "int add(int a, int b) { return a + b; } int main() { int x = add(1, 2 * 3); return add(x, 1); }",
+        "int f(int a, float a) { return a; } int main() { return f(1) + g(); } int f() { }",
+        "int f(int a,) { } int main() { }",
+        "int f() { return f(1, ; } int main() { }",
+        // Several errors each, recovered from in the same places
+        "int main() { int x = ; x = 1 2; return x }",
+        "int main() { while (x < ) { int 5; } y = ; return 0; }",
+        "int main() { int x = 1; while (x > 0 { x = x - 1; } return x; }",
+        "int main() { int x 5; x = (1 + ; return x; } int g( { }",
+        "int f(int a,) { a = a * ; return a; } int main() { return f(1 2); }",
+    };
+    
+    for (const std::string& source : sources) {
+        std::string filename = createTempFile(source);
+        Lexer lexer(filename);
+        TokenStream tokens = lexer.tokenize();
+        
+        std::string tableOutput, generatedOutput, rdOutput;
+        int tableScope, generatedScope, rdScope;
+        bool tableResult = runForComparison<Parser>(tokens, tableOutput, tableScope);
+        bool generatedResult = runForComparison<GeneratedParser>(tokens, generatedOutput, generatedScope);
+        bool rdResult = runForComparison<RecursiveDescentParser>(tokens, rdOutput, rdScope);
+        
+        assert(generatedResult == tableResult && rdResult == tableResult);
+        assert(generatedOutput == tableOutput && rdOutput == tableOutput);
+        assert(generatedScope == tableScope && rdScope == tableScope);
+    }
+
+    // Nothing to parse is a diagnostic like any other
+    TokenStream empty;
+    std::string tableOutput, generatedOutput, rdOutput;
+    int tableScope, generatedScope, rdScope;
+    assert(!runForComparison<Parser>(empty, tableOutput, tableScope));
+    assert(!runForComparison<GeneratedParser>(empty, generatedOutput, generatedScope));
+    assert(!runForComparison<RecursiveDescentParser>(empty, rdOutput, rdScope));
+    assert(tableOutput.find("Token stream is empty") != std::string::npos);
+    assert(generatedOutput == tableOutput && rdOutput == tableOutput);
+
+    std::cout << "Parser agreement test passed!" << std::endl;
+}
+
+// Test that one parse reports every independent syntax error
+void testPanicModeRecovery() {
+    std::cout << "Testing panic-mode recovery..." << std::endl;
+    
+    auto parseSource = [](const std::string& source, std::string& output, int& scope, size_t max_errors) {
+        std::string filename = createTempFile(source);
+        ErrorReporter reporter;
+        reporter.init(filename);
+        reporter.setOutput(&output);
+        Lexer lexer(filename);
+        SymbolTable symbolTable;
+        Parser parser(lexer.tokenize(), reporter, symbolTable);
+        parser.setMaxErrors(max_errors);
+        bool result = parser.parse();
+        scope = symbolTable.getCurrentScope();
+        reporter.flush();
+        return result;
+    };
+    auto countOf = [](const std::string& text, const std::string& needle) {
+        size_t count = 0;
+        for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+            count++;
+        }
+        return count;
+    };
+    
+    std::string validOutput;
+    int validScope;
+    assert(parseSource("int main() { int x = 1; while (x < 2) { x = x + 1; } return x; }",
+                       validOutput, validScope, Parser::DEFAULT_MAX_ERRORS));
+    
+    // One error per line; the loop body and the stray if are skipped whole,
+    // and the half-declared x and y stay declared
+    const std::string source =
+        "int main() {\n"
+        "    int x = 5\n"
+        "    int y = = 3;\n"
+        "    while (x < int) {\n"
+        "        y = y + 1;\n"
+        "    }\n"
+        "    x = ;\n"
+        "    y = x * ;\n"
+        "    if (x) { x = 1; }\n"
+        "    return x;\n"
+        "}\n";
+    std::string output;
+    int scope;
+    assert(!parseSource(source, output, scope, Parser::DEFAULT_MAX_ERRORS));
+    assert(countOf(output, ": error:") == 6);
+    for (const char* location : {":3:5:", ":3:13:", ":4:16:", ":7:9:", ":8:13:", ":9:5:"}) {
+        assert(output.find(location) != std::string::npos);
+    }
+    assert(output.find("undeclared") == std::string::npos);
+    assert(scope == validScope);
+    
+    // The cascade from resynchronizing on 'int' inside the condition (an
+    // identifier expected at ')') is not reported
+    assert(output.find(":4:19:") == std::string::npos);
+    
+    // A half-declared variable keeps its own name, not one from its
+    // initializer: one error, with no redeclaration of a or use of an
+    // undeclared b after it
+    output.clear();
+    assert(!parseSource("int main() {\n    int a = 1;\n    int b = a + ;\n    b = 2;\n    return b;\n}\n",
+                        output, scope, Parser::DEFAULT_MAX_ERRORS));
+    assert(countOf(output, ": error:") == 1);
+    assert(output.find(":3:17:") != std::string::npos);
+    assert(output.find("Redeclaration") == std::string::npos && output.find("undeclared") == std::string::npos);
+    
+    // Reporting stops at the cap
+    std::string many = "int main() {\n";
+    for (int i = 0; i < 30; i++) {
+        many += "    int v" + std::to_string(i) + " = * 2;\n";
+    }
+    many += "}\n";
+    output.clear();
+    assert(!parseSource(many, output, scope, 10));
+    assert(countOf(output, ": error:") == 11);
+    assert(output.find("Too many syntax errors (10)") != std::string::npos);
+    
+    // Garbage always terminates
+    output.clear();
+    assert(!parseSource("int main() { ) ) if if ( ; } } } while { ; return", output, scope,
+                        Parser::DEFAULT_MAX_ERRORS));
+    assert(countOf(output, ": error:") > 0);
+    
+    std::cout << "Panic-mode recovery test passed!" << std::endl;
+}
+
+// Test recording parse steps into a ring and decoding them afterwards
+void testParseTrace() {
+    std::cout << "Testing parse traces..." << std::endl;
+    
+    std::string filename = createTempFile("int main() { int x = 1; while (x < 3) { x++; } return x; }");
+    Lexer lexer(filename);
+    TokenStream tokens = lexer.tokenize();
+    
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    Parser parser(tokens, reporter, symbolTable);
+    RingTrace trace(12);
+    assert(parser.parseTraced(trace));
+    assert(trace.dropped() == 0 && trace.size() > 16);
+    assert(parser.getAst().getRoot().isValid());
+    
+    // Decoded with names and lexemes, the steps read as --show-parse-steps
+    std::ostringstream text;
+    TraceDecoder(&parser.getFirstFollowSets(), &tokens).print(trace.snapshot(), trace.dropped(), text);
+    assert(text.str().rfind("Token stream status: has tokens\nCurrent token: int", 0) == 0);
+    assert(text.str().find("Processing non-terminal: PROGRAM\n") != std::string::npos);
+    assert(text.str().find("Adding symbol to table: x of type int\n") != std::string::npos);
+    assert(text.str().find("Matched token: while\n") != std::string::npos);
+    
+    // A small ring keeps the newest steps and counts the rest
+    ErrorReporter smallReporter;
+    SymbolTable smallSymbols;
+    Parser smallParser(tokens, smallReporter, smallSymbols);
+    RingTrace small(4);
+    assert(smallParser.parseTraced(small));
+    assert(small.size() == 16 && small.dropped() == trace.size() - 16);
+    std::vector<TraceRecord> all = trace.snapshot();
+    std::vector<TraceRecord> tail = small.snapshot();
+    for (size_t i = 0; i < tail.size(); i++) {
+        const TraceRecord& expected = all[all.size() - tail.size() + i];
+        assert(tail[i].event == expected.event && tail[i].value == expected.value &&
+               tail[i].token == expected.token);
+    }
+    std::ostringstream smallText;
+    TraceDecoder().print(tail, small.dropped(), smallText);
+    assert(smallText.str().rfind("(" + std::to_string(small.dropped()) + " earlier parse steps not recorded)\n", 0) == 0);
+    
+    // Saved traces load back unchanged
+    std::string traceFile = filename + ".trace";
+    assert(trace.save(traceFile, true));
+    SavedTrace saved;
+    assert(saved.load(traceFile));
+    assert(saved.builtin_grammar && saved.dropped == 0 && saved.records.size() == all.size());
+    std::ostringstream reloaded;
+    TraceDecoder(&FirstFollowSets::builtin(), &tokens).print(saved.records, saved.dropped, reloaded);
+    assert(reloaded.str() == text.str());
+    std::remove(traceFile.c_str());
+    assert(!saved.load(filename));
+    
+    std::cout << "Parse trace test passed!" << std::endl;
+}
+
+// Test the LALR(1) tables and shift-reduce parser
+void testLalrParser() {
+    std::cout << "Testing the LALR(1) parser..." << std::endl;
+    
+    const LalrTables& tables = LalrTables::builtin();
+    assert(tables.getStateCount() > 0);
+    assert(tables.tableBytes() < tables.denseTableBytes());
+    
+    // Where the recursive-descent parser accepts, the LALR parser accepts
+    // with the same diagnostics and scopes; where it rejects, so does LALR
+    const std::vector<std::string> sources = {
+        "int main() { int x = 1; float y; y = 2.5; while (x < 10) { x = x + 1; x++; } return x; }",
+        "int main() { int a = 2; a = (a + 3) * a - a / 4; 5; (a); return a; }",
+        "int main() { x = 1; int y; y = x; return y; }",
+        "int main() { int x; int x; return y; }",
+        "int main() { int i = 0; while (i <= 3) { int j = i--; while (j != 0) { j = j - 1; } i++; } }",
+        "int main() { ; }",
+        "int main() { ",
+        "int main() { int 123; }",
+        "int main() { int x = 10 }",
+        "int main() { int x = 1 +; }",
+        "int main() { int x = 1; while (x) { } }",
+        "int main() { return 0; } extra",
+        "main() { }",
+        "int add(int a, int b) { return a + b; } int main() { int x = add(1, 2 * 3); return add(x, 1); }",
+        "int f(int a, float a) { return a; } int main() { return f(1) + g(); } int f() { }",
+        "int f(int a,) { } int main() { }",
+    };
+    for (const std::string& source : sources) {
+        std::string filename = createTempFile(source);
+        Lexer lexer(filename);
+        TokenStream tokens = lexer.tokenize();
+        
+        std::string rdOutput, lalrOutput;
+        int rdScope, lalrScope;
+        bool rdResult = runForComparison<RecursiveDescentParser>(tokens, rdOutput, rdScope);
+        bool lalrResult = runForComparison<LalrParser>(tokens, lalrOutput, lalrScope);
+        assert(lalrResult == rdResult);
+        if (rdResult) {
+            assert(lalrOutput == rdOutput && lalrScope == rdScope);
+        } else {
+            assert(lalrOutput.find("error") != std::string::npos);
+        }
+    }
+    
+    // A long left-associative chain is reduced as it goes, so the stack
+    // stays as shallow as the expression grammar
+    std::string chain = "int main() { int x = 1; x = x";
+    for (int i = 0; i < 2000; i++) {
+        chain += i % 2 ? " - x" : " * 2";
+    }
+    chain += "; return x; }";
+    std::string filename = createTempFile(chain);
+    Lexer lexer(filename);
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    LalrParser parser(lexer.tokenize(), reporter, symbolTable);
+    assert(parser.parse());
+    assert(parser.getStats().max_stack_depth < 16);
+    
+    // Errors name what the state could take
+    std::string output;
+    int scope;
+    filename = createTempFile("int main() { int x = 1; x = x * ; }");
+    Lexer broken(filename);
+    assert(!runForComparison<LalrParser>(broken.tokenize(), output, scope));
+    assert(output.find("Unexpected ';'; expected one of: ") != std::string::npos);
+    assert(output.find("identifier") != std::string::npos);
+
+    // Each broken statement is reported, and the block still closes
+    output.clear();
+    filename = createTempFile("int main() { int x = ; x = 1 2; while (x) { } return x; }");
+    Lexer recovering(filename);
+    TokenStream recoveringTokens = recovering.tokenize();
+    assert(!runForComparison<LalrParser>(recoveringTokens, output, scope));
+    size_t reported = 0;
+    for (size_t at = output.find("error: "); at != std::string::npos; at = output.find("error: ", at + 1)) {
+        reported++;
+    }
+    std::string rdOutput;
+    int rdScope;
+    assert(!runForComparison<RecursiveDescentParser>(recoveringTokens, rdOutput, rdScope));
+    assert(reported == 3 && scope == rdScope);
+
+    // An ambiguous grammar is refused with its conflicts
+    using Rhs = std::vector<std::variant<NonTerminal, std::string, TokenType>>;
+    std::vector<Production> ambiguous = {
+        Production(NonTerminal::PROGRAM, Rhs{NonTerminal::EXPRESSION}),
+        Production(NonTerminal::EXPRESSION, Rhs{NonTerminal::EXPRESSION, "+", NonTerminal::EXPRESSION}),
+        Production(NonTerminal::EXPRESSION, Rhs{TokenType::Identifier}),
+    };
+    ErrorReporter grammarReporter;
+    std::string conflicts;
+    grammarReporter.setOutput(&conflicts);
+    assert(!LalrTables::build(FirstFollowSets(ambiguous), NonTerminal::PROGRAM, grammarReporter));
+    grammarReporter.flush();
+    assert(conflicts.find("LALR(1) shift/reduce conflict") != std::string::npos);
+    
+    // Without the ambiguity the same rules build
+    ambiguous[1] = Production(NonTerminal::EXPRESSION, Rhs{NonTerminal::EXPRESSION, "+", TokenType::Identifier});
+    assert(LalrTables::build(FirstFollowSets(ambiguous), NonTerminal::PROGRAM, grammarReporter));
+    
+    std::cout << "LALR(1) parser test passed!" << std::endl;
+}
+
+void testPrattExpressions() {
+    std::cout << "Testing Pratt expressions..." << std::endl;
+    
+    auto parseSource = [](const std::string& source, bool pratt, std::string& dump, std::string& output,
+                          size_t& steps) {
+        std::string filename = createTempFile(source);
+        CompilationContext context(filename);
+        context.getReporter().setOutput(&output);
+        Lexer lexer(filename, context);
+        Parser parser(lexer.tokenize(), context);
+        parser.setPrattExpressions(pratt);
+        bool result = parser.parse();
+        context.getReporter().flush();
+        dump = context.getAst().getRoot().isValid() ? context.getAst().dump() : "";
+        steps = parser.getStats().steps;
+        return result;
+    };
+    std::string dump, output;
+    size_t steps;
+    
+    // Every C operator Mini-C has operands for, at C's precedence
+    std::string source = "int main() { int a; int b; a = -b + ~3 * 2; b = a > 0 ? a : -a; "
+                         "a += b << 2 | 1 ^ a & 3; a = b = a || b && !a; a++; "
+                         "while ((a & 1) < -b * 2) { --a; } return a; }";
+    assert(parseSource(source, true, dump, output, steps));
+    assert(dump ==
+           "(function main\n"
+           "  (declare int a)\n"
+           "  (declare int b)\n"
+           "  (assign a (+ (prefix - b) (* (prefix ~ 3) 2)))\n"
+           "  (assign b (? (> a 0) a (prefix - a)))\n"
+           "  (expr (+= a (| (<< b 2) (^ 1 (& a 3)))))\n"
+           "  (assign a (= b (|| a (&& b (prefix ! a)))))\n"
+           "  (expr (++ a))\n"
+           "  (while (< (& a 1) (* (prefix - b) 2))\n"
+           "    (expr (prefix -- a)))\n"
+           "  (return a))\n");
+    output.clear();
+    assert(!parseSource(source, false, dump, output, steps));
+    
+    // On the grammar's own operators both modes build the same tree, and
+    // climbing takes fewer steps than the _TAIL expansions
+    std::string arithmetic = "int main() { int a = 2; float f; a = (a + 3) * a - a / 4 * 2 + 1; 5; "
+                             "while (a + 1 >= a * 2) { a--; } return a - 1; }";
+    std::string prattDump, tableDump;
+    size_t prattSteps, tableSteps;
+    assert(parseSource(arithmetic, true, prattDump, output, prattSteps));
+    assert(parseSource(arithmetic, false, tableDump, output, tableSteps));
+    assert(prattDump == tableDump);
+    assert(prattSteps < tableSteps);
+    
+    // A condition is still one relational operator between two operands
+    output.clear();
+    assert(!parseSource("int main() { int a; int b; while (a && b < 1) { } }", true, dump, output, steps));
+    assert(output.find("RELATIONAL_OP") != std::string::npos);
+    
+    // A missing operand is reported and recovery goes on to the next statement
+    output.clear();
+    assert(!parseSource("int main() { int a; a = 1 + ; a = ; b = 2; }", true, dump, output, steps));
+    assert(output.find("Expected expression, got ';'") != std::string::npos);
+    assert(output.find("undeclared variable 'b'") != std::string::npos);
+    
+    std::cout << "Pratt expression test passed!" << std::endl;
+}
+
+void testIncrementalReparse() {
+    std::cout << "Testing incremental reparsing..." << std::endl;
+    
+    // What a parse leaves behind: the tree with its token indices, and the diagnostics
+    struct Outcome {
+        bool accepted;
+        std::string dump;
+        std::vector<uint32_t> tokens;
+        std::string diagnostics;
+        size_t steps;
+    };
+    auto outcomeOf = [](bool accepted, const Ast& ast, const std::string& diagnostics, size_t steps) {
+        Outcome outcome{accepted, ast.getRoot().isValid() ? ast.dump() : "", {}, diagnostics, steps};
+        ast.forEachNode(ast.getRoot(), [&](NodeRef node) { outcome.tokens.push_back(ast.tokenOf(node)); });
+        return outcome;
+    };
+    auto fullParse = [&](const std::string& filename, const TokenStream& tokens, bool pratt) {
+        ErrorReporter reporter;
+        std::string diagnostics;
+        reporter.init(filename);
+        reporter.setOutput(&diagnostics);
+        SymbolTable symbolTable;
+        Parser parser(tokens, reporter, symbolTable);
+        parser.setPrattExpressions(pratt);
+        bool accepted = parser.parse();
+        reporter.flush();
+        return outcomeOf(accepted, parser.getAst(), diagnostics, parser.getStats().steps);
+    };
+    
+    IncrementalParser incremental;
+    TokenStream previous;
+    bool first = true;
+    // Reparse source after the previous one and check it against a full parse
+    auto reparse = [&](const std::string& source, bool pratt = false) {
+        std::string filename = createTempFile(source);
+        Lexer lexer(filename);
+        TokenStream tokens = lexer.tokenize();
+        
+        ErrorReporter reporter;
+        std::string diagnostics;
+        reporter.init(filename);
+        reporter.setOutput(&diagnostics);
+        SymbolTable symbolTable;
+        incremental.setPrattExpressions(pratt);
+        bool accepted = first ? incremental.parse(tokens, reporter, symbolTable)
+                              : incremental.reparse(tokens, TokenEdit::between(previous, tokens), reporter,
+                                                    symbolTable);
+        reporter.flush();
+        Outcome reused = outcomeOf(accepted, incremental.getAst(), diagnostics, incremental.getStats().steps);
+        Outcome full = fullParse(filename, tokens, pratt);
+        assert(reused.accepted == full.accepted);
+        assert(reused.dump == full.dump);
+        assert(reused.tokens == full.tokens);
+        assert(reused.diagnostics == full.diagnostics);
+        assert(incremental.getReusedStatements() == 0 || reused.steps < full.steps);
+        previous = std::move(tokens);
+        first = false;
+        return incremental.getReusedStatements();
+    };
+    
+    const std::string source = "int main() { int a = 1; float f; while (a < 10) { int b = a * 2; "
+                               "while (b > 0) { b = b - 1; } a = a + b; } f = 2.5; return a; }";
+    assert(reparse(source) == 0);
+    
+    // An edit deep in the loops reparses them and nothing else
+    assert(reparse("int main() { int a = 1; float f; while (a < 10) { int b = a * 2; "
+                   "while (b > 0) { b = b - 2; } a = a + b; } f = 2.5; return a; }") == 6);
+    // Inserted and deleted statements move the token indices after them
+    assert(reparse("int main() { int a = 1; float f; a++; while (a < 10) { int b = a * 2; "
+                   "while (b > 0) { b = b - 2; } a = a + b; } f = 2.5; return a; }") == 5);
+    assert(reparse("int main() { int a = 1; float f; a++; while (a < 10) { "
+                   "while (b > 0) { b = b - 2; } a = a + b; } f = 2.5; return a; }") > 0);
+    // Reused statements still look their names up in the new scopes
+    assert(reparse("int main() { int a = 1; float f; a++; while (a < 10) { int b = 0; "
+                   "while (b > 0) { b = b - 2; } a = a + b; } f = 2.5; return a; }") > 0);
+    
+    // A syntax error leaves nothing to reuse; the fix is parsed in full
+    reparse("int main() { int a = 1; float f; a++; while (a < 10) { int b = 0; "
+            "while (b > 0) { b = b - 2; } a = a + b; f = 2.5; return a; }");
+    assert(reparse("int main() { int a = 1; float f; a++; while (a < 10) { int b = 0; "
+                   "while (b > 0) { b = b - 2; } a = a + b; } f = 2.5; return a; }") == 0);
+    
+    // Every literal in turn, each edit reparsed from the one before
+    std::string edited = source;
+    for (size_t at = edited.find_first_of("0123456789"); at != std::string::npos;
+         at = edited.find_first_of("0123456789", at + 1)) {
+        edited[at] = edited[at] == '9' ? '8' : '9';
+        assert(reparse(edited) > 0);
+    }
+    
+    // A change of expression mode parses in full once, then reuses again
+    assert(reparse(edited, true) == 0);
+    edited.replace(edited.find("a * "), 5, "a > 0 ? -a : ~a");
+    assert(reparse(edited, true) == 6);
+    
+    std::cout << "Incremental reparse test passed!" << std::endl;
+}
+
+void testFunctionsAndCalls() {
+    std::cout << "Testing functions and calls..." << std::endl;
+
+    auto parseSource = [](const std::string& source, bool pratt, std::string& dump, std::string& output) {
+        std::string filename = createTempFile(source);
+        CompilationContext context(filename);
+        context.getReporter().setOutput(&output);
+        Lexer lexer(filename, context);
+        Parser parser(lexer.tokenize(), context);
+        parser.setPrattExpressions(pratt);
+        bool result = parser.parse();
+        if (result) {
+            context.getSymbolTable().getFunctions().check(context.getReporter());
+        }
+        context.getReporter().flush();
+        dump = context.getAst().getRoot().isValid() ? context.getAst().dump() : "";
+        return result;
+    };
+    std::string dump, output;
+
+    // Parameters are declared in the body's scope, and calls nest in expressions
+    std::string source = "int add(int a, int b) { return a + b; }\n"
+                         "float half(float x) { return x / 2; }\n"
+                         "int main() { int y = add(1, 2 * 3); y = add(add(y, 1), half(y)) + 1; return add(y, y); }";
+    for (bool pratt : {false, true}) {
+        output.clear();
+        assert(parseSource(source, pratt, dump, output));
+        assert(output.empty());
+        assert(dump ==
+               "(function add (int a) (int b)\n"
+               "  (return (+ a b)))\n"
+               "(function half (float x)\n"
+               "  (return (/ x 2)))\n"
+               "(function main\n"
+               "  (declare int y (call add 1 (* 2 3)))\n"
+               "  (assign y (+ (call add (call add y 1) (call half y)) 1))\n"
+               "  (return (call add y y)))\n");
+    }
+
+    // A function may be called before its definition; parameters are not
+    // visible outside their function
+    output.clear();
+    assert(parseSource("int main() { return twice(3); } int twice(int n) { return n * 2 + a; } "
+                       "int other() { return n; }",
+                       false, dump, output));
+    assert(output.find("function 'twice'") == std::string::npos);
+    assert(output.find("undeclared variable 'a'") != std::string::npos);
+    assert(output.find("undeclared variable 'n'") != std::string::npos);
+
+    // Undefined functions, wrong argument counts, redefinitions and repeated
+    // parameters, each reported where it happens
+    output.clear();
+    assert(parseSource("int f(int a, float a) { return a; }\n"
+                       "int main() { f(); f(1, 2); return g(1); }\n"
+                       "float f() { return 0; }",
+                       false, dump, output));
+    assert(output.find("1:20: error: Redeclaration of variable 'a'") != std::string::npos);
+    assert(output.find("2:14: error: Function 'f' takes 2 arguments, but the call passes 0") != std::string::npos);
+    assert(output.find("2:20: error: Function 'f' takes 2 arguments, but the call passes 2") == std::string::npos);
+    assert(output.find("2:35: error: Call to undefined function 'g'") != std::string::npos);
+    assert(output.find("3:7: error: Redefinition of function 'f'") != std::string::npos);
+
+    // Arguments are counted as they are parsed, each call's own commas only
+    std::string nested = "int f(int a, int b) { return a; } int g() { return 0; } int h(int a) { return a; }\n"
+                         "int main() { return f(g(), f((1), f(2, h(3)))) + f(h(g())); }\n";
+    for (bool pratt : {false, true}) {
+        output.clear();
+        assert(parseSource(nested, pratt, dump, output));
+        assert(output.find("2:50: error: Function 'f' takes 2 arguments, but the call passes 1") != std::string::npos);
+        assert(output.find("error:") == output.rfind("error:"));
+    }
+    std::string deep = "int h(int a) { return a; } int main() { return ";
+    for (int i = 0; i < 5000; i++) {
+        deep += "h(";
+    }
+    deep += "1" + std::string(5000, ')') + "; }";
+    output.clear();
+    assert(parseSource(deep, false, dump, output));
+    assert(output.empty());
+
+    // A missing ')' in an argument list is a syntax error, in either mode
+    for (bool pratt : {false, true}) {
+        output.clear();
+        assert(!parseSource("int main() { int x = f(1, 2; return x; }", pratt, dump, output));
+    }
+
+    std::cout << "Functions and calls test passed!" << std::endl;
+}
+
+void testParallelParser() {
+    std::cout << "Testing the parallel parser..." << std::endl;
+
+    // Diagnostics, tree and functions of a sequential parse and a parallel one
+    struct Outcome {
+        bool accepted;
+        std::string dump;
+        std::vector<uint32_t> tokens;
+        std::string diagnostics;
+        std::vector<std::string> functions;
+    };
+    auto functionsOf = [](const SymbolTable& symbolTable) {
+        std::vector<std::string> functions;
+        for (const FunctionInfo& function : symbolTable.getFunctions().getFunctions()) {
+            functions.push_back(function.name + "/" + std::to_string(function.parameters.size()));
+        }
+        return functions;
+    };
+    // Token of every node under the program, which is a tree of its own per function
+    auto addFunctionTokens = [](const Ast& ast, NodeRef root, std::vector<uint32_t>& tokens) {
+        const ProgramNode& program = ast.get<ProgramNode>(root);
+        for (uint32_t i = 0; i < program.functions.count; i++) {
+            ast.forEachNode(ast.listAt(program.functions, i),
+                            [&](NodeRef node) { tokens.push_back(ast.tokenOf(node)); });
+        }
+    };
+    auto sequential = [&](const std::string& filename, const TokenStream& tokens) {
+        ErrorReporter reporter;
+        Outcome outcome;
+        reporter.init(filename);
+        reporter.setOutput(&outcome.diagnostics);
+        SymbolTable symbolTable;
+        Parser parser(tokens, reporter, symbolTable);
+        outcome.accepted = parser.parse();
+        if (outcome.accepted) {
+            symbolTable.getFunctions().check(reporter);
+        }
+        reporter.flush();
+        const Ast& ast = parser.getAst();
+        if (ast.getRoot().isValid()) {
+            outcome.dump = ast.dump();
+            addFunctionTokens(ast, ast.getRoot(), outcome.tokens);
+        }
+        outcome.functions = functionsOf(symbolTable);
+        return outcome;
+    };
+    auto parallel = [&](ParallelParser& parser, const std::string& filename, const TokenStream& tokens) {
+        ErrorReporter reporter;
+        Outcome outcome;
+        reporter.init(filename);
+        reporter.setOutput(&outcome.diagnostics);
+        SymbolTable symbolTable;
+        outcome.accepted = parser.parse(tokens, reporter, symbolTable);
+        reporter.flush();
+        outcome.dump = parser.dump();
+        for (size_t tree = 0; outcome.accepted && tree < parser.getTreeCount(); tree++) {
+            addFunctionTokens(parser.getAst(tree), parser.getRoot(tree), outcome.tokens);
+        }
+        outcome.functions = functionsOf(symbolTable);
+        return outcome;
+    };
+
+    std::string source;
+    for (int i = 0; i < 40; i++) {
+        std::string n = std::to_string(i);
+        source += "int f" + n + "(int a, float b) { int x = a * " + n + "; while (x > 0) { x = x - 1; } " +
+                  "return f" + std::to_string((i + 1) % 40) + "(x, b) + y" + n + "; }\n";
+    }
+    source += "int main() { return f0(1, 2.5) + f3(1) + g(); }\n";
+    source += "float f7() { return 0; }\n";
+    std::string filename = createTempFile(source);
+    Lexer lexer(filename);
+    TokenStream tokens = lexer.tokenize();
+
+    std::vector<ParallelParser::FunctionSpan> spans = ParallelParser::findFunctions(tokens);
+    assert(spans.size() == 42);
+    assert(spans[0].begin == 0 && spans.back().end == tokens.size() - 1);
+    for (size_t i = 1; i < spans.size(); i++) {
+        assert(spans[i].begin == spans[i - 1].end);
+    }
+
+    // Whatever the thread count, the outcome is the sequential one
+    Outcome expected = sequential(filename, tokens);
+    assert(expected.accepted);
+    assert(expected.diagnostics.find("Call to undefined function 'g'") != std::string::npos);
+    assert(expected.diagnostics.find("Redefinition of function 'f7'") != std::string::npos);
+    for (unsigned threads : {1u, 3u, 8u}) {
+        ParallelParser parser(threads);
+        Outcome outcome = parallel(parser, filename, tokens);
+        assert(parser.wasSplit() && parser.getTreeCount() == 42);
+        assert(outcome.accepted == expected.accepted);
+        assert(outcome.dump == expected.dump);
+        assert(outcome.tokens == expected.tokens);
+        assert(outcome.diagnostics == expected.diagnostics);
+        assert(outcome.functions == expected.functions);
+    }
+
+    // Token indices of later functions are into the whole stream
+    ParallelParser parser(4);
+    Outcome outcome = parallel(parser, filename, tokens);
+    const Ast& last = parser.getAst(41);
+    NodeRef function = last.listAt(last.get<ProgramNode>(parser.getRoot(41)).functions, 0);
+    assert(last.tokenOf(function) == spans[41].begin + 1);
+
+    // Input that does not split into functions is parsed in one piece
+    for (const std::string& broken : {std::string("int main() { int x = 1; "),
+                                      std::string("int main() { } int x;"),
+                                      std::string("int f(int a) { return a; } } int main() { }")}) {
+        std::string brokenFile = createTempFile(broken);
+        Lexer brokenLexer(brokenFile);
+        TokenStream brokenTokens = brokenLexer.tokenize();
+        assert(ParallelParser::findFunctions(brokenTokens).empty());
+        Outcome whole = parallel(parser, brokenFile, brokenTokens);
+        assert(!parser.wasSplit());
+        Outcome alone = sequential(brokenFile, brokenTokens);
+        assert(whole.accepted == alone.accepted && whole.diagnostics == alone.diagnostics);
+    }
+
+    std::cout << "Parallel parser test passed!" << std::endl;
+}
+
 // Rename main to run_parser_tests to avoid conflict with other test files
 int run_parser_tests() {
     std::cout << "==== RUNNING PARSER TESTS ====" << std::endl;
@@ -765,21 +2217,49 @@ int run_parser_tests() {
     testFirstSets();
     testFollowSets();
     testParseTable();
-    testParseSimpleProgram();
-    testParseWhileLoop();
-    testParseArithmeticOperators();
-    testParseRelationalOperators();
-    testParseNestedExpressions();
-    testParseErrors();
-    testErrorRecovery();
+    
+    // Parsing tests, shared by both parsers
+    for (ParserUnderTest kind : {ParserUnderTest::LL1, ParserUnderTest::RecursiveDescent}) {
+        parserUnderTest = kind;
+        std::cout << "-- Using the " << (kind == ParserUnderTest::LL1 ? "LL(1)" : "recursive-descent")
+                  << " parser --" << std::endl;
+        testParseSimpleProgram();
+        testParseWhileLoop();
+        testParseArithmeticOperators();
+        testParseRelationalOperators();
+        testParseNestedExpressions();
+        testParseErrors();
+        testErrorRecovery();
+        testBasicMainFunction();
+        testDeclarationsAndAssignments();
+        testLoopsAndConditions();
+        testExpressions();
+        testSyntaxErrorDetection();
+        testIndependentCompilationContexts();
+        testParseDeepNesting();
+    }
+    parserUnderTest = ParserUnderTest::LL1;
     testLL1Parser();
     
     // Additional tests
-    testBasicMainFunction();
-    testDeclarationsAndAssignments();
-    testLoopsAndConditions();
-    testExpressions();
-    testSyntaxErrorDetection();
+    testDiagnosticFormatting();
+    testDiagnosticSerializers();
+    testMultiFileSarif();
+    testDiagnosticOrdering();
+    testDiagnosticSourceLines();
+    testCompileTimeGrammarTables();
+    testLargeGrammarSets();
+    testGrammarFileLoading();
+    testParsersAgree();
+    testLalrParser();
+    testPrattExpressions();
+    testIncrementalReparse();
+    testFunctionsAndCalls();
+    testParallelParser();
+    testPanicModeRecovery();
+    testAstConstruction();
+    testParseEvents();
+    testParseTrace();
     
     std::cout << "All parser tests passed!" << std::endl;
     
@@ -0,0 +1,211 @@
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include "lexer.h"
+#include "parser.h"
+#include "generated_parser.h"
+#include "recursive_descent_parser.h"
+#include "error.h"
+#include "symbol_table.h"
+
+// Stress tests for huge programs. The statement count defaults to something
+// that runs in seconds; set MINICOMPILER_STRESS_STATEMENTS to go further
+// (10000000 works, but needs several GB for the token stream).
+
+static size_t stressStatementCount() {
+    const char* value = std::getenv("MINICOMPILER_STRESS_STATEMENTS");
+    if (value && *value) {
+        return std::strtoul(value, nullptr, 10);
+    }
+    return 200000;
+}
+
+// One statement of every kind per four, with no nesting deeper than a loop body
+static TokenStream tokenizeProgram(size_t statements) {
+    const std::string filename = "stress_program.c";
+    {
+        std::ofstream file(filename);
+        file << "int main() {\n    int x = 0;\n    float y = 1.5;\n";
+        for (size_t i = 0; i < statements; i++) {
+            switch (i % 4) {
+                case 0: file << "    x = (x + " << i << ") * y - x / 2;\n"; break;
+                case 1: file << "    int v" << i << " = " << i << " * 3;\n"; break;
+                case 2: file << "    while (x < " << i << ") { x++; }\n"; break;
+                default: file << "    y = y + 0.5;\n"; break;
+            }
+        }
+        file << "    return x;\n}\n";
+    }
+    ErrorReporter reporter;
+    Lexer lexer(filename, reporter);
+    TokenStream tokens = lexer.tokenize();
+    std::remove(filename.c_str());
+    assert(reporter.getErrorCount() == 0);
+    return tokens;
+}
+
+static ParseStats parseWithStats(const TokenStream& tokens) {
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    Parser parser(tokens, reporter, symbolTable);
+    bool result = parser.parse();
+    assert(result);
+    assert(reporter.getErrorCount() == 0);
+    return parser.getStats();
+}
+
+// The table-driven parser does a bounded amount of work per token and its
+// stack depth depends on nesting, not on program length
+void testParserScalesLinearly(const TokenStream& large) {
+    size_t statements = stressStatementCount();
+    std::cout << "Testing linear-time parsing of " << statements << " statements..." << std::endl;
+    
+    TokenStream small = tokenizeProgram(statements / 10);
+    ParseStats smallStats = parseWithStats(small);
+    ParseStats largeStats = parseWithStats(large);
+    
+    std::cout << large.size() << " tokens, " << largeStats.steps << " steps, stack depth "
+              << largeStats.max_stack_depth << std::endl;
+    // About three stack operations per token, plus one per AST reduction
+    assert(smallStats.steps <= 6 * small.size());
+    assert(largeStats.steps <= 6 * large.size());
+    assert(largeStats.max_stack_depth == smallStats.max_stack_depth);
+    
+    std::cout << "Linear-time parsing test passed!" << std::endl;
+}
+
+// The tree stays compact on large inputs: nodes, name and list storage and
+// pool directories, divided by the node count
+void testAstBytesPerNode(const TokenStream& tokens) {
+    std::cout << "Testing AST memory on large inputs..." << std::endl;
+    
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    Parser parser(tokens, reporter, symbolTable);
+    bool result = parser.parse();
+    assert(result);
+    
+    const Ast& ast = parser.getAst();
+    double bytesPerNode = static_cast<double>(ast.getBytesUsed()) / ast.getNodeCount();
+    std::cout << ast.getNodeCount() << " nodes, " << ast.getBytesUsed() << " bytes, "
+              << bytesPerNode << " bytes per node" << std::endl;
+    NodeRef main = ast.listAt(ast.get<ProgramNode>(ast.getRoot()).functions, 0);
+    assert(ast.get<FunctionNode>(main).body.count == stressStatementCount() + 3);
+    assert(bytesPerNode < 20);
+    
+    std::cout << "AST memory test passed!" << std::endl;
+}
+
+// Streaming over a huge input with events needs no tree at all
+struct StatementCounter : ParseEvents {
+    size_t declarations = 0;
+    size_t loops = 0;
+    size_t operators = 0;
+    
+    void onDeclaration(SymbolType /*type*/, const Token& /*name*/, uint32_t /*index*/, bool /*has_initializer*/) {
+        declarations++;
+    }
+    void onLoopEnd(const Token& /*keyword*/, uint32_t /*index*/) { loops++; }
+    void onExpressionOperator(const Token& /*op*/, uint32_t /*index*/) { operators++; }
+};
+
+void testEventStreamOnHugeInput(const TokenStream& tokens) {
+    std::cout << "Testing parse events on large inputs..." << std::endl;
+    
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    Parser parser(tokens, reporter, symbolTable);
+    StatementCounter counter;
+    bool result = parser.parse(counter);
+    assert(result);
+    
+    // One of each statement kind per four, plus x and y
+    size_t statements = stressStatementCount();
+    assert(counter.declarations == (statements + 2) / 4 + 2);
+    assert(counter.loops == (statements + 1) / 4);
+    assert(parser.getAst().getNodeCount() == 0);
+    
+    std::cout << "Parse events on large inputs test passed!" << std::endl;
+}
+
+// The other parsers accept the same program
+template <typename ParserType>
+static void assertAccepts(const TokenStream& tokens) {
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    ParserType parser(tokens, reporter, symbolTable);
+    bool result = parser.parse();
+    assert(result);
+    assert(reporter.getErrorCount() == 0);
+}
+
+void testAllParsersAcceptHugePrograms(const TokenStream& tokens) {
+    std::cout << "Testing that all parsers accept huge programs..." << std::endl;
+    
+    assertAccepts<GeneratedParser>(tokens);
+    assertAccepts<RecursiveDescentParser>(tokens);
+    
+    std::cout << "Huge program test passed!" << std::endl;
+}
+
+// Nesting lives on the parser's own stacks, not the native one: the
+// table-driven parser takes deeply nested parentheses with and without
+// Pratt expressions, and a long run of prefix operators with them
+static TokenStream tokenizeSource(const std::string& source) {
+    const std::string filename = "stress_nesting.c";
+    {
+        std::ofstream file(filename);
+        file << source;
+    }
+    ErrorReporter reporter;
+    Lexer lexer(filename, reporter);
+    TokenStream tokens = lexer.tokenize();
+    std::remove(filename.c_str());
+    assert(reporter.getErrorCount() == 0);
+    return tokens;
+}
+
+static void assertAcceptsNested(const TokenStream& tokens, bool pratt) {
+    ErrorReporter reporter;
+    SymbolTable symbolTable;
+    Parser parser(tokens, reporter, symbolTable);
+    parser.setPrattExpressions(pratt);
+    bool result = parser.parse();
+    assert(result);
+    assert(reporter.getErrorCount() == 0);
+}
+
+void testDeepNesting() {
+    std::cout << "Testing deeply nested expressions..." << std::endl;
+    
+    const size_t depth = 200000;
+    TokenStream parentheses = tokenizeSource("int main() {\n    int x = " + std::string(depth, '(') + "1" +
+                                             std::string(depth, ')') + ";\n    return x;\n}\n");
+    assertAcceptsNested(parentheses, false);
+    assertAcceptsNested(parentheses, true);
+    
+    std::string negations;
+    for (size_t i = 0; i < depth; i++) {
+        negations += "- ";
+    }
+    TokenStream prefixes = tokenizeSource("int main() {\n    int x = " + negations + "1;\n    return x;\n}\n");
+    assertAcceptsNested(prefixes, true);
+    
+    std::cout << "Deep nesting test passed!" << std::endl;
+}
+
+int run_parser_stress_tests() {
+    std::cout << "==== RUNNING PARSER STRESS TESTS ====" << std::endl;
+    
+    TokenStream tokens = tokenizeProgram(stressStatementCount());
+    testParserScalesLinearly(tokens);
+    testAstBytesPerNode(tokens);
+    testEventStreamOnHugeInput(tokens);
+    testAllParsersAcceptHugePrograms(tokens);
+    testDeepNesting();
+    
+    std::cout << "All parser stress tests passed!" << std::endl;
+    return 0;
+}
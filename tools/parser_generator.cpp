@@ -0,0 +1,347 @@
+// Emits GeneratedParser::parse() (see include/generated_parser.h) for an
+// LL(1) grammar file: one switch per non-terminal over terminal ids, with
+// the pushes for each production written out in reverse order.
+//
+// Cells the grammar allows to conflict (see isExpectedConflict()) are
+// resolved the way Parser::parse() resolves them: a production whose FIRST
+// set holds the lookahead beats one predicted through FOLLOW, and two such
+// productions are told apart by the token after the lookahead.
+//
+// Usage: minicompiler_parsergen GRAMMAR OUTPUT
+
+#include "parser.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+struct Rule {
+    size_t lhs;
+    std::vector<Symbol> rhs;
+};
+
+// Candidate productions for one (non-terminal, lookahead) cell
+struct Cell {
+    std::vector<int> by_first;   // Lookahead is in FIRST of the right-hand side
+    std::vector<int> by_follow;  // Only predicted through FOLLOW
+};
+
+Symbol toSymbol(const std::variant<NonTerminal, std::string, TokenType>& sym) {
+    if (std::holds_alternative<NonTerminal>(sym)) {
+        return symbol::NONTERMINAL_FLAG | static_cast<Symbol>(std::get<NonTerminal>(sym));
+    }
+    if (std::holds_alternative<TokenType>(sym)) {
+        switch (std::get<TokenType>(sym)) {
+            case TokenType::Identifier: return terminal::IDENTIFIER;
+            case TokenType::IntegerLiteral: return terminal::INTEGER_LITERAL;
+            case TokenType::FloatLiteral: return terminal::FLOAT_LITERAL;
+            default: return terminal::STRING_LITERAL;
+        }
+    }
+    return terminal::fromSpelling(std::get<std::string>(sym));
+}
+
+std::string quote(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+
+class Generator {
+public:
+    explicit Generator(const LL1Grammar& grammar) : grammar(grammar), sets(grammar.getSets()) {
+        for (const Production& prod : sets.grammar) {
+            Rule rule{static_cast<size_t>(prod.lhs), {}};
+            for (const auto& sym : prod.rhs) {
+                if (!(std::holds_alternative<std::string>(sym) && std::get<std::string>(sym) == EPSILON)) {
+                    rule.rhs.push_back(toSymbol(sym));
+                }
+            }
+            rules.push_back(rule);
+        }
+        computeCells();
+    }
+
+    bool emit(std::ostream& out, const std::string& grammar_path);
+
+private:
+    const LL1Grammar& grammar;
+    const FirstFollowSets& sets;
+    std::vector<Rule> rules;
+    std::vector<std::vector<Cell>> cells;  // [non-terminal][terminal]
+
+    bool nullable(size_t nt) const {
+        return sets.first_sets.at(static_cast<NonTerminal>(nt)).count(EPSILON) != 0;
+    }
+
+    void computeCells();
+    bool emitNonTerminal(std::ostream& out, size_t nt);
+    void emitPushes(std::ostream& out, int production, const char* indent);
+    void emitNoProduction(std::ostream& out, size_t nt, const std::string& name, const std::string& expected,
+                          const char* indent);
+    bool secondTerminal(int production, TerminalId& second) const;
+};
+
+void Generator::computeCells() {
+    cells.assign(grammar.getNonTerminalCount(), std::vector<Cell>(terminal::COUNT));
+    for (size_t p = 0; p < rules.size(); p++) {
+        const Rule& rule = rules[p];
+        std::vector<bool> first(terminal::COUNT, false);
+        bool rest_nullable = true;
+        for (size_t i = 0; i < rule.rhs.size() && rest_nullable; i++) {
+            Symbol sym = rule.rhs[i];
+            if (!symbol::isNonTerminal(sym)) {
+                first[sym] = true;
+                rest_nullable = false;
+                continue;
+            }
+            size_t index = symbol::nonTerminalIndex(sym);
+            for (const std::string& spelling : sets.first_sets.at(static_cast<NonTerminal>(index))) {
+                if (spelling != EPSILON) {
+                    first[terminal::fromSpelling(spelling)] = true;
+                }
+            }
+            rest_nullable = nullable(index);
+        }
+
+        for (TerminalId t = 0; t < terminal::COUNT; t++) {
+            if (first[t]) {
+                cells[rule.lhs][t].by_first.push_back(static_cast<int>(p));
+            }
+        }
+        if (rest_nullable) {
+            for (const std::string& spelling : sets.follow_sets.at(static_cast<NonTerminal>(rule.lhs))) {
+                TerminalId t = terminal::fromSpelling(spelling);
+                if (!first[t]) {
+                    cells[rule.lhs][t].by_follow.push_back(static_cast<int>(p));
+                }
+            }
+        }
+    }
+}
+
+// The terminal a production matches after its first one, looking through
+// leading non-terminals that have a single production
+bool Generator::secondTerminal(int production, TerminalId& second) const {
+    std::vector<Symbol> sequence = rules[production].rhs;
+    for (size_t depth = 0; depth < rules.size() && !sequence.empty() && symbol::isNonTerminal(sequence[0]); depth++) {
+        size_t nt = symbol::nonTerminalIndex(sequence[0]);
+        int only = -1;
+        for (size_t p = 0; p < rules.size(); p++) {
+            if (rules[p].lhs == nt) {
+                only = only == -1 ? static_cast<int>(p) : -2;
+            }
+        }
+        if (only < 0) {
+            return false;
+        }
+        sequence.erase(sequence.begin());
+        sequence.insert(sequence.begin(), rules[only].rhs.begin(), rules[only].rhs.end());
+    }
+    if (sequence.size() < 2 || symbol::isNonTerminal(sequence[0]) || symbol::isNonTerminal(sequence[1])) {
+        return false;
+    }
+    second = sequence[1];
+    return true;
+}
+
+void Generator::emitPushes(std::ostream& out, int production, const char* indent) {
+    const Rule& rule = rules[production];
+    out << indent << "// " << sets.nameOf(static_cast<NonTerminal>(rule.lhs)) << " →";
+    if (rule.rhs.empty()) {
+        out << " ε";
+    }
+    for (Symbol sym : rule.rhs) {
+        out << " " << (symbol::isNonTerminal(sym)
+                           ? sets.nameOf(static_cast<NonTerminal>(symbol::nonTerminalIndex(sym)))
+                           : std::string(terminal::spelling(sym)));
+    }
+    out << "\n";
+    for (auto it = rule.rhs.rbegin(); it != rule.rhs.rend(); ++it) {
+        out << indent << "stack.push_back(" << *it << ");\n";
+    }
+}
+
+// Report the lookahead; a construct it can follow is dropped in place,
+// anything else recovered from
+void Generator::emitNoProduction(std::ostream& out, size_t nt, const std::string& name, const std::string& expected,
+                                 const char* indent) {
+    out << indent << "if (!noProduction(static_cast<NonTerminal>(" << nt << "), " << quote(name) << ", "
+        << quote(expected) << ") && !recover(stack)) {\n";
+    out << indent << "    return false;\n";
+    out << indent << "}\n";
+    out << indent << "break;\n";
+}
+
+bool Generator::emitNonTerminal(std::ostream& out, size_t nt) {
+    std::string name = sets.nameOf(static_cast<NonTerminal>(nt));
+    bool has_rules = false;
+    bool has_empty = false;
+    for (const Rule& rule : rules) {
+        if (rule.lhs == nt) {
+            has_rules = true;
+            has_empty |= rule.rhs.empty();
+        }
+    }
+    if (!has_rules) {
+        return true;
+    }
+
+    // Group lookaheads that lead to the same action
+    std::map<int, std::vector<TerminalId>> direct;
+    std::vector<TerminalId> two_token;
+    for (TerminalId t = 0; t < terminal::COUNT; t++) {
+        const Cell& cell = cells[nt][t];
+        if ((!cell.by_first.empty() || !cell.by_follow.empty()) && t == terminal::MAIN) {
+            std::cerr << "error: contextual terminal 'main' cannot be a lookahead (" << name << ")\n";
+            return false;
+        }
+        if (cell.by_first.size() == 1) {
+            direct[cell.by_first[0]].push_back(t);
+        } else if (cell.by_first.size() > 1) {
+            two_token.push_back(t);
+        } else if (!cell.by_follow.empty()) {
+            direct[cell.by_follow.back()].push_back(t);
+        }
+    }
+
+    // Expected tokens for the diagnostic, as Parser::reportParseError() lists them
+    std::string expected;
+    for (const auto& entry : grammar.getParseTable().at(static_cast<NonTerminal>(nt))) {
+        expected += expected.empty() ? "'" : ", '";
+        expected += entry.first + "'";
+    }
+
+    out << "        case " << nt << ": {  // " << name << "\n";
+    out << "            onNonTerminal(static_cast<NonTerminal>(" << nt << "));\n";
+    out << "            switch (lookahead()) {\n";
+    for (const auto& action : direct) {
+        for (TerminalId t : action.second) {
+            out << "                case " << t << ":  // " << terminal::spelling(t) << "\n";
+        }
+        emitPushes(out, action.first, "                    ");
+        out << "                    break;\n";
+    }
+    for (TerminalId t : two_token) {
+        const Cell& cell = cells[nt][t];
+        out << "                case " << t << ":  // " << terminal::spelling(t) << "\n";
+        out << "                    switch (peekNext()) {\n";
+        int fallback = -1;
+        std::set<TerminalId> seen;
+        for (int production : cell.by_first) {
+            TerminalId second;
+            if (!secondTerminal(production, second)) {
+                fallback = production;
+                continue;
+            }
+            if (!seen.insert(second).second) {
+                std::cerr << "error: " << name << " needs more than two tokens of lookahead on '"
+                          << terminal::spelling(t) << "'\n";
+                return false;
+            }
+            out << "                        case " << second << ": {  // " << terminal::spelling(second) << "\n";
+            emitPushes(out, production, "                            ");
+            out << "                            break;\n";
+            out << "                        }\n";
+        }
+        out << "                        default: {\n";
+        if (fallback != -1) {
+            emitPushes(out, fallback, "                            ");
+        } else {
+            emitNoProduction(out, nt, name, expected, "                            ");
+        }
+        out << "                        }\n";
+        out << "                    }\n";
+        out << "                    break;\n";
+    }
+    out << "                default:\n";
+    if (has_empty) {
+        out << "                    if (defaultsToEmpty(static_cast<NonTerminal>(" << nt << "))) {\n";
+        out << "                        break;\n";
+        out << "                    }\n";
+    }
+    emitNoProduction(out, nt, name, expected, "                    ");
+    out << "            }\n";
+    out << "            break;\n";
+    out << "        }\n";
+    return true;
+}
+
+bool Generator::emit(std::ostream& out, const std::string& grammar_path) {
+    std::string grammar_name = grammar_path.substr(grammar_path.find_last_of("/\\") + 1);
+    out << "// Generated by minicompiler_parsergen from " << grammar_name << ". Do not edit.\n"
+        << "// Symbols are encoded as in grammar.h: terminal ids, or non-terminal\n"
+        << "// indices with symbol::NONTERMINAL_FLAG set.\n\n"
+        << "#include \"generated_parser.h\"\n\n"
+        << "bool GeneratedParser::parse() {\n"
+        << "    if (!begin()) {\n"
+        << "        return false;\n"
+        << "    }\n\n"
+        << "    std::vector<Symbol> stack;\n"
+        << "    stack.reserve(64);\n"
+        << "    stack.push_back(" << terminal::END_OF_FILE << ");  // $\n"
+        << "    stack.push_back(" << (symbol::NONTERMINAL_FLAG | static_cast<Symbol>(NonTerminal::PROGRAM))
+        << ");  // " << sets.nameOf(NonTerminal::PROGRAM) << "\n\n"
+        << "    while (!stack.empty()) {\n"
+        << "        Symbol top = stack.back();\n"
+        << "        stack.pop_back();\n"
+        << "        if (top == " << terminal::END_OF_FILE << ") {\n"
+        << "            return finish();\n"
+        << "        }\n"
+        << "        if (!symbol::isNonTerminal(top)) {\n"
+        << "            if (!match(top) && !recover(stack, top)) {\n"
+        << "                return false;\n"
+        << "            }\n"
+        << "            continue;\n"
+        << "        }\n\n"
+        << "        switch (symbol::nonTerminalIndex(top)) {\n";
+    for (size_t nt = 0; nt < grammar.getNonTerminalCount(); nt++) {
+        if (!emitNonTerminal(out, nt)) {
+            return false;
+        }
+    }
+    out << "        default:\n"
+        << "            return false;\n"
+        << "        }\n"
+        << "    }\n"
+        << "    return finish();\n"
+        << "}\n";
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " GRAMMAR OUTPUT" << std::endl;
+        return 1;
+    }
+
+    ErrorReporter reporter;
+    reporter.init(argv[1]);
+    std::unique_ptr<LL1Grammar> grammar = LL1Grammar::load(argv[1], reporter, false);
+    reporter.flush();
+    if (!grammar) {
+        return 1;
+    }
+
+    // Write to a string first so a failed run leaves no partial output
+    std::ostringstream code;
+    Generator generator(*grammar);
+    if (!generator.emit(code, argv[1])) {
+        return 1;
+    }
+    std::ofstream out(argv[2]);
+    out << code.str();
+    if (!out) {
+        std::cerr << "error: cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    return 0;
+}
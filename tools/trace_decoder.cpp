@@ -0,0 +1,66 @@
+// Decodes a parse trace written with minicompiler --trace-file into the text
+// --show-parse-steps prints. Non-terminals and productions are named when the
+// trace was taken with the built-in grammar; lexemes are shown when the
+// traced source file is given, and terminal spellings otherwise.
+//
+// Usage: minicompiler_tracedump TRACE [--source=FILE] [--output=FILE]
+
+#include "parse_trace.h"
+#include "error.h"
+#include "lexer.h"
+#include "parser.h"
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+int main(int argc, char* argv[]) {
+    std::string trace_file;
+    std::string source_file;
+    std::string output_file;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--source=", 0) == 0) {
+            source_file = arg.substr(arg.find('=') + 1);
+        } else if (arg.rfind("--output=", 0) == 0) {
+            output_file = arg.substr(arg.find('=') + 1);
+        } else if (trace_file.empty() && arg.rfind("--", 0) != 0) {
+            trace_file = arg;
+        } else {
+            trace_file.clear();
+            break;
+        }
+    }
+    if (trace_file.empty()) {
+        std::cerr << "Usage: " << argv[0] << " TRACE [--source=FILE] [--output=FILE]" << std::endl;
+        return 1;
+    }
+
+    SavedTrace trace;
+    if (!trace.load(trace_file)) {
+        std::cerr << "error: " << trace_file << " is not a parse trace" << std::endl;
+        return 1;
+    }
+
+    // Token indices in the trace refer to the stream the parser saw, so the
+    // source is lexed again the same way
+    std::unique_ptr<TokenStream> tokens;
+    if (!source_file.empty()) {
+        ErrorReporter reporter;
+        Lexer lexer(source_file, reporter);
+        tokens = std::make_unique<TokenStream>(lexer.tokenize());
+        reporter.flush();
+    }
+
+    TraceDecoder decoder(trace.builtin_grammar ? &FirstFollowSets::builtin() : nullptr, tokens.get());
+    if (output_file.empty()) {
+        decoder.print(trace.records, trace.dropped, std::cout);
+        return 0;
+    }
+    std::ofstream out(output_file);
+    decoder.print(trace.records, trace.dropped, out);
+    if (!out) {
+        std::cerr << "error: cannot write " << output_file << std::endl;
+        return 1;
+    }
+    return 0;
+}